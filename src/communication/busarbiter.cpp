@@ -0,0 +1,534 @@
+#include "busarbiter.h"
+#include "nativemodbusconnection.h"
+#include "scopelogging.h"
+
+/*!
+ * Constructor for BusChannel
+ * Use \ref BusArbiter::createChannel to create a channel
+ * \param pArbiter  Arbiter of the bus
+ * \param parent    Parent object
+ */
+BusChannel::BusChannel(BusArbiter* pArbiter, QObject *parent) : ModbusConnection(parent), _pArbiter(pArbiter)
+{
+
+}
+
+BusChannel::~BusChannel()
+{
+    if (_pArbiter)
+    {
+        _pArbiter->removeChannel(this);
+    }
+}
+
+/*!
+ * Start opening of TCP connection
+ * The connection of the bus is shared, when it is already open it is used immediately
+ */
+void BusChannel::openTcpConnection(struct TcpSettings tcpSettings, quint32 timeout)
+{
+    if (_pArbiter)
+    {
+        _pArbiter->openChannel(this, tcpSettings, timeout);
+    }
+    else
+    {
+        emit connectionError(QModbusDevice::ConnectionError, QString("Bus is removed"));
+    }
+}
+
+/*!
+ * Start opening of serial connection
+ * The connection of the bus is shared, when it is already open it is used immediately
+ */
+void BusChannel::openSerialConnection(struct SerialSettings serialSettings, quint32 timeout)
+{
+    if (_pArbiter)
+    {
+        _pArbiter->openChannel(this, serialSettings, timeout);
+    }
+    else
+    {
+        emit connectionError(QModbusDevice::ConnectionError, QString("Bus is removed"));
+    }
+}
+
+/*!
+ * Start opening of UDP connection
+ * The connection of the bus is shared, when it is already open it is used immediately
+ */
+void BusChannel::openUdpConnection(struct TcpSettings udpSettings, quint32 timeout)
+{
+    if (_pArbiter)
+    {
+        _pArbiter->openUdpChannel(this, udpSettings, timeout);
+    }
+    else
+    {
+        emit connectionError(QModbusDevice::ConnectionError, QString("Bus is removed"));
+    }
+}
+
+void BusChannel::closeConnection(void)
+{
+    if (_pArbiter)
+    {
+        _pArbiter->releaseChannel(this, 0);
+    }
+}
+
+/*!
+ * Release channel, the connection of the bus lingers when no other channel uses it
+ */
+void BusChannel::lingerConnection(quint32 lingerTime)
+{
+    if (_pArbiter)
+    {
+        _pArbiter->releaseChannel(this, lingerTime);
+    }
+}
+
+void BusChannel::sendReadRequest(ModbusAddress regAddress, quint16 size, int serverAddress, quint32 requestId)
+{
+    if (_pArbiter)
+    {
+        _pArbiter->queueRequest(this, regAddress, size, serverAddress, requestId);
+    }
+    else
+    {
+        emit connectionError(QModbusDevice::ReadError, QString("Not connected"));
+    }
+}
+
+void BusChannel::abortPendingRequests(void)
+{
+    if (_pArbiter)
+    {
+        _pArbiter->abortRequests(this);
+    }
+}
+
+bool BusChannel::isConnected(void)
+{
+    return _pArbiter && _pArbiter->isChannelConnected(this);
+}
+
+/*!
+ * Set request policy of the connection of the bus, the policy of the last channel is used
+ */
+void BusChannel::setRequestPolicy(bool bAdaptiveTimeout, quint8 retries)
+{
+    if (_pArbiter)
+    {
+        _pArbiter->setRequestPolicy(bAdaptiveTimeout, retries);
+    }
+}
+
+/*!
+ * Return round-trip time estimate of the connection of the bus
+ */
+const RttEstimator& BusChannel::rttEstimator() const
+{
+    if (_pArbiter)
+    {
+        return _pArbiter->_pConnection->rttEstimator();
+    }
+
+    return ModbusConnection::rttEstimator();
+}
+
+/*!
+ * Constructor for BusArbiter
+ * The connection settings of the bus are taken from the channel that opens the connection
+ */
+BusArbiter::BusArbiter(QObject *parent) : BusArbiter(false, parent)
+{
+
+}
+
+/*!
+ * Constructor for BusArbiter
+ * \param bNativeEngine    True to use a \ref NativeModbusConnection for the bus
+ * \param parent           Parent object
+ */
+BusArbiter::BusArbiter(bool bNativeEngine, QObject *parent) : QObject(parent), _turnaroundTimer(this)
+{
+    if (bNativeEngine)
+    {
+        _pConnection = new NativeModbusConnection(this);
+    }
+    else
+    {
+        _pConnection = new ModbusConnection(this);
+    }
+
+    _turnaroundTimer.setSingleShot(true);
+    connect(&_turnaroundTimer, &QTimer::timeout, this, &BusArbiter::dispatchRequests);
+
+    connect(_pConnection, &ModbusConnection::connectionSuccess, this, &BusArbiter::handleConnectionSuccess);
+    connect(_pConnection, &ModbusConnection::connectionError, this, &BusArbiter::handleConnectionError);
+    connect(_pConnection, &ModbusConnection::readRequestSuccess, this, &BusArbiter::handleRequestSuccess);
+    connect(_pConnection, &ModbusConnection::readRequestProtocolError, this, &BusArbiter::handleRequestProtocolError);
+    connect(_pConnection, &ModbusConnection::readRequestError, this, &BusArbiter::handleRequestError);
+}
+
+/*!
+ * Create channel for a master on this bus
+ * \param parent    Parent object of channel
+ * \return New channel
+ */
+BusChannel* BusArbiter::createChannel(QObject* parent)
+{
+    return new BusChannel(this, parent);
+}
+
+/*!
+ * Set turnaround delay
+ * Some devices need time to release the bus after their response. The bus is kept silent for
+ * the turnaround delay before a request to another slave id is sent. Requests to the same slave id
+ * are sent first, so the delay is only added when the bus switches between slave ids.
+ * \param turnaroundDelay   Turnaround delay (in ms), 0 to disable
+ */
+void BusArbiter::setTurnaroundDelay(quint32 turnaroundDelay)
+{
+    _turnaroundDelay = turnaroundDelay;
+}
+
+quint32 BusArbiter::turnaroundDelay() const
+{
+    return _turnaroundDelay;
+}
+
+/*!
+ * Set maximum number of requests that are handed to the client at the same time
+ * A TCP client sends all requests immediately, so the limit is the number of outstanding requests that
+ * the gateway handles. A serial bus is strictly sequential: with a limit of one the arbiter decides the
+ * order of all requests, instead of the queue of the client.
+ * \param maxSentCount      Maximum number of outstanding requests, 0 for no limit
+ */
+void BusArbiter::setMaxSentCount(quint32 maxSentCount)
+{
+    _maxSentCount = maxSentCount;
+}
+
+quint32 BusArbiter::maxSentCount() const
+{
+    return _maxSentCount;
+}
+
+/*!
+ * Set maximum number of requests in a row to the same slave id when a turnaround delay is used
+ * Requests to the last slave id avoid a turnaround delay, but a master that keeps its request window
+ * filled would hold the bus for its whole read. After this number of requests, the oldest request to
+ * another slave id is sent first.
+ * \param maxBurstCount     Maximum number of requests in a row (at least 1)
+ */
+void BusArbiter::setMaxBurstCount(quint32 maxBurstCount)
+{
+    _maxBurstCount = qMax(maxBurstCount, static_cast<quint32>(1));
+}
+
+quint32 BusArbiter::maxBurstCount() const
+{
+    return _maxBurstCount;
+}
+
+/*!
+ * Return number of requests that wait for the bus
+ * \return Number of requests that aren't handed to the client yet
+ */
+qsizetype BusArbiter::queuedRequestCount() const
+{
+    return _queuedRequests.size();
+}
+
+/*!
+ * Return number of requests that are handed to the client
+ * \return Number of requests that wait for a reply
+ */
+qsizetype BusArbiter::sentRequestCount() const
+{
+    return _sentRequests.size();
+}
+
+void BusArbiter::handleConnectionSuccess()
+{
+    _bOpening = false;
+
+    const QList<BusChannel*> openedChannels = _openingChannels;
+    _openingChannels.clear();
+    _connectedChannels.append(openedChannels);
+
+    for (BusChannel* pChannel : openedChannels)
+    {
+        emit pChannel->connectionSuccess();
+    }
+
+    dispatchRequests();
+}
+
+void BusArbiter::handleConnectionError(QModbusDevice::Error error, QString msg)
+{
+    _bOpening = false;
+
+    /* All channels share the connection, so all of them lose it */
+    const QList<BusChannel*> channels = _openingChannels + _connectedChannels;
+    _openingChannels.clear();
+    _connectedChannels.clear();
+
+    _queuedRequests.clear();
+    _sentRequests.clear();
+    _turnaroundTimer.stop();
+    _lastServerAddress = -1;
+
+    for (BusChannel* pChannel : channels)
+    {
+        emit pChannel->connectionError(error, msg);
+    }
+}
+
+void BusArbiter::handleRequestSuccess(ModbusAddress startRegister, QList<quint16> registerDataList, qint64 timestamp, int serverAddress, quint32 requestId)
+{
+    const BusRequest request = takeSentRequest(requestId);
+    if (request.pChannel != nullptr)
+    {
+        emit request.pChannel->readRequestSuccess(startRegister, registerDataList, timestamp, serverAddress, request.channelRequestId);
+    }
+
+    dispatchRequests();
+}
+
+void BusArbiter::handleRequestProtocolError(ModbusAddress startRegister, QModbusPdu::ExceptionCode exceptionCode, qint64 timestamp, int serverAddress, quint32 requestId)
+{
+    const BusRequest request = takeSentRequest(requestId);
+    if (request.pChannel != nullptr)
+    {
+        emit request.pChannel->readRequestProtocolError(startRegister, exceptionCode, timestamp, serverAddress, request.channelRequestId);
+    }
+
+    dispatchRequests();
+}
+
+void BusArbiter::handleRequestError(ModbusAddress startRegister, QString errorString, QModbusDevice::Error error, qint64 timestamp, int serverAddress, quint32 requestId)
+{
+    const BusRequest request = takeSentRequest(requestId);
+    if (request.pChannel != nullptr)
+    {
+        emit request.pChannel->readRequestError(startRegister, errorString, error, timestamp, serverAddress, request.channelRequestId);
+    }
+
+    dispatchRequests();
+}
+
+/*!
+ * Hand queued requests to the client
+ * The requests of all channels are interleaved in a single stream, up to the maximum sent count, so the
+ * bus isn't idle between the requests of different masters. Only a switch to another slave id with a
+ * turnaround delay waits until the bus is idle.
+ */
+void BusArbiter::dispatchRequests()
+{
+    while (
+        !_queuedRequests.isEmpty()
+        && ((_maxSentCount == 0) || (_sentRequests.size() < _maxSentCount))
+        && !_turnaroundTimer.isActive()
+        && _pConnection->isConnected()
+    )
+    {
+        const qsizetype idx = nextRequestIndex();
+        const int serverAddress = _queuedRequests[idx].serverAddress;
+
+        if (
+            (_turnaroundDelay != 0)
+            && (_lastServerAddress >= 0)
+            && (serverAddress != _lastServerAddress)
+        )
+        {
+            if (_sentRequests.isEmpty())
+            {
+                _lastServerAddress = serverAddress;
+                _burstCount = 0;
+                _turnaroundTimer.start(static_cast<int>(_turnaroundDelay));
+            }
+
+            /* Continue when bus is idle or turnaround delay has expired */
+            return;
+        }
+
+        const BusRequest request = _queuedRequests.takeAt(idx);
+
+        _burstCount = (request.serverAddress == _lastServerAddress) ? _burstCount + 1 : 1;
+        _lastServerAddress = request.serverAddress;
+        _sentRequests.append(request);
+
+        /* Can report an error immediately, so all state is updated before sending */
+        _pConnection->sendReadRequest(request.address, request.size, request.serverAddress, request.requestId);
+    }
+}
+
+void BusArbiter::openChannel(BusChannel* pChannel, struct ModbusConnection::TcpSettings tcpSettings, quint32 timeout)
+{
+    if (prepareChannelOpen(pChannel))
+    {
+        /* Reuses the connection when it is already open (or lingering) */
+        _pConnection->openTcpConnection(tcpSettings, timeout);
+    }
+}
+
+void BusArbiter::openChannel(BusChannel* pChannel, struct ModbusConnection::SerialSettings serialSettings, quint32 timeout)
+{
+    if (prepareChannelOpen(pChannel))
+    {
+        /* Reuses the connection when it is already open (or lingering) */
+        _pConnection->openSerialConnection(serialSettings, timeout);
+    }
+}
+
+void BusArbiter::openUdpChannel(BusChannel* pChannel, struct ModbusConnection::TcpSettings udpSettings, quint32 timeout)
+{
+    if (prepareChannelOpen(pChannel))
+    {
+        /* Reuses the connection when it is already open (or lingering) */
+        _pConnection->openUdpConnection(udpSettings, timeout);
+    }
+}
+
+/*!
+ * Prepare open of a channel
+ * \return True when the connection of the bus needs to be opened
+ */
+bool BusArbiter::prepareChannelOpen(BusChannel* pChannel)
+{
+    if (_connectedChannels.contains(pChannel) && _pConnection->isConnected())
+    {
+        emit pChannel->connectionSuccess();
+        return false;
+    }
+
+    _connectedChannels.removeAll(pChannel);
+    if (!_openingChannels.contains(pChannel))
+    {
+        _openingChannels.append(pChannel);
+    }
+
+    /* Channels that open during an open wait for the same connection */
+    if (_bOpening)
+    {
+        return false;
+    }
+
+    _bOpening = true;
+
+    return true;
+}
+
+void BusArbiter::releaseChannel(BusChannel* pChannel, quint32 lingerTime)
+{
+    abortRequests(pChannel);
+
+    _openingChannels.removeAll(pChannel);
+    _connectedChannels.removeAll(pChannel);
+
+    if (_openingChannels.isEmpty() && _connectedChannels.isEmpty())
+    {
+        qCDebug(scopeCommConnection) << "Bus idle";
+
+        /* Requests that are still on the bus have no channel anymore. Drop them in the client as well, a client
+         * that is closed doesn't report them and they would keep a slot of the maximum sent count forever */
+        _queuedRequests.clear();
+        _sentRequests.clear();
+        _pConnection->abortPendingRequests();
+
+        _bOpening = false;
+        _turnaroundTimer.stop();
+        _lastServerAddress = -1;
+        _burstCount = 0;
+
+        _pConnection->lingerConnection(lingerTime);
+    }
+}
+
+void BusArbiter::removeChannel(BusChannel* pChannel)
+{
+    releaseChannel(pChannel, 0);
+}
+
+void BusArbiter::queueRequest(BusChannel* pChannel, ModbusAddress regAddress, quint16 size, int serverAddress, quint32 channelRequestId)
+{
+    if (!isChannelConnected(pChannel))
+    {
+        emit pChannel->connectionError(QModbusDevice::ReadError, QString("Not connected"));
+        return;
+    }
+
+    _queuedRequests.append({pChannel, regAddress, size, serverAddress, channelRequestId, _nextRequestId++});
+
+    dispatchRequests();
+}
+
+/*!
+ * Forget the requests of a channel
+ * Requests that are already handed to the client stay on the bus, their replies are dropped
+ */
+void BusArbiter::abortRequests(BusChannel* pChannel)
+{
+    _queuedRequests.removeIf([pChannel](const BusRequest& request) { return request.pChannel == pChannel; });
+
+    for (BusRequest& request : _sentRequests)
+    {
+        if (request.pChannel == pChannel)
+        {
+            request.pChannel = nullptr;
+        }
+    }
+}
+
+bool BusArbiter::isChannelConnected(BusChannel* pChannel)
+{
+    return _connectedChannels.contains(pChannel) && _pConnection->isConnected();
+}
+
+void BusArbiter::setRequestPolicy(bool bAdaptiveTimeout, quint8 retries)
+{
+    _pConnection->setRequestPolicy(bAdaptiveTimeout, retries);
+}
+
+qsizetype BusArbiter::nextRequestIndex() const
+{
+    if (_turnaroundDelay != 0)
+    {
+        /* Prefer request to the current slave id, so the bus doesn't need to turn around. After a burst,
+         * the oldest request to another slave id goes first, so a busy master can't hold the bus */
+        const bool bSameSlave = _burstCount < _maxBurstCount;
+
+        for (qsizetype idx = 0; idx < _queuedRequests.size(); idx++)
+        {
+            if ((_queuedRequests[idx].serverAddress == _lastServerAddress) == bSameSlave)
+            {
+                return idx;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*!
+ * Take sent request of a reply
+ * Replies are matched on the identity of the request, so replies with the same slave id and start address
+ * (or replies that arrive out of order) reach the channel of their own request.
+ * \param requestId     Identity of the request on the bus
+ * \return Sent request, its channel is nullptr when the request is aborted or unknown
+ */
+BusArbiter::BusRequest BusArbiter::takeSentRequest(quint32 requestId)
+{
+    for (qsizetype idx = 0; idx < _sentRequests.size(); idx++)
+    {
+        if (_sentRequests[idx].requestId == requestId)
+        {
+            return _sentRequests.takeAt(idx);
+        }
+    }
+
+    return BusRequest();
+}
@@ -0,0 +1,135 @@
+#ifndef BUSARBITER_H
+#define BUSARBITER_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QTimer>
+
+#include "modbusconnection.h"
+
+/* Forward declaration */
+class BusArbiter;
+
+/*!
+ * Connection of a single master on a shared bus
+ * Behaves as a normal \ref ModbusConnection, but all calls are handled by the arbiter of the bus
+ */
+class BusChannel : public ModbusConnection
+{
+    Q_OBJECT
+public:
+    explicit BusChannel(BusArbiter* pArbiter, QObject *parent = nullptr);
+    ~BusChannel();
+
+    void openTcpConnection(struct TcpSettings tcpSettings, quint32 timeout) override;
+    void openSerialConnection(struct SerialSettings serialSettings, quint32 timeout) override;
+    void openUdpConnection(struct TcpSettings udpSettings, quint32 timeout) override;
+    void closeConnection(void) override;
+    void lingerConnection(quint32 lingerTime) override;
+
+    void sendReadRequest(ModbusAddress regAddress, quint16 size, int serverAddress, quint32 requestId = 0) override;
+    void abortPendingRequests(void) override;
+
+    bool isConnected(void) override;
+
+    void setRequestPolicy(bool bAdaptiveTimeout, quint8 retries) override;
+
+    const RttEstimator& rttEstimator() const override;
+
+private:
+    QPointer<BusArbiter> _pArbiter;
+};
+
+/*!
+ * Arbiter of a bus that is shared by multiple masters (slave ids), such as a serial RS-485 bus or a TCP gateway
+ * Owns the single client of the bus and interleaves the requests of all masters in one request stream
+ */
+class BusArbiter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit BusArbiter(QObject *parent = nullptr);
+    explicit BusArbiter(bool bNativeEngine, QObject *parent = nullptr);
+
+    BusChannel* createChannel(QObject* parent);
+
+    void setTurnaroundDelay(quint32 turnaroundDelay);
+    quint32 turnaroundDelay() const;
+
+    void setMaxSentCount(quint32 maxSentCount);
+    quint32 maxSentCount() const;
+
+    void setMaxBurstCount(quint32 maxBurstCount);
+    quint32 maxBurstCount() const;
+
+    qsizetype queuedRequestCount() const;
+    qsizetype sentRequestCount() const;
+
+private slots:
+    void handleConnectionSuccess();
+    void handleConnectionError(QModbusDevice::Error error, QString msg);
+
+    void handleRequestSuccess(ModbusAddress startRegister, QList<quint16> registerDataList, qint64 timestamp, int serverAddress, quint32 requestId);
+    void handleRequestProtocolError(ModbusAddress startRegister, QModbusPdu::ExceptionCode exceptionCode, qint64 timestamp, int serverAddress, quint32 requestId);
+    void handleRequestError(ModbusAddress startRegister, QString errorString, QModbusDevice::Error error, qint64 timestamp, int serverAddress, quint32 requestId);
+
+    void dispatchRequests();
+
+private:
+    friend class BusChannel;
+
+    struct BusRequest
+    {
+        /* nullptr when channel aborted its requests, the reply is dropped */
+        BusChannel* pChannel{nullptr};
+        ModbusAddress address{};
+        quint16 size{};
+        int serverAddress{};
+
+        /* Identity of the request of the channel, and of the request on the bus (unique per arbiter) */
+        quint32 channelRequestId{};
+        quint32 requestId{};
+    };
+
+    void openChannel(BusChannel* pChannel, struct ModbusConnection::TcpSettings tcpSettings, quint32 timeout);
+    void openChannel(BusChannel* pChannel, struct ModbusConnection::SerialSettings serialSettings, quint32 timeout);
+    void openUdpChannel(BusChannel* pChannel, struct ModbusConnection::TcpSettings udpSettings, quint32 timeout);
+    bool prepareChannelOpen(BusChannel* pChannel);
+    void releaseChannel(BusChannel* pChannel, quint32 lingerTime);
+    void removeChannel(BusChannel* pChannel);
+    void queueRequest(BusChannel* pChannel, ModbusAddress regAddress, quint16 size, int serverAddress, quint32 channelRequestId);
+    void abortRequests(BusChannel* pChannel);
+    bool isChannelConnected(BusChannel* pChannel);
+    void setRequestPolicy(bool bAdaptiveTimeout, quint8 retries);
+
+    qsizetype nextRequestIndex() const;
+    BusRequest takeSentRequest(quint32 requestId);
+
+    /* Single connection of the bus */
+    ModbusConnection* _pConnection;
+
+    /* Channels that wait for the connection to open and channels that use the open connection */
+    QList<BusChannel*> _openingChannels;
+    QList<BusChannel*> _connectedChannels;
+    bool _bOpening{false};
+
+    /* Requests that wait for the bus and requests that are handed to the client */
+    QList<BusRequest> _queuedRequests;
+    QList<BusRequest> _sentRequests;
+    quint32 _nextRequestId{};
+
+    /* Maximum number of requests that are handed to the client at the same time, 0 for no limit */
+    quint32 _maxSentCount{0};
+
+    /* Silence before a request to another slave id (in ms) */
+    quint32 _turnaroundDelay{0};
+    int _lastServerAddress{-1};
+
+    /* Requests in a row to the last slave id, limited so other slave ids on the bus get their turn */
+    quint32 _burstCount{0};
+    quint32 _maxBurstCount{1};
+    QTimer _turnaroundTimer;
+};
+
+#endif // BUSARBITER_H
@@ -0,0 +1,114 @@
+#include "circuitbreaker.h"
+
+/*!
+ * Constructor for CircuitBreaker
+ * Keeps track of the health of a single connection. After \ref cFailureThreshold consecutive failed reads,
+ * the breaker trips and reads are skipped for a back-off time. When the back-off has passed, a single probe
+ * read is allowed: success closes the breaker, failure trips it again with a doubled back-off.
+ * All moments are on a monotonic clock (in ns).
+ */
+CircuitBreaker::CircuitBreaker()
+{
+
+}
+
+/*!
+ * Close breaker and forget all failures
+ */
+void CircuitBreaker::reset()
+{
+    _state = State::CLOSED;
+    _consecutiveFailures = 0;
+    _backOff = cMinBackOff;
+    _retryTime = 0;
+}
+
+/*!
+ * Check whether the connection can be read
+ * When the back-off of a tripped breaker has passed, the breaker becomes half-open and the read is the probe.
+ * \param now   Current moment (in ns)
+ * \return True when the connection should be read
+ */
+bool CircuitBreaker::allowRead(qint64 now)
+{
+    if (_state == State::CLOSED)
+    {
+        return true;
+    }
+    else if ((_state == State::OPEN) && (now >= _retryTime))
+    {
+        _state = State::HALF_OPEN;
+        return true;
+    }
+    else
+    {
+        /* Still backing off, or probe is in progress */
+        return false;
+    }
+}
+
+/*!
+ * Register a successful read
+ */
+void CircuitBreaker::recordSuccess()
+{
+    reset();
+}
+
+/*!
+ * Register a failed read (connection error or request without response)
+ * \param now   Moment of the failure (in ns)
+ */
+void CircuitBreaker::recordFailure(qint64 now)
+{
+    _consecutiveFailures++;
+
+    if (_state == State::HALF_OPEN)
+    {
+        /* Probe failed: back off longer */
+        _backOff = qMin(_backOff * 2, cMaxBackOff);
+        trip(now);
+    }
+    else if ((_state == State::CLOSED) && (_consecutiveFailures >= cFailureThreshold))
+    {
+        trip(now);
+    }
+    else
+    {
+        /* Keep state */
+    }
+}
+
+CircuitBreaker::State CircuitBreaker::state() const
+{
+    return _state;
+}
+
+/*!
+ * Return whether the breaker is open or half-open
+ */
+bool CircuitBreaker::isTripped() const
+{
+    return _state != State::CLOSED;
+}
+
+quint32 CircuitBreaker::consecutiveFailures() const
+{
+    return _consecutiveFailures;
+}
+
+qint64 CircuitBreaker::backOff() const
+{
+    return _backOff;
+}
+
+qint64 CircuitBreaker::retryTime() const
+{
+    return _retryTime;
+}
+
+void CircuitBreaker::trip(qint64 now)
+{
+    _state = State::OPEN;
+    _retryTime = now + _backOff;
+}
@@ -0,0 +1,49 @@
+#ifndef CIRCUITBREAKER_H
+#define CIRCUITBREAKER_H
+
+#include <QtGlobal>
+
+class CircuitBreaker
+{
+public:
+
+    enum class State
+    {
+        CLOSED,    /* Connection is read normally */
+        OPEN,      /* Connection is tripped, reads are skipped until the back-off has passed */
+        HALF_OPEN, /* Back-off has passed, a single probe read is done */
+    };
+
+    CircuitBreaker();
+
+    void reset();
+
+    bool allowRead(qint64 now);
+    void recordSuccess();
+    void recordFailure(qint64 now);
+
+    State state() const;
+    bool isTripped() const;
+    quint32 consecutiveFailures() const;
+    qint64 backOff() const;
+    qint64 retryTime() const;
+
+    /* Number of consecutive failed reads that trips the breaker */
+    static constexpr quint32 cFailureThreshold = 3;
+
+    /* Back-off after tripping, doubled for every failed probe up to the maximum (in ns) */
+    static constexpr qint64 cMinBackOff = 1000LL * 1000 * 1000;
+    static constexpr qint64 cMaxBackOff = 60LL * 1000 * 1000 * 1000;
+
+private:
+    void trip(qint64 now);
+
+    State _state{State::CLOSED};
+    quint32 _consecutiveFailures{};
+    qint64 _backOff{cMinBackOff};
+
+    /* Moment from which a probe read is allowed (in ns) */
+    qint64 _retryTime{};
+};
+
+#endif // CIRCUITBREAKER_H
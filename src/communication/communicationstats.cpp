@@ -1,6 +1,7 @@
 #include "communicationstats.h"
 
 #include "graphdatamodel.h"
+#include "acquisitionclock.h"
 #include <algorithm>
 
 const uint32_t CommunicationStats::_cUpdateTime = 500;
@@ -49,8 +50,12 @@ void CommunicationStats::updateTimingInfo()
 void CommunicationStats::resetTiming()
 {
     _pGraphDataModel->setCommunicationStats(0, 0);
-    _pGraphDataModel->setCommunicationStartTime(QDateTime::currentMSecsSinceEpoch());
+    _pGraphDataModel->setCommunicationStartTime(AcquisitionClock::currentMSecsSinceEpoch());
     _pGraphDataModel->setMedianPollTime(0);
+    _pGraphDataModel->setPollTiming(0, 0);
+    _pGraphDataModel->setTrippedConnections(QList<quint8>());
+    _pollStatistics.clear();
+    _trippedConnections.clear();
 
     emit triggerRunTimeUpdate();
 }
@@ -65,7 +70,7 @@ void CommunicationStats::start()
 
 void CommunicationStats::stop()
 {
-    _pGraphDataModel->setCommunicationEndTime(QDateTime::currentMSecsSinceEpoch());
+    _pGraphDataModel->setCommunicationEndTime(AcquisitionClock::currentMSecsSinceEpoch());
     _bRunning = false;
 }
 
@@ -84,14 +89,66 @@ void CommunicationStats::updateRuntime()
     }
 }
 
-void CommunicationStats::updateCommunicationStats(ResultDoubleList resultList)
+void CommunicationStats::updateCommunicationStats(SampleFrame resultList)
 {
     quint32 error = 0;
     quint32 success = 0;
     for(const auto &result: resultList)
     {
+        if (result.state() == ResultState::State::NO_VALUE)
+        {
+            /* Not polled */
+            continue;
+        }
+
         result.isValid() ? success++ : error++;
     }
 
     incrementCommunicationStats(success, error);
 }
+
+/*!
+ * Update statistics of the poll schedule of a connection
+ * The missed deadlines of all connections are summed, the achieved period is the one of the slowest connection.
+ * \param connectionId      Connection id
+ * \param missedDeadlines   Number of missed poll deadlines of the connection
+ * \param achievedPeriod    Achieved poll period of the connection (in ns)
+ */
+void CommunicationStats::updatePollStatistics(quint8 connectionId, quint32 missedDeadlines, qint64 achievedPeriod)
+{
+    _pollStatistics.insert(connectionId, qMakePair(missedDeadlines, achievedPeriod));
+
+    quint32 missedCount = 0;
+    qint64 period = 0;
+    for (const auto &statistics : std::as_const(_pollStatistics))
+    {
+        missedCount += statistics.first;
+        period = qMax(period, statistics.second);
+    }
+
+    _pGraphDataModel->setPollTiming(missedCount, static_cast<double>(period) / 1000000);
+}
+
+/*!
+ * Update circuit breaker state of a connection
+ * \param connectionId      Connection id
+ * \param bTripped          True when the connection is tripped (reads are skipped)
+ */
+void CommunicationStats::updateConnectionTripped(quint8 connectionId, bool bTripped)
+{
+    if (bTripped)
+    {
+        _trippedConnections.insert(connectionId);
+    }
+    else
+    {
+        _trippedConnections.remove(connectionId);
+    }
+
+    QList<quint8> connectionList = _trippedConnections.values();
+    std::sort(connectionList.begin(), connectionList.end());
+
+    _pGraphDataModel->setTrippedConnections(connectionList);
+
+    emit triggerRunTimeUpdate();
+}
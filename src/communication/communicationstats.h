@@ -3,7 +3,9 @@
 
 #include <QObject>
 #include <QTimer>
-#include "result.h"
+#include <QMap>
+#include <QSet>
+#include "sampleframe.h"
 
 class GraphDataModel;
 
@@ -24,7 +26,9 @@ signals:
 
 public slots:
     void updateTimingInfo();
-    void updateCommunicationStats(ResultDoubleList resultList);
+    void updateCommunicationStats(SampleFrame resultList);
+    void updatePollStatistics(quint8 connectionId, quint32 missedDeadlines, qint64 achievedPeriod);
+    void updateConnectionTripped(quint8 connectionId, bool bTripped);
 
 private slots:
     void updateRuntime();
@@ -38,6 +42,12 @@ private:
 
     quint32 _sampleCalculationSize = 50;
 
+    /* Poll schedule statistics per connection: missed deadlines and achieved period (in ns) */
+    QMap<quint8, QPair<quint32, qint64> > _pollStatistics;
+
+    /* Connections of which the circuit breaker is tripped */
+    QSet<quint8> _trippedConnections;
+
     static const uint32_t _cUpdateTime;
 };
 
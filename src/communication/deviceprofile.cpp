@@ -0,0 +1,362 @@
+#include "deviceprofile.h"
+
+#include <limits>
+
+const QString DeviceProfile::_cMaxBlockSizeKey = QString("maxBlockSize");
+const QString DeviceProfile::_cMaxBitBlockSizeKey = QString("maxBitBlockSize");
+const QString DeviceProfile::_cUnreadableKey = QString("unreadable");
+const QString DeviceProfile::_cUnsupportedKey = QString("unsupported");
+
+using ObjectType = ModbusAddress::ObjectType;
+
+DeviceProfile::DeviceProfile()
+{
+
+}
+
+/*!
+ * Construct profile key of a device behind a TCP connection
+ * \param ip        IP address
+ * \param port      Port
+ * \param slaveId   Slave id
+ * \return Profile key
+ */
+QString DeviceProfile::tcpKey(QString ip, quint16 port, quint8 slaveId)
+{
+    return QString("tcp:%1:%2:%3").arg(ip).arg(port).arg(slaveId);
+}
+
+/*!
+ * Construct profile key of a device behind a UDP connection
+ * A UDP endpoint can be a different device than a TCP endpoint on the same address and port
+ * \param ip        IP address
+ * \param port      Port
+ * \param slaveId   Slave id
+ * \return Profile key
+ */
+QString DeviceProfile::udpKey(QString ip, quint16 port, quint8 slaveId)
+{
+    return QString("udp:%1:%2:%3").arg(ip).arg(port).arg(slaveId);
+}
+
+/*!
+ * Construct profile key of a device behind a serial connection
+ * \param portName  Serial port name
+ * \param slaveId   Slave id
+ * \return Profile key
+ */
+QString DeviceProfile::serialKey(QString portName, quint8 slaveId)
+{
+    return QString("serial:%1:%2").arg(portName).arg(slaveId);
+}
+
+/*!
+ * Return learned maximum number of registers in a single read
+ * \return Maximum block size (0 when unknown)
+ */
+quint16 DeviceProfile::maxBlockSize() const
+{
+    return _maxBlockSize;
+}
+
+/*!
+ * Limit maximum number of registers in a single read
+ * \param count     Number of registers that is known to be readable at once
+ */
+void DeviceProfile::limitBlockSize(quint16 count)
+{
+    if (
+        (count > 0)
+        && ((_maxBlockSize == 0) || (count < _maxBlockSize))
+    )
+    {
+        _maxBlockSize = count;
+        _successfulPollCount = 0;
+        _revision++;
+    }
+}
+
+/*!
+ * Return learned maximum number of coils or discrete inputs in a single read
+ * \return Maximum block size (0 when unknown)
+ */
+quint16 DeviceProfile::maxBitBlockSize() const
+{
+    return _maxBitBlockSize;
+}
+
+/*!
+ * Limit maximum number of coils or discrete inputs in a single read
+ * \param count     Number of bits that is known to be readable at once
+ */
+void DeviceProfile::limitBitBlockSize(quint16 count)
+{
+    if (
+        (count > 0)
+        && ((_maxBitBlockSize == 0) || (count < _maxBitBlockSize))
+    )
+    {
+        _maxBitBlockSize = count;
+        _successfulPollCount = 0;
+        _revision++;
+    }
+}
+
+/*!
+ * Count successful poll of the device
+ * A learned block size can be caused by a transient failure, or the device can be updated. After
+ * \ref cBlockSizeProbeInterval successful polls the learned block sizes are dropped, so the next read
+ * probes the full block again. When the device still can't read it, the block size is learned again.
+ */
+void DeviceProfile::addSuccessfulPoll()
+{
+    if ((_maxBlockSize == 0) && (_maxBitBlockSize == 0))
+    {
+        return;
+    }
+
+    _successfulPollCount++;
+    if (_successfulPollCount >= cBlockSizeProbeInterval)
+    {
+        _maxBlockSize = 0;
+        _maxBitBlockSize = 0;
+        _successfulPollCount = 0;
+        _revision++;
+    }
+}
+
+/*!
+ * Return list with ranges that contain at least one unreadable register
+ * \return List with unreadable ranges
+ */
+QList<ModbusReadItem> DeviceProfile::unreadableList() const
+{
+    return _unreadableList;
+}
+
+/*!
+ * Add range that contains at least one unreadable register
+ * Only the smallest ranges are kept, because a larger range around it is unreadable anyway
+ * \param range     Unreadable range
+ */
+void DeviceProfile::addUnreadableRange(ModbusReadItem range)
+{
+    for (qint32 idx = _unreadableList.size() - 1; idx >= 0; idx--)
+    {
+        if (isRangeInItem(_unreadableList[idx], range))
+        {
+            return;
+        }
+        else if (isRangeInItem(range, _unreadableList[idx]))
+        {
+            _unreadableList.removeAt(idx);
+        }
+    }
+
+    _unreadableList.append(range);
+    _revision++;
+}
+
+/*!
+ * Remove exact range from unreadable ranges
+ * \param range     Range
+ */
+void DeviceProfile::removeUnreadableRange(ModbusReadItem range)
+{
+    for (qint32 idx = _unreadableList.size() - 1; idx >= 0; idx--)
+    {
+        if (
+            (_unreadableList[idx].address() == range.address())
+            && (_unreadableList[idx].count() == range.count())
+        )
+        {
+            _unreadableList.removeAt(idx);
+            _revision++;
+        }
+    }
+}
+
+/*!
+ * Remove all unreadable ranges that are part of a successful read
+ * \param readItem  Successfully read item
+ */
+void DeviceProfile::removeReadableRanges(ModbusReadItem readItem)
+{
+    for (qint32 idx = _unreadableList.size() - 1; idx >= 0; idx--)
+    {
+        if (isRangeInItem(_unreadableList[idx], readItem))
+        {
+            _unreadableList.removeAt(idx);
+            _revision++;
+        }
+    }
+}
+
+/*!
+ * Return whether a read contains a known unreadable range
+ * \param readItem  Read item
+ * \retval true     Read contains unreadable range
+ * \retval false    Read doesn't contain unreadable range
+ */
+bool DeviceProfile::containsUnreadableRange(ModbusReadItem readItem) const
+{
+    for (const ModbusReadItem& range : std::as_const(_unreadableList))
+    {
+        if (isRangeInItem(range, readItem))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * Return whether reading an object type is supported by device
+ * \param type  Object type
+ * \retval true     Supported (or unknown)
+ * \retval false    Device reported function code as illegal
+ */
+bool DeviceProfile::isSupported(ModbusAddress::ObjectType type) const
+{
+    return !_unsupportedList.contains(type);
+}
+
+/*!
+ * Set whether reading an object type is supported by device
+ * \param type          Object type
+ * \param bSupported    Support state
+ */
+void DeviceProfile::setSupported(ModbusAddress::ObjectType type, bool bSupported)
+{
+    if (bSupported && _unsupportedList.contains(type))
+    {
+        _unsupportedList.removeAll(type);
+        _revision++;
+    }
+    else if (!bSupported && !_unsupportedList.contains(type))
+    {
+        _unsupportedList.append(type);
+        _revision++;
+    }
+}
+
+/*!
+ * Return whether profile has no learned information
+ * \retval true     Profile is empty
+ * \retval false    Profile has learned information
+ */
+bool DeviceProfile::isEmpty() const
+{
+    return (_maxBlockSize == 0) && (_maxBitBlockSize == 0) && _unreadableList.isEmpty() && _unsupportedList.isEmpty();
+}
+
+/*!
+ * Return revision of profile, which changes every time the profile is updated
+ * \return Revision
+ */
+quint32 DeviceProfile::revision() const
+{
+    return _revision;
+}
+
+/*!
+ * Load profile from current group of settings
+ * \param settings  Settings
+ */
+void DeviceProfile::load(QSettings& settings)
+{
+    _maxBlockSize = static_cast<quint16>(settings.value(_cMaxBlockSizeKey, 0).toUInt());
+    _maxBitBlockSize = static_cast<quint16>(settings.value(_cMaxBitBlockSizeKey, 0).toUInt());
+
+    _unreadableList.clear();
+    const QStringList unreadableList = settings.value(_cUnreadableKey).toStringList();
+    for (const QString& rangeStr : unreadableList)
+    {
+        const QStringList fields = rangeStr.split(':');
+        if (fields.size() == 3)
+        {
+            bool bTypeOk;
+            bool bAddressOk;
+            bool bCountOk;
+
+            const quint32 type = fields[0].toUInt(&bTypeOk);
+            const quint32 address = fields[1].toUInt(&bAddressOk);
+            const quint32 count = fields[2].toUInt(&bCountOk);
+
+            if (
+                bTypeOk && bAddressOk && bCountOk
+                && (type < static_cast<quint32>(ObjectType::UNKNOWN))
+                && (address <= std::numeric_limits<quint16>::max())
+                && (count > 0) && (count <= ModbusReadItem::maxCount(static_cast<ObjectType>(type)))
+            )
+            {
+                ModbusAddress startAddress(address, static_cast<ObjectType>(type));
+                _unreadableList.append(ModbusReadItem(startAddress, static_cast<quint16>(count)));
+            }
+        }
+    }
+
+    _unsupportedList.clear();
+    const QStringList unsupportedList = settings.value(_cUnsupportedKey).toStringList();
+    for (const QString& typeStr : unsupportedList)
+    {
+        bool bOk;
+        const quint32 type = typeStr.toUInt(&bOk);
+        if (bOk && (type < static_cast<quint32>(ObjectType::UNKNOWN)))
+        {
+            _unsupportedList.append(static_cast<ObjectType>(type));
+        }
+    }
+
+    _revision++;
+}
+
+/*!
+ * Save profile in current group of settings
+ * \param settings  Settings
+ */
+void DeviceProfile::save(QSettings& settings) const
+{
+    settings.setValue(_cMaxBlockSizeKey, _maxBlockSize);
+    settings.setValue(_cMaxBitBlockSizeKey, _maxBitBlockSize);
+
+    QStringList unreadableList;
+    for (const ModbusReadItem& range : std::as_const(_unreadableList))
+    {
+        unreadableList.append(QString("%1:%2:%3")
+                              .arg(static_cast<quint32>(range.address().objectType()))
+                              .arg(range.address().protocolAddress())
+                              .arg(range.count()));
+    }
+    settings.setValue(_cUnreadableKey, unreadableList);
+
+    QStringList unsupportedList;
+    for (const ObjectType type : std::as_const(_unsupportedList))
+    {
+        unsupportedList.append(QString::number(static_cast<quint32>(type)));
+    }
+    settings.setValue(_cUnsupportedKey, unsupportedList);
+}
+
+/*!
+ * Return whether range is fully contained in ModbusReadItem
+ * \param range     Range
+ * \param readItem  Read item
+ * \retval true     Range is part of read item
+ * \retval false    Range is not part of read item
+ */
+bool DeviceProfile::isRangeInItem(ModbusReadItem range, ModbusReadItem readItem)
+{
+    if (range.address().objectType() != readItem.address().objectType())
+    {
+        return false;
+    }
+
+    const quint32 rangeStart = range.address().protocolAddress();
+    const quint32 rangeEnd = rangeStart + range.count();
+    const quint32 itemStart = readItem.address().protocolAddress();
+    const quint32 itemEnd = itemStart + readItem.count();
+
+    return (rangeStart >= itemStart) && (rangeEnd <= itemEnd);
+}
@@ -0,0 +1,76 @@
+#ifndef DEVICEPROFILE_H
+#define DEVICEPROFILE_H
+
+#include <QList>
+#include <QSettings>
+
+#include "modbusreaditem.h"
+
+/*!
+ * Knowledge about the read capabilities of a single device (endpoint + slave id)
+ * that is learned during communication
+ */
+class DeviceProfile
+{
+public:
+    DeviceProfile();
+
+    static QString tcpKey(QString ip, quint16 port, quint8 slaveId);
+    static QString udpKey(QString ip, quint16 port, quint8 slaveId);
+    static QString serialKey(QString portName, quint8 slaveId);
+
+    quint16 maxBlockSize() const;
+    void limitBlockSize(quint16 count);
+
+    quint16 maxBitBlockSize() const;
+    void limitBitBlockSize(quint16 count);
+
+    void addSuccessfulPoll();
+
+    QList<ModbusReadItem> unreadableList() const;
+    void addUnreadableRange(ModbusReadItem range);
+    void removeUnreadableRange(ModbusReadItem range);
+    void removeReadableRanges(ModbusReadItem readItem);
+    bool containsUnreadableRange(ModbusReadItem readItem) const;
+
+    bool isSupported(ModbusAddress::ObjectType type) const;
+    void setSupported(ModbusAddress::ObjectType type, bool bSupported);
+
+    bool isEmpty() const;
+    quint32 revision() const;
+
+    /* Learned block sizes are dropped after this number of successful polls, so the full block is probed again */
+    static constexpr quint32 cBlockSizeProbeInterval = 1000;
+
+    void load(QSettings& settings);
+    void save(QSettings& settings) const;
+
+    static bool isRangeInItem(ModbusReadItem range, ModbusReadItem readItem);
+
+private:
+
+    /* Largest number of registers that can be read in a single request (0 when unknown) */
+    quint16 _maxBlockSize{0};
+
+    /* Largest number of coils or discrete inputs that can be read in a single request (0 when unknown) */
+    quint16 _maxBitBlockSize{0};
+
+    /* Successful polls since a block size was learned */
+    quint32 _successfulPollCount{0};
+
+    /* Smallest ranges that contain at least one register that can't be read */
+    QList<ModbusReadItem> _unreadableList;
+
+    /* Object types for which the read function code isn't supported */
+    QList<ModbusAddress::ObjectType> _unsupportedList;
+
+    /* Incremented on every change */
+    quint32 _revision{0};
+
+    static const QString _cMaxBlockSizeKey;
+    static const QString _cMaxBitBlockSizeKey;
+    static const QString _cUnreadableKey;
+    static const QString _cUnsupportedKey;
+};
+
+#endif // DEVICEPROFILE_H
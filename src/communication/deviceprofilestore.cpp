@@ -0,0 +1,72 @@
+#include "deviceprofilestore.h"
+
+#include <QUrl>
+
+const QString DeviceProfileStore::_cDeviceProfileSection = QString("deviceProfiles");
+
+/*!
+ * Constructor for DeviceProfileStore
+ * Device profiles are stored in the user configuration. Every access uses its own QSettings
+ * instance, so the store can be used from the communication thread.
+ */
+DeviceProfileStore::DeviceProfileStore()
+{
+
+}
+
+/*!
+ * Load device profile
+ * \param key   Profile key (\ref DeviceProfile::tcpKey, \ref DeviceProfile::udpKey, \ref DeviceProfile::serialKey)
+ * \return Stored profile (empty when no profile is stored)
+ */
+DeviceProfile DeviceProfileStore::load(QString key)
+{
+    DeviceProfile profile;
+    QSettings settings;
+
+    settings.beginGroup(settingsGroup(key));
+    if (!settings.childKeys().isEmpty())
+    {
+        profile.load(settings);
+    }
+    settings.endGroup();
+
+    return profile;
+}
+
+/*!
+ * Save device profile
+ * \param key       Profile key (\ref DeviceProfile::tcpKey, \ref DeviceProfile::udpKey, \ref DeviceProfile::serialKey)
+ * \param profile   Profile
+ */
+void DeviceProfileStore::save(QString key, const DeviceProfile& profile)
+{
+    const QString group = settingsGroup(key);
+    QSettings settings;
+
+    if (profile.isEmpty())
+    {
+        settings.remove(group);
+    }
+    else
+    {
+        settings.beginGroup(group);
+        profile.save(settings);
+        settings.endGroup();
+    }
+}
+
+/*!
+ * Remove all stored device profiles
+ */
+void DeviceProfileStore::clear()
+{
+    QSettings settings;
+    settings.remove(_cDeviceProfileSection);
+}
+
+QString DeviceProfileStore::settingsGroup(QString key)
+{
+    /* Key can contain characters with special meaning (port name with slashes) */
+    return QString("%1/%2").arg(_cDeviceProfileSection, QString::fromLatin1(QUrl::toPercentEncoding(key)));
+}
@@ -0,0 +1,23 @@
+#ifndef DEVICEPROFILESTORE_H
+#define DEVICEPROFILESTORE_H
+
+#include <QSettings>
+
+#include "deviceprofile.h"
+
+class DeviceProfileStore
+{
+public:
+    DeviceProfileStore();
+
+    DeviceProfile load(QString key);
+    void save(QString key, const DeviceProfile& profile);
+    void clear();
+
+private:
+    QString settingsGroup(QString key);
+
+    static const QString _cDeviceProfileSection;
+};
+
+#endif // DEVICEPROFILESTORE_H
@@ -32,6 +32,9 @@ void GraphDataHandler::processActiveRegisters(GraphDataModel* pGraphDataModel)
 
     QStringList processedExpList;
     exprParser.processedExpressions(processedExpList);
+    exprParser.expressionRegisterIndexes(_expressionRegisterIndexes);
+
+    _heldResults = SampleFrame::create(_registerList.size(), 0);
 
     _valueParsers.clear();
 
@@ -46,6 +49,61 @@ void GraphDataHandler::modbusRegisterList(QList<ModbusRegister>& registerList)
     registerList = _registerList;
 }
 
+/*!
+ * Get poll interval of every register
+ * A register that is used in several graphs is polled at the fastest interval of these graphs
+ * \param pollIntervalList     Poll interval (in ms) of every register in \ref modbusRegisterList
+ * \param defaultInterval      Poll interval of graphs without specific poll interval
+ */
+void GraphDataHandler::registerPollIntervals(QList<quint32>& pollIntervalList, quint32 defaultInterval)
+{
+    pollIntervalList.clear();
+    for (qint32 idx = 0; idx < _registerList.size(); idx++)
+    {
+        pollIntervalList.append(0);
+    }
+
+    for (qint32 exprIdx = 0; exprIdx < _expressionRegisterIndexes.size(); exprIdx++)
+    {
+        quint32 interval = _pGraphDataModel->pollInterval(_activeIndexList[exprIdx]);
+        if (interval == 0)
+        {
+            interval = defaultInterval;
+        }
+
+        for (const qint32 regIdx : std::as_const(_expressionRegisterIndexes[exprIdx]))
+        {
+            if ((pollIntervalList[regIdx] == 0) || (interval < pollIntervalList[regIdx]))
+            {
+                pollIntervalList[regIdx] = interval;
+            }
+        }
+    }
+}
+
+/*!
+ * Get demand of every register
+ * A register is demanded when it is used in at least one visible graph
+ * \param demandList       Demand of every register in \ref modbusRegisterList
+ */
+void GraphDataHandler::registerDemand(QList<bool>& demandList)
+{
+    demandList = QList<bool>(_registerList.size(), false);
+
+    for (qint32 exprIdx = 0; exprIdx < _expressionRegisterIndexes.size(); exprIdx++)
+    {
+        if (!_pGraphDataModel->isVisible(_activeIndexList[exprIdx]))
+        {
+            continue;
+        }
+
+        for (const qint32 regIdx : std::as_const(_expressionRegisterIndexes[exprIdx]))
+        {
+            demandList[regIdx] = true;
+        }
+    }
+}
+
 QString GraphDataHandler::expressionParseMsg(qint32 exprIdx) const
 {
     if (exprIdx >= _valueParsers.size())
@@ -76,17 +134,42 @@ QMuParser::ErrorType GraphDataHandler::expressionErrorType(qint32 exprIdx) const
     return _valueParsers[exprIdx].errorType();
 }
 
-void GraphDataHandler::handleRegisterData(ResultDoubleList results)
+/*!
+ * Calculate graph values from register results
+ * Registers without value (not polled in this publication) are held at their last value. A graph
+ * is only calculated when at least one of its registers has a new value.
+ * \param results     Result of every register in \ref modbusRegisterList and moment of acquisition
+ */
+void GraphDataHandler::handleRegisterData(SampleFrame results)
 {
-    ResultDoubleList registerList;
+    if (_heldResults.size() != results.size())
+    {
+        _heldResults = SampleFrame::create(results.size(), results.timestamp());
+    }
+
+    /* Held results are still shared with the parser, so this recycles a frame of the pool instead of copying */
+    for (qint32 regIdx = 0; regIdx < results.size(); regIdx++)
+    {
+        if (results[regIdx].state() != ResultState::State::NO_VALUE)
+        {
+            _heldResults.setResult(regIdx, results[regIdx]);
+        }
+    }
+
+    QMuParser::setRegistersData(_heldResults);
 
-    QMuParser::setRegistersData(results);
+    SampleFrame graphResults = SampleFrame::create(_valueParsers.size(), results.timestamp());
 
     for(qint32 listIdx = 0; listIdx < _valueParsers.size(); listIdx++)
     {
         ResultDouble result;
 
-        if (_valueParsers[listIdx].evaluate())
+        if (!isDue(listIdx, results, _heldResults))
+        {
+            /* Graph isn't polled this time */
+            result.setState(ResultState::State::NO_VALUE);
+        }
+        else if (_valueParsers[listIdx].evaluate())
         {
             result.setValue(_valueParsers[listIdx].value());
         }
@@ -101,11 +184,40 @@ void GraphDataHandler::handleRegisterData(ResultDoubleList results)
             qCWarning(scopeComm) << msg;
         }
 
-        registerList.append(result);
+        graphResults.setResult(listIdx, result);
     }
 
-    emit graphDataReady(registerList);
+    emit graphDataReady(graphResults);
 }
 
+bool GraphDataHandler::isDue(qint32 exprIdx, SampleFrame const& results, SampleFrame const& heldResults) const
+{
+    if (exprIdx >= _expressionRegisterIndexes.size() || _expressionRegisterIndexes[exprIdx].isEmpty())
+    {
+        /* Constant expression */
+        return true;
+    }
+
+    bool bNewValue = false;
+    for (const qint32 regIdx : std::as_const(_expressionRegisterIndexes[exprIdx]))
+    {
+        if (regIdx >= results.size())
+        {
+            /* No result to compare with */
+            return true;
+        }
+
+        if (heldResults[regIdx].state() == ResultState::State::NO_VALUE)
+        {
+            /* Register was never read */
+            return false;
+        }
 
+        if (results[regIdx].state() != ResultState::State::NO_VALUE)
+        {
+            bNewValue = true;
+        }
+    }
 
+    return bNewValue;
+}
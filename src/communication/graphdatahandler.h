@@ -3,7 +3,7 @@
 
 #include <QRegularExpression>
 #include "modbusregister.h"
-#include "result.h"
+#include "sampleframe.h"
 #include "qmuparser.h"
 
 //Forward declaration
@@ -17,24 +17,32 @@ public:
 
     void processActiveRegisters(GraphDataModel *pGraphDataModel);
     void modbusRegisterList(QList<ModbusRegister>& registerList);
+    void registerPollIntervals(QList<quint32>& pollIntervalList, quint32 defaultInterval);
+    void registerDemand(QList<bool>& demandList);
 
     QString expressionParseMsg(qint32 exprIdx) const;
     qint32 expressionErrorPos(qint32 exprIdx) const;
     QMuParser::ErrorType expressionErrorType(qint32 exprIdx) const;
 
 public slots:
-    void handleRegisterData(ResultDoubleList results);
+    void handleRegisterData(SampleFrame results);
 
 signals:
-    void graphDataReady(ResultDoubleList resultList);
+    void graphDataReady(SampleFrame resultList);
 
 private:
 
+    bool isDue(qint32 exprIdx, SampleFrame const& results, SampleFrame const& heldResults) const;
+
     GraphDataModel* _pGraphDataModel;
 
     QList<ModbusRegister> _registerList;
     QList<quint16> _activeIndexList;
     QList<QMuParser> _valueParsers;
+    QList<QList<qint32> > _expressionRegisterIndexes;
+
+    /* Last value of every register, so connections can be published independently */
+    SampleFrame _heldResults;
 
 };
 
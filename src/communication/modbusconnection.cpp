@@ -6,6 +6,7 @@
 
 #include "modbusaddress.h"
 #include "scopelogging.h"
+#include "acquisitionclock.h"
 #include "modbusconnection.h"
 
 using RegisterType = QModbusDataUnit::RegisterType;
@@ -14,9 +15,12 @@ using ObjectType = ModbusAddress::ObjectType;
 /*!
  * Constructor for ModbusConnection module
  */
-ModbusConnection::ModbusConnection(QObject *parent) : QObject(parent)
+ModbusConnection::ModbusConnection(QObject *parent) : QObject(parent), _lingerTimer(this)
 {
     _bWaitingForConnection = false;
+
+    _lingerTimer.setSingleShot(true);
+    connect(&_lingerTimer, &QTimer::timeout, this, &ModbusConnection::closeConnection);
 }
 
 /*!
@@ -59,17 +63,39 @@ void ModbusConnection::openSerialConnection(struct SerialSettings serialSettings
         connectionData->pModbusClient->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QVariant(serialSettings.databits));
         connectionData->pModbusClient->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QVariant(serialSettings.stopbits));
 
+        if (serialSettings.interFrameDelay != 0)
+        {
+            pClient->setInterFrameDelay(static_cast<int>(serialSettings.interFrameDelay));
+        }
+
         openConnection(connectionData, timeout);
     }
 }
 
 
 
+/*!
+ * Open UDP connection
+ * Qt has no Modbus UDP client, so only \ref NativeModbusConnection supports UDP
+ *
+ * \param[in]   udpSettings     UDP setting for server
+ * \param[in]   timeout         Timeout of connection (in milliseconds)
+ */
+void ModbusConnection::openUdpConnection(struct TcpSettings udpSettings, quint32 timeout)
+{
+    Q_UNUSED(udpSettings);
+    Q_UNUSED(timeout);
+
+    emit connectionError(QModbusDevice::ConnectionError, QString("UDP is only supported by the native engine"));
+}
+
 /*!
  *  Close connection
  */
 void ModbusConnection::closeConnection(void)
 {
+    _lingerTimer.stop();
+
     if (!_connectionList.isEmpty())
     {
         qCDebug(scopeCommConnection) << "Connection close: " << _connectionList.last();
@@ -78,22 +104,77 @@ void ModbusConnection::closeConnection(void)
     }
 }
 
+/*!
+ * Keep idle connection open for a while, so a next read doesn't need to open a new connection
+ * The connection is closed when no new connection is opened within the linger time. An open
+ * of the same connection during the linger time reuses the connection.
+ *
+ * \param[in]   lingerTime      Linger time (in milliseconds), 0 closes the connection immediately
+ */
+void ModbusConnection::lingerConnection(quint32 lingerTime)
+{
+    if ((lingerTime == 0) || !isConnected())
+    {
+        closeConnection();
+    }
+    else
+    {
+        qCDebug(scopeCommConnection) << "Connection linger: " << _connectionList.last();
+        _lingerTimer.start(static_cast<int>(lingerTime));
+    }
+}
+
 /*!
  * Send read request over connection
+ * Multiple requests can be outstanding at the same time. A TCP client sends them immediately and
+ * matches the responses on transaction ID, a serial client queues them and sends them one by one.
  *
  * \param regAddress    register address
- * \param size          number of registers
+ * \param size          number of registers (or bits for coils and discrete inputs)
  * \param serverAddress     slave address
+ * \param requestId     identity of the request, passed back with its result
  */
-void ModbusConnection::sendReadRequest(ModbusAddress regAddress, quint16 size, int serverAddress)
+void ModbusConnection::sendReadRequest(ModbusAddress regAddress, quint16 size, int serverAddress, quint32 requestId)
 {
     if (isConnected())
     {
         auto type = registerType(regAddress.objectType());
         QModbusDataUnit dataUnit(type, static_cast<int>(regAddress.protocolAddress()), size);
-        _connectionList.last()->pReply = _connectionList.last()->pModbusClient->sendReadRequest(dataUnit, serverAddress);
+        ConnectionData* pConnectionData = _connectionList.last();
+        auto pClient = pConnectionData->pModbusClient;
+
+        /* The client applies its current timeout to queued requests when they are sent, so the
+         * timeout is only changed when no request is queued. Otherwise the request gets the
+         * timeout of the requests before it. */
+        const bool bIdle = (pConnectionData->activeReplyCount == 0);
+        if (_bAdaptiveTimeout && bIdle)
+        {
+            pClient->setTimeout(static_cast<int>(_rttEstimator.requestTimeout(_maxTimeout)));
+        }
+
+        ConnectionData::PendingRequest request;
+        request.address = regAddress;
+        request.requestId = requestId;
+        request.timeout = static_cast<quint32>(pClient->timeout());
+        request.bRttSample = bIdle;
+
+        request.sendTimestamp = AcquisitionClock::timestamp();
+        QModbusReply* pReply = pClient->sendReadRequest(dataUnit, serverAddress);
+
+        if (pReply != nullptr)
+        {
+            pConnectionData->pendingReplies.insert(pReply, request);
+            pConnectionData->activeReplyCount++;
 
-        connect(_connectionList.last()->pReply, &QModbusReply::finished, this, &ModbusConnection::handleRequestFinished);
+            connect(pReply, &QModbusReply::finished, this, &ModbusConnection::handleRequestFinished);
+            connect(pReply, &QModbusReply::finished, pConnectionData, [pConnectionData]() {
+                pConnectionData->activeReplyCount--;
+            });
+        }
+        else
+        {
+            emit readRequestError(regAddress, pClient->errorString(), pClient->error(), AcquisitionClock::timestamp(), serverAddress, requestId);
+        }
     }
     else
     {
@@ -101,6 +182,44 @@ void ModbusConnection::sendReadRequest(ModbusAddress regAddress, quint16 size, i
     }
 }
 
+/*!
+ * Forget all outstanding requests of the current connection
+ * Replies that are still received afterwards are ignored.
+ */
+void ModbusConnection::abortPendingRequests(void)
+{
+    if (!_connectionList.isEmpty())
+    {
+        _connectionList.last()->pendingReplies.clear();
+    }
+}
+
+/*!
+ * Set how requests are timed out and repeated
+ * With adaptive timeout, the timeout of a request is derived from the measured round-trip times
+ * (\ref RttEstimator), bounded by the timeout of the connection. A lost frame then only costs a few
+ * round-trip times instead of the full timeout. Applied to connections that are opened afterwards,
+ * the adaptive timeout to every next request. Qt's client has a single timeout for all its requests,
+ * so there the adaptive timeout is only updated when the client has no request queued.
+ *
+ * \param bAdaptiveTimeout    True to enable adaptive request timeout
+ * \param retries             Number of times a request is repeated after a timeout
+ */
+void ModbusConnection::setRequestPolicy(bool bAdaptiveTimeout, quint8 retries)
+{
+    _bAdaptiveTimeout = bAdaptiveTimeout;
+    _retries = retries;
+}
+
+/*!
+ * Return round-trip time estimator of connection
+ * Keeps its samples when a new connection is opened, because the round-trip time depends on the device
+ */
+const RttEstimator& ModbusConnection::rttEstimator() const
+{
+    return _rttEstimator;
+}
+
 /*!
  *  Return whether connection is ok
  *
@@ -248,33 +367,46 @@ void ModbusConnection::connectionDestroyed()
 
 /*!
  * Handle request finished
+ * The moment of the response and the server address are passed with the result (\ref AcquisitionClock::timestamp)
  */
 void ModbusConnection::handleRequestFinished()
 {
+    const qint64 timestamp = AcquisitionClock::timestamp();
+
     QModbusReply * pReply = qobject_cast<QModbusReply *>(QObject::sender());
      auto err = pReply->error();
 
      // Start deletion of reply object before handling data (and closing connection)
      pReply->deleteLater();
 
-     /* Check if reply is for valid connection (the last) */
-     if (pReply == _connectionList.last()->pReply)
+     /* Check if reply is an outstanding request of valid connection (the last) */
+     if (
+         !_connectionList.isEmpty()
+         && _connectionList.last()->pendingReplies.contains(pReply)
+     )
      {
+         const ConnectionData::PendingRequest request = _connectionList.last()->pendingReplies.take(pReply);
+         const ModbusAddress startRegister = request.address;
+         const int serverAddress = pReply->serverAddress();
+
+         updateRttEstimate(request, err, timestamp);
+
          if (err == QModbusDevice::NoError)
          {
              QModbusDataUnit dataUnit = pReply->result();
-             auto addr = ModbusAddress(static_cast<quint16>(dataUnit.startAddress()), objectType(dataUnit.registerType()));
-             emit readRequestSuccess(addr, dataUnit.values().toList());
+
+             /* Qt already unpacked coils and discrete inputs to a value per bit, these are passed as is */
+             emit readRequestSuccess(startRegister, dataUnit.values().toList(), timestamp, serverAddress, request.requestId);
          }
          else if (err == QModbusDevice::ProtocolError)
          {
              auto exceptionCode = pReply->rawResult().exceptionCode();
 
-             emit readRequestProtocolError(exceptionCode);
+             emit readRequestProtocolError(startRegister, exceptionCode, timestamp, serverAddress, request.requestId);
          }
          else
          {
-            emit readRequestError(pReply->errorString(), pReply->error());
+            emit readRequestError(startRegister, pReply->errorString(), pReply->error(), timestamp, serverAddress, request.requestId);
          }
      }
      else
@@ -283,6 +415,32 @@ void ModbusConnection::handleRequestFinished()
      }
 }
 
+/*!
+ * Update round-trip time estimate with finished request
+ * A response that took longer than the timeout of the request is the response of a retry, so it is
+ * ambiguous and not used (Karn's algorithm)
+ */
+void ModbusConnection::updateRttEstimate(const ConnectionData::PendingRequest& request, QModbusDevice::Error err, qint64 timestamp)
+{
+    const qint64 roundTripTime = timestamp - request.sendTimestamp;
+
+    if ((err == QModbusDevice::NoError) || (err == QModbusDevice::ProtocolError))
+    {
+        if (request.bRttSample && (roundTripTime < static_cast<qint64>(request.timeout) * 1000))
+        {
+            _rttEstimator.addSample(roundTripTime);
+        }
+    }
+    else if (err == QModbusDevice::TimeoutError)
+    {
+        _rttEstimator.backOff();
+    }
+    else
+    {
+        // No information about round-trip time
+    }
+}
+
 /*!
  * \brief Prepare for opening a connection
  * \retval  true        when connection needs to be opened
@@ -292,6 +450,11 @@ bool ModbusConnection::prepareConnectionOpen()
 {
     bool bRet;
 
+    /* A lingering connection is reused */
+    _lingerTimer.stop();
+
+    /* Health check of idle connection: a connection that is closed by the peer is no longer in connected state.
+     * A half-open connection (peer gone without closing) isn't detected, its first request fails after the timeout */
     if (isConnected())
     {
         bRet = false;
@@ -322,18 +485,6 @@ RegisterType ModbusConnection::registerType(ObjectType type)
     }
 }
 
-ObjectType ModbusConnection::objectType(RegisterType type)
-{
-    switch (type)
-    {
-    case RegisterType::Coils: return ObjectType::COIL;
-    case RegisterType::DiscreteInputs: return ObjectType::DISCRETE_INPUT;
-    case RegisterType::InputRegisters: return ObjectType::INPUT_REGISTER;
-    case RegisterType::HoldingRegisters: return ObjectType::HOLDING_REGISTER;
-    default: return ObjectType::UNKNOWN;
-    }
-}
-
 /*!
  * General internal error handler
  * Should only be called for last connection in the list, the rest is stale
@@ -389,7 +540,9 @@ qint32 ModbusConnection::findConnectionData(QTimer * pTimer, QModbusClient * pCl
 
 void ModbusConnection::openConnection(QPointer<ConnectionData> connectionData, quint32 timeout)
 {
-    connectionData->pModbusClient->setNumberOfRetries(0);
+    _maxTimeout = timeout;
+
+    connectionData->pModbusClient->setNumberOfRetries(_retries);
     connectionData->pModbusClient->setTimeout(static_cast<int>(timeout));
 
     connect(&connectionData->connectionTimeoutTimer, &QTimer::timeout, this, &ModbusConnection::connectionTimeOut);
@@ -2,6 +2,7 @@
 #define MODBUSCONNECTION_H
 
 #include "modbusaddress.h"
+#include "rttestimator.h"
 #include <QObject>
 #include <QTimer>
 #include <QSerialPort>
@@ -9,6 +10,7 @@
 #include <QModbusReply>
 #include <QModbusClient>
 #include <QPointer>
+#include <QHash>
 
 class ConnectionData : public QObject
 {
@@ -16,7 +18,7 @@ class ConnectionData : public QObject
 public:
 
     explicit ConnectionData(QModbusClient* pModbus):
-        connectionTimeoutTimer(this), bConnectionErrorHandled(false), pReply(nullptr)
+        connectionTimeoutTimer(this), bConnectionErrorHandled(false)
     {
         pModbusClient = pModbus;
     }
@@ -26,11 +28,30 @@ public:
         delete pModbusClient;
     }
 
+    struct PendingRequest
+    {
+        ModbusAddress address;
+
+        /* Identity of the request, passed back with its result */
+        quint32 requestId;
+
+        /* Moment of sending (in µs, see AcquisitionClock) and timeout the client applies to the request (in ms) */
+        qint64 sendTimestamp;
+        quint32 timeout;
+
+        /* Only request on the line when sent, so its round-trip time isn't inflated by queuing */
+        bool bRttSample;
+    };
+
     QTimer connectionTimeoutTimer;
     QModbusClient* pModbusClient;
     bool bConnectionErrorHandled;
 
-    QModbusReply * pReply;
+    /* Outstanding requests */
+    QHash<QModbusReply *, PendingRequest> pendingReplies;
+
+    /* Replies that aren't finished by the client, including the replies of aborted requests */
+    qsizetype activeReplyCount{0};
 };
 
 
@@ -53,23 +74,33 @@ public:
         QSerialPort::BaudRate baudrate;
         QSerialPort::DataBits databits;
         QSerialPort::StopBits stopbits;
+
+        /* Silent interval between frames (in µs), 0 for the default of the standard */
+        quint32 interFrameDelay;
     };
 
-    void openTcpConnection(struct TcpSettings tcpSettings, quint32 timeout);
-    void openSerialConnection(struct SerialSettings serialSettings, quint32 timeout);
-    void closeConnection(void);
+    virtual void openTcpConnection(struct TcpSettings tcpSettings, quint32 timeout);
+    virtual void openSerialConnection(struct SerialSettings serialSettings, quint32 timeout);
+    virtual void openUdpConnection(struct TcpSettings udpSettings, quint32 timeout);
+    virtual void closeConnection(void);
+    virtual void lingerConnection(quint32 lingerTime);
+
+    virtual void sendReadRequest(ModbusAddress regAddress, quint16 size, int serverAddress, quint32 requestId = 0);
+    virtual void abortPendingRequests(void);
+
+    virtual bool isConnected(void);
 
-    void sendReadRequest(ModbusAddress regAddress, quint16 size, int serverAddress);
+    virtual void setRequestPolicy(bool bAdaptiveTimeout, quint8 retries);
 
-    bool isConnected(void);
+    virtual const RttEstimator& rttEstimator() const;
 
 signals:
     void connectionSuccess(void);
     void connectionError(QModbusDevice::Error error, QString msg);
 
-    void readRequestSuccess(ModbusAddress startRegister, QList<quint16> registerDataList);
-    void readRequestProtocolError(QModbusPdu::ExceptionCode exceptionCode);
-    void readRequestError(QString errorString, QModbusDevice::Error error);
+    void readRequestSuccess(ModbusAddress startRegister, QList<quint16> registerDataList, qint64 timestamp, int serverAddress, quint32 requestId);
+    void readRequestProtocolError(ModbusAddress startRegister, QModbusPdu::ExceptionCode exceptionCode, qint64 timestamp, int serverAddress, quint32 requestId);
+    void readRequestError(ModbusAddress startRegister, QString errorString, QModbusDevice::Error error, qint64 timestamp, int serverAddress, quint32 requestId);
 
 private slots:
     void handleConnectionStateChanged(QModbusDevice::State connectionState);
@@ -86,13 +117,24 @@ private slots:
 private:
 
     QModbusDataUnit::RegisterType registerType(ModbusAddress::ObjectType type);
-    ModbusAddress::ObjectType objectType(QModbusDataUnit::RegisterType type);
     void handleConnectionError(QPointer<ConnectionData> connectionData, QString errMsg);
     qint32 findConnectionData(QTimer * pTimer, QModbusClient * pClient);
 
     QList<QPointer<ConnectionData>> _connectionList;
     bool _bWaitingForConnection;
 
+protected:
+    void updateRttEstimate(const ConnectionData::PendingRequest& request, QModbusDevice::Error err, qint64 timestamp);
+
+    /* Closes an idle connection that is kept open between reads */
+    QTimer _lingerTimer;
+
+    /* Configured timeout (in ms), maximum of the adaptive request timeout */
+    quint32 _maxTimeout{};
+    bool _bAdaptiveTimeout{false};
+    quint8 _retries{0};
+    RttEstimator _rttEstimator;
+
 };
 
 #endif // MODBUSCONNECTION_H
@@ -0,0 +1,265 @@
+#include "modbusframecodec.h"
+#include "modbusreaditem.h"
+
+using ObjectType = ModbusAddress::ObjectType;
+
+namespace {
+
+    inline quint8 byteAt(const char* pData, qsizetype idx)
+    {
+        return static_cast<quint8>(pData[idx]);
+    }
+
+    inline quint16 readBigEndian(const char* pData, qsizetype idx)
+    {
+        return static_cast<quint16>((byteAt(pData, idx) << 8) | byteAt(pData, idx + 1));
+    }
+
+    inline void writeBigEndian(char* pBuffer, qsizetype idx, quint16 value)
+    {
+        pBuffer[idx] = static_cast<char>(value >> 8);
+        pBuffer[idx + 1] = static_cast<char>(value & 0xFF);
+    }
+
+    void writeReadRequestPdu(char* pBuffer, quint8 functionCode, quint16 address, quint16 count)
+    {
+        pBuffer[0] = static_cast<char>(functionCode);
+        writeBigEndian(pBuffer, 1, address);
+        writeBigEndian(pBuffer, 3, count);
+    }
+}
+
+/*!
+ * Return read function code of object type
+ * \param type      Object type
+ * \return Function code (holding registers for unknown type)
+ */
+quint8 ModbusFrameCodec::functionCode(ModbusAddress::ObjectType type)
+{
+    switch (type)
+    {
+    case ObjectType::COIL: return 0x01;
+    case ObjectType::DISCRETE_INPUT: return 0x02;
+    case ObjectType::INPUT_REGISTER: return 0x04;
+    case ObjectType::HOLDING_REGISTER: return 0x03;
+    default: return 0x03;
+    }
+}
+
+/*!
+ * Write read request with MBAP header
+ * \param pBuffer           Buffer of at least \ref cTcpReadRequestSize bytes
+ * \param transactionId     Transaction id, returned in the response
+ * \param unitId            Unit id (slave id)
+ * \param functionCode      Read function code
+ * \param address           Protocol address of first register
+ * \param count             Number of registers or bits
+ */
+void ModbusFrameCodec::buildTcpReadRequest(char* pBuffer, quint16 transactionId, quint8 unitId, quint8 functionCode, quint16 address, quint16 count)
+{
+    writeBigEndian(pBuffer, 0, transactionId);
+    writeBigEndian(pBuffer, 2, 0); /* Modbus protocol */
+    writeBigEndian(pBuffer, 4, static_cast<quint16>(1 + cReadRequestPduSize));
+    pBuffer[6] = static_cast<char>(unitId);
+
+    writeReadRequestPdu(&pBuffer[cMbapHeaderSize], functionCode, address, count);
+}
+
+/*!
+ * Write read request with slave address and CRC
+ * \param pBuffer           Buffer of at least \ref cRtuReadRequestSize bytes
+ * \param slaveId           Slave address
+ * \param functionCode      Read function code
+ * \param address           Protocol address of first register
+ * \param count             Number of registers or bits
+ */
+void ModbusFrameCodec::buildRtuReadRequest(char* pBuffer, quint8 slaveId, quint8 functionCode, quint16 address, quint16 count)
+{
+    pBuffer[0] = static_cast<char>(slaveId);
+    writeReadRequestPdu(&pBuffer[1], functionCode, address, count);
+
+    /* CRC is sent low byte first */
+    const quint16 crc = crc16(pBuffer, 1 + cReadRequestPduSize);
+    pBuffer[6] = static_cast<char>(crc & 0xFF);
+    pBuffer[7] = static_cast<char>(crc >> 8);
+}
+
+/*!
+ * Return size of TCP frame at start of data
+ * \param pData     Received data
+ * \param size      Number of received bytes
+ * \retval 0    Header isn't complete yet
+ * \retval -1   Header is invalid (stream can't be synchronized anymore)
+ * \return Size of the complete frame, including MBAP header
+ */
+qsizetype ModbusFrameCodec::tcpFrameSize(const char* pData, qsizetype size)
+{
+    if (size < cMbapHeaderSize)
+    {
+        return 0;
+    }
+
+    const quint16 protocolId = readBigEndian(pData, 2);
+    const quint16 length = readBigEndian(pData, 4);
+
+    /* Length counts unit id and PDU */
+    if ((protocolId != 0) || (length < 2) || (length > 1 + cMaxPduSize))
+    {
+        return -1;
+    }
+
+    return 6 + length;
+}
+
+quint16 ModbusFrameCodec::tcpTransactionId(const char* pData)
+{
+    return readBigEndian(pData, 0);
+}
+
+quint8 ModbusFrameCodec::tcpUnitId(const char* pData)
+{
+    return byteAt(pData, 6);
+}
+
+/*!
+ * Return size of RTU response at start of data
+ * RTU frames have no length field, the size is derived from the function code and byte count
+ * \param pData     Received data
+ * \param size      Number of received bytes
+ * \retval 0    Not enough bytes to know the size
+ * \return Size of the complete frame, including slave address and CRC
+ */
+qsizetype ModbusFrameCodec::rtuFrameSize(const char* pData, qsizetype size)
+{
+    if (size < 2)
+    {
+        return 0;
+    }
+
+    if (byteAt(pData, 1) & cExceptionFlag)
+    {
+        /* Slave address, function code, exception code and CRC */
+        return 5;
+    }
+
+    if (size < 3)
+    {
+        return 0;
+    }
+
+    /* Slave address, function code, byte count, data and CRC */
+    return 3 + byteAt(pData, 2) + 2;
+}
+
+/*!
+ * Check CRC at end of RTU frame
+ * \param pData     Frame, including CRC
+ * \param size      Size of frame
+ */
+bool ModbusFrameCodec::isRtuCrcValid(const char* pData, qsizetype size)
+{
+    if (size < 4)
+    {
+        return false;
+    }
+
+    const quint16 crc = static_cast<quint16>(byteAt(pData, size - 2) | (byteAt(pData, size - 1) << 8));
+
+    return crc == crc16(pData, size - 2);
+}
+
+/*!
+ * Calculate CRC-16 (Modbus) of data
+ */
+quint16 ModbusFrameCodec::crc16(const char* pData, qsizetype size)
+{
+    quint16 crc = 0xFFFF;
+
+    for (qsizetype idx = 0; idx < size; idx++)
+    {
+        crc ^= byteAt(pData, idx);
+        for (quint32 bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x0001) ? static_cast<quint16>((crc >> 1) ^ 0xA001) : static_cast<quint16>(crc >> 1);
+        }
+    }
+
+    return crc;
+}
+
+/*!
+ * Decode PDU of response to a read request
+ * Registers are decoded into values, bits are passed packed in 16-bit words (see \ref ModbusReadItem::packedBit).
+ * The bits are packed in the response in the same order, so they are copied without unpacking.
+ *
+ * \param pPdu              PDU of response (starting at function code)
+ * \param pduSize           Size of PDU
+ * \param functionCode      Function code of request
+ * \param count             Number of registers or bits of request
+ * \param values            Decoded values
+ * \param exceptionCode     Exception code, when response is an exception
+ * \return Result of parsing
+ */
+ModbusFrameCodec::ParseResult ModbusFrameCodec::parseReadResponse(const char* pPdu, qsizetype pduSize, quint8 functionCode, quint16 count,
+                                                                  QList<quint16>& values, quint8& exceptionCode)
+{
+    if (pduSize < 2)
+    {
+        return ParseResult::INVALID;
+    }
+
+    const quint8 responseFunctionCode = byteAt(pPdu, 0);
+
+    if (responseFunctionCode == (functionCode | cExceptionFlag))
+    {
+        exceptionCode = byteAt(pPdu, 1);
+        return ParseResult::EXCEPTION;
+    }
+
+    if (responseFunctionCode != functionCode)
+    {
+        return ParseResult::INVALID;
+    }
+
+    const bool bBits = (functionCode == 0x01) || (functionCode == 0x02);
+    const qsizetype byteCount = byteAt(pPdu, 1);
+    const qsizetype expectedByteCount = bBits ? (count + 7) / 8 : count * 2;
+
+    if ((byteCount != expectedByteCount) || (pduSize < 2 + byteCount))
+    {
+        return ParseResult::INVALID;
+    }
+
+    const char* pValues = &pPdu[2];
+
+    if (bBits)
+    {
+        values.resize(ModbusReadItem::packedSize(count));
+        for (qsizetype idx = 0; idx < values.size(); idx++)
+        {
+            const qsizetype byteIdx = idx * 2;
+            quint16 word = byteAt(pValues, byteIdx);
+            if (byteIdx + 1 < byteCount)
+            {
+                word |= static_cast<quint16>(byteAt(pValues, byteIdx + 1) << 8);
+            }
+            values[idx] = word;
+        }
+
+        /* Padding bits of last byte are not part of the result */
+        if (count % 16 != 0)
+        {
+            values.last() &= static_cast<quint16>((1u << (count % 16)) - 1);
+        }
+    }
+    else
+    {
+        values.resize(count);
+        for (qsizetype idx = 0; idx < count; idx++)
+        {
+            values[idx] = readBigEndian(pValues, idx * 2);
+        }
+    }
+
+    return ParseResult::SUCCESS;
+}
@@ -0,0 +1,54 @@
+#ifndef MODBUSFRAMECODEC_H
+#define MODBUSFRAMECODEC_H
+
+#include <QList>
+
+#include "modbusaddress.h"
+
+/*!
+ * Encoding and decoding of Modbus read frames (TCP and RTU) in place
+ * Requests are written into a buffer of the caller, responses are parsed directly from the receive buffer
+ */
+class ModbusFrameCodec
+{
+public:
+
+    enum class ParseResult
+    {
+        SUCCESS,   /* Values of response are decoded */
+        EXCEPTION, /* Response is a Modbus exception */
+        INVALID,   /* Response doesn't match the request */
+    };
+
+    static quint8 functionCode(ModbusAddress::ObjectType type);
+
+    static void buildTcpReadRequest(char* pBuffer, quint16 transactionId, quint8 unitId, quint8 functionCode, quint16 address, quint16 count);
+    static void buildRtuReadRequest(char* pBuffer, quint8 slaveId, quint8 functionCode, quint16 address, quint16 count);
+
+    static qsizetype tcpFrameSize(const char* pData, qsizetype size);
+    static quint16 tcpTransactionId(const char* pData);
+    static quint8 tcpUnitId(const char* pData);
+
+    static qsizetype rtuFrameSize(const char* pData, qsizetype size);
+    static bool isRtuCrcValid(const char* pData, qsizetype size);
+    static quint16 crc16(const char* pData, qsizetype size);
+
+    static ParseResult parseReadResponse(const char* pPdu, qsizetype pduSize, quint8 functionCode, quint16 count,
+                                         QList<quint16>& values, quint8& exceptionCode);
+
+    /* MBAP header: transaction id, protocol id, length and unit id */
+    static constexpr qsizetype cMbapHeaderSize = 7;
+
+    /* Read request: function code, start address and count */
+    static constexpr qsizetype cReadRequestPduSize = 5;
+
+    static constexpr qsizetype cTcpReadRequestSize = cMbapHeaderSize + cReadRequestPduSize;
+    static constexpr qsizetype cRtuReadRequestSize = 1 + cReadRequestPduSize + 2;
+
+    /* Largest PDU of the Modbus protocol */
+    static constexpr qsizetype cMaxPduSize = 253;
+
+    static constexpr quint8 cExceptionFlag = 0x80;
+};
+
+#endif // MODBUSFRAMECODEC_H
@@ -1,213 +1,607 @@
 #include "modbusmaster.h"
-#include "modbusresultmap.h"
+#include "modbusresultframe.h"
 #include "settingsmodel.h"
 #include "modbusconnection.h"
+#include "busarbiter.h"
+#include "nativemodbusconnection.h"
 #include "readregisters.h"
+#include "readcostmodel.h"
+#include "deviceprofilestore.h"
+#include "acquisitionclock.h"
+#include "scopelogging.h"
 
 #include <util.h>
 
+#include <limits>
+
 Q_DECLARE_METATYPE(Result<quint16>);
 
 using State = ResultState::State;
 
-ModbusMaster::ModbusMaster(SettingsModel * pSettingsModel, quint8 connectionId) : QObject(nullptr), _connectionId(connectionId), _pSettingsModel(pSettingsModel)
+ModbusMaster::ModbusMaster(SettingsModel * pSettingsModel, quint8 connectionId, QObject *parent) : QObject(parent), _connectionId(connectionId), _pSettingsModel(pSettingsModel)
 {
     qMetaTypeId<Result<quint16> >();
 
-    // Use queued connection to make sure reply is deleted before closing connection
-    connect(this, &ModbusMaster::triggerNextRequest, this, &ModbusMaster::handleTriggerNextRequest, Qt::QueuedConnection);
-
-    connect(&_modbusConnection, &ModbusConnection::connectionSuccess, this, &ModbusMaster::handleConnectionOpened);
-    connect(&_modbusConnection, &ModbusConnection::connectionError, this, &ModbusMaster::handlerConnectionError);
-    connect(&_modbusConnection, &ModbusConnection::readRequestSuccess, this, &ModbusMaster::handleRequestSuccess);
-    connect(&_modbusConnection, &ModbusConnection::readRequestProtocolError, this, &ModbusMaster::handleRequestProtocolError);
-    connect(&_modbusConnection, &ModbusConnection::readRequestError, this, &ModbusMaster::handleRequestError);
+    _pModbusConnection = createModbusConnection();
+    connectModbusConnection();
 }
 
 ModbusMaster::~ModbusMaster()
 {
-    _modbusConnection.disconnect();
-    _modbusConnection.closeConnection();
+    _pModbusConnection->disconnect();
+    _pModbusConnection->closeConnection();
 }
 
 void ModbusMaster::readRegisterList(QList<ModbusAddress> registerList)
 {
+    _bReadFailed = false;
+
     if (_pSettingsModel->connectionState(_connectionId) == false)
     {
-        ModbusResultMap errMap;
-
-        for (int i = 0; i < registerList.size(); i++)
-        {
-            const auto result = Result<quint16>(0, State::INVALID);
-            errMap.insert(registerList.at(i), result);
-        }
+        /* All slots of a new frame are invalid */
+        ModbusResultFrame errFrame(registerList);
 
         logError(QStringLiteral("Read failed because connection is disabled"));
-        logResults(errMap);
+        logResults(errFrame, AcquisitionClock::timestamp());
     }
     else if (registerList.size() > 0)
     {
         logInfo("Register list read: " + dumpToString(registerList));
 
-        _readRegisters.resetRead(registerList, _pSettingsModel->consecutiveMax(_connectionId));
+        updateDeviceProfile();
 
-        /* Open connection */
-        if (_pSettingsModel->connectionType(_connectionId) == Connection::TYPE_SERIAL)
-        {
-            struct ModbusConnection::SerialSettings serialSettings =
-            {
-                .portName = _pSettingsModel->portName(_connectionId),
-                .parity = _pSettingsModel->parity(_connectionId),
-                .baudrate = _pSettingsModel->baudrate(_connectionId),
-                .databits = _pSettingsModel->databits(_connectionId),
-                .stopbits = _pSettingsModel->stopbits(_connectionId),
-            };
-            _modbusConnection.openSerialConnection(serialSettings, _pSettingsModel->timeout(_connectionId));
-        }
-        else
-        {
-            struct ModbusConnection::TcpSettings tcpSettings =
-            {
-                .ip = _pSettingsModel->ipAddress(_connectionId),
-                .port = _pSettingsModel->port(_connectionId),
-            };
-            _modbusConnection.openTcpConnection(tcpSettings, _pSettingsModel->timeout(_connectionId));
-        }
+        const quint16 maxBridgedGap = readCostModel().maxBridgedGap();
+        _readRegisters.resetRead(registerList, _pSettingsModel->consecutiveMax(_connectionId), maxBridgedGap);
+        _bReadActive = true;
+        _bRequestFailed = false;
+        _bFinishPending = false;
+        _responseTimestamp = 0;
+
+        /* Events of a previous read are no part of this read */
+        _readTask.destroy();
+        _readEvents.clear();
+        _bSequenceRunning = true;
+        _readTask = readSequence();
+        _bSequenceRunning = false;
+
+        /* Sequence can be done immediately, for example when the connection fails to open */
+        checkReadDone();
     }
     else
     {
-        ModbusResultMap emptyResults;
-        emit modbusPollDone(emptyResults, _connectionId);
+        ModbusResultFrame emptyResults;
+        emit modbusPollDone(emptyResults, _connectionId, AcquisitionClock::timestamp());
     }
 }
 
-void ModbusMaster::cleanUp()
+/*!
+ * Set store that is used to load and save learned device profiles
+ * Without store, device profiles are only kept in memory
+ * \param pDeviceProfileStore   Device profile store (can be nullptr)
+ */
+void ModbusMaster::setDeviceProfileStore(DeviceProfileStore * pDeviceProfileStore)
+{
+    _pDeviceProfileStore = pDeviceProfileStore;
+
+    /* Force reload of profile on next read */
+    _deviceProfileKey.clear();
+}
+
+/*!
+ * Forget learned device profile
+ * The profile is loaded again from the store on the next read, so a cleared store starts with an empty profile
+ */
+void ModbusMaster::resetDeviceProfile()
+{
+    _deviceProfileKey.clear();
+}
+
+/*!
+ * Set arbiter of the shared bus of this connection
+ * The master then uses a channel of the bus instead of its own connection, so all masters on
+ * the same serial port or TCP gateway share a single client. Should only be changed when no read is active.
+ * The own connection is also recreated when another engine is selected in the settings.
+ * \param pBusArbiter   Arbiter of bus (nullptr for own connection)
+ */
+void ModbusMaster::setBusArbiter(BusArbiter * pBusArbiter)
+{
+    if ((pBusArbiter == _pBusArbiter) && (_bNativeEngine == useNativeEngine()))
+    {
+        return;
+    }
+
+    _pBusArbiter = pBusArbiter;
+
+    _pModbusConnection->disconnect();
+    _pModbusConnection->closeConnection();
+    delete _pModbusConnection;
+
+    if (_pBusArbiter != nullptr)
+    {
+        _pModbusConnection = _pBusArbiter->createChannel(this);
+    }
+    else
+    {
+        _pModbusConnection = createModbusConnection();
+    }
+
+    connectModbusConnection();
+}
+
+/*!
+ * Return whether the last read failed because of the connection, or because a request wasn't answered
+ * Exceptions of the device don't count as failure, the device is still reachable
+ * Valid when \ref modbusPollDone is emitted
+ */
+bool ModbusMaster::readFailed() const
+{
+    return _bReadFailed;
+}
+
+/*!
+ * Open connection ahead of the first read
+ * Emits \ref connectionReady when the connection is opened or failed. An opened connection is kept
+ * open, so the first read can use it immediately.
+ */
+void ModbusMaster::warmUp()
 {
-    /* Close connection when not closing automatically */
-    if (_pSettingsModel->persistentConnection(_connectionId))
+    if (_bWarmUpActive)
+    {
+        /* Open is already pending, it emits connectionReady */
+        return;
+    }
+
+    if (_bReadActive)
     {
-        _modbusConnection.closeConnection();
+        /* Connection is owned by the active read, which reports its own failure */
+        emit connectionReady(_connectionId, true);
+        return;
     }
+
+    _bWarmUpActive = true;
+    openConnection();
+}
+
+/*!
+ * End the session of this master
+ * An active read is ended without result, so a late reply isn't published in the next session
+ */
+void ModbusMaster::cleanUp()
+{
+    _bWarmUpActive = false;
+
+    _bReadActive = false;
+    _bFinishPending = false;
+    _readTask.destroy();
+    _readEvents.clear();
+
+    /* Close persistent or lingering connection */
+    _pModbusConnection->closeConnection();
 }
 
 void ModbusMaster::handleConnectionOpened()
 {
-    emit triggerNextRequest();
+    if (_bWarmUpActive)
+    {
+        _bWarmUpActive = false;
+        emit connectionReady(_connectionId, true);
+    }
+
+    if (!_bReadActive)
+    {
+        return;
+    }
+
+    postReadEvent(ReadEvent{.type = ReadEvent::Type::CONNECTED});
 }
 
 void ModbusMaster::handlerConnectionError(QModbusDevice::Error error, QString msg)
 {
-    Q_UNUSED(error);
+    if (_bWarmUpActive)
+    {
+        _bWarmUpActive = false;
+
+        logError(QString("Connection error: ") + msg);
+        _pModbusConnection->closeConnection();
+
+        emit connectionReady(_connectionId, false);
+    }
+
+    if (!_bReadActive)
+    {
+        return;
+    }
+
+    postReadEvent(ReadEvent{.type = ReadEvent::Type::CONNECTION_ERROR, .message = msg, .error = error});
+}
+
+void ModbusMaster::handleRequestSuccess(ModbusAddress startRegister, QList<quint16> registerDataList, qint64 timestamp)
+{
+    if (!_bReadActive)
+    {
+        return;
+    }
+
+    postReadEvent(ReadEvent{.type = ReadEvent::Type::REQUEST_SUCCESS, .address = startRegister,
+                            .values = registerDataList, .timestamp = timestamp});
+}
+
+void ModbusMaster::handleRequestProtocolError(ModbusAddress startRegister, QModbusPdu::ExceptionCode exceptionCode, qint64 timestamp)
+{
+    if (!_bReadActive)
+    {
+        return;
+    }
+
+    postReadEvent(ReadEvent{.type = ReadEvent::Type::REQUEST_PROTOCOL_ERROR, .address = startRegister,
+                            .exceptionCode = exceptionCode, .timestamp = timestamp});
+}
+
+void ModbusMaster::handleRequestError(ModbusAddress startRegister, QString errorString, QModbusDevice::Error error, qint64 timestamp)
+{
+    if (!_bReadActive)
+    {
+        return;
+    }
 
-    logError(QString("Connection error: ") + msg);
+    postReadEvent(ReadEvent{.type = ReadEvent::Type::REQUEST_ERROR, .address = startRegister,
+                            .message = errorString, .error = error, .timestamp = timestamp});
+}
 
-    _readRegisters.addAllErrors();
+/*!
+ * Finish read when its sequence is done
+ * Queued, so the reply that ended the read is deleted before the connection is closed
+ */
+void ModbusMaster::handleReadDone()
+{
+    _bFinishPending = false;
 
-    finishRead(true);
+    if (_bReadActive && _readTask.isDone())
+    {
+        finishRead(_readTask.result());
+    }
 }
 
-void ModbusMaster::handleRequestSuccess(ModbusAddress startRegister, QList<quint16> registerDataList)
+/*!
+ * Sequence of a single read
+ * Opens the connection and reads the planned blocks, with up to _requestWindow requests in flight. The
+ * sequence is resumed directly from the signal of the connection for every response, so a request doesn't
+ * cost a trip through the event loop.
+ * \return Coroutine of the read, its result is true when the connection failed
+ */
+ReadTask ModbusMaster::readSequence()
 {
-    logInfo(QString("Read success"));
+    openConnection();
+
+    ReadEvent event = co_await _readEvents.next();
+    if (event.type == ReadEvent::Type::CONNECTION_ERROR)
+    {
+        logError(QString("Connection error: ") + event.message);
+        _readRegisters.addAllErrors();
+        co_return true;
+    }
+
+    while (_readRegisters.hasNext() || (_readRegisters.inFlightCount() > 0))
+    {
+        /* Keep up to _requestWindow requests in flight, results can arrive in any order */
+        while (_readRegisters.hasNext() && (_readRegisters.inFlightCount() < _requestWindow))
+        {
+            ModbusReadItem readItem = _readRegisters.takeNext();
+
+            logInfo("Partial list read: " + QString("Start address (%0) and count (%1)").arg(readItem.address().toString()).arg(readItem.count()));
+
+            _pModbusConnection->sendReadRequest(readItem.address(), readItem.count(), _pSettingsModel->slaveId(_connectionId));
+        }
+
+        event = co_await _readEvents.next();
+
+        if (event.type == ReadEvent::Type::CONNECTION_ERROR)
+        {
+            logError(QString("Connection error: ") + event.message);
+            _readRegisters.addAllErrors();
+            co_return true;
+        }
+        else if (event.type == ReadEvent::Type::REQUEST_SUCCESS)
+        {
+            _responseTimestamp = event.timestamp;
+
+            logInfo(QString("Read success"));
+
+            _readRegisters.addSuccess(event.address, event.values);
+        }
+        else if (event.type == ReadEvent::Type::REQUEST_PROTOCOL_ERROR)
+        {
+            _responseTimestamp = event.timestamp;
 
-    // Success
-    _readRegisters.addSuccess(startRegister, registerDataList);
+            logError(QString("Modbus Exception: %0").arg(event.exceptionCode));
+
+            handleException(event.address, event.exceptionCode);
+        }
+        else if (event.type == ReadEvent::Type::REQUEST_ERROR)
+        {
+            _responseTimestamp = event.timestamp;
+
+            logError(QString("Request Failed:  %0 (%1)").arg(event.message).arg(event.error));
+
+            // When we don't receive an exception, abort read and close connection
+            _readRegisters.addAllErrors();
+            _bRequestFailed = true;
+        }
+        else
+        {
+            // Connection event of already open connection: nothing to do
+        }
+    }
 
-    // Start next read
-    emit triggerNextRequest();
+    co_return false;
 }
 
-void ModbusMaster::handleRequestProtocolError(QModbusPdu::ExceptionCode exceptionCode)
+/*!
+ * Open connection of the read, the sequence continues when the connection is opened or failed
+ */
+void ModbusMaster::openConnection()
 {
-    logError(QString("Modbus Exception: %0").arg(exceptionCode));
+    _pModbusConnection->setRequestPolicy(_pSettingsModel->adaptiveTimeout(_connectionId), _pSettingsModel->retries(_connectionId));
+
+    if (_pSettingsModel->connectionType(_connectionId) == Connection::TYPE_SERIAL)
+    {
+        /* RTU is strictly sequential: only one request on the bus at a time */
+        _requestWindow = 1;
+
+        struct ModbusConnection::SerialSettings serialSettings =
+        {
+            .portName = _pSettingsModel->portName(_connectionId),
+            .parity = _pSettingsModel->parity(_connectionId),
+            .baudrate = _pSettingsModel->baudrate(_connectionId),
+            .databits = _pSettingsModel->databits(_connectionId),
+            .stopbits = _pSettingsModel->stopbits(_connectionId),
+            .interFrameDelay = _pSettingsModel->interFrameDelay(_connectionId),
+        };
+        _pModbusConnection->openSerialConnection(serialSettings, _pSettingsModel->timeout(_connectionId));
+    }
+    else
+    {
+        _requestWindow = qMax(_pSettingsModel->requestWindow(_connectionId), static_cast<quint8>(1));
+
+        struct ModbusConnection::TcpSettings tcpSettings =
+        {
+            .ip = _pSettingsModel->ipAddress(_connectionId),
+            .port = _pSettingsModel->port(_connectionId),
+        };
+
+        if (_pSettingsModel->connectionType(_connectionId) == Connection::TYPE_UDP)
+        {
+            _pModbusConnection->openUdpConnection(tcpSettings, _pSettingsModel->timeout(_connectionId));
+        }
+        else
+        {
+            _pModbusConnection->openTcpConnection(tcpSettings, _pSettingsModel->timeout(_connectionId));
+        }
+    }
+}
 
+/*!
+ * Handle Modbus exception of a request
+ * \param startRegister    Start address of request
+ * \param exceptionCode    Exception code of response
+ */
+void ModbusMaster::handleException(ModbusAddress startRegister, QModbusPdu::ExceptionCode exceptionCode)
+{
     if (
         (exceptionCode == QModbusPdu::IllegalDataAddress)
         || (exceptionCode == QModbusPdu::IllegalDataValue)
         )
     {
-        if (_readRegisters.next().count() > 1)
+        // Remember range, so next reads are planned around it
+        _readRegisters.markUnreadable(startRegister);
+
+        if (_readRegisters.inFlightItem(startRegister).count() > 1)
         {
-            // Split read into separate reads on specific exception code and count is more than 1
-            _readRegisters.splitNextToSingleReads();
+            // Split read in halves on specific exception code and count is more than 1
+            _readRegisters.splitInHalf(startRegister);
         }
         else
         {
             // Add error to results
-            _readRegisters.addError();
+            _readRegisters.addError(startRegister);
         }
     }
     else if (exceptionCode == QModbusPdu::IllegalFunction)
     {
-        // No need to continue this read
-        _readRegisters.addAllErrors();
+        // Device doesn't support this object type, skip it in next reads
+        _readRegisters.markUnsupported(startRegister);
     }
     else
     {
-        _readRegisters.addError();
+        _readRegisters.addError(startRegister);
     }
-
-    // Start next read
-    emit triggerNextRequest();
 }
 
-void ModbusMaster::handleRequestError(QString errorString, QModbusDevice::Error error)
+/*!
+ * Pass event of the connection to the read sequence
+ * An event that is emitted from within the running sequence is only queued, the sequence takes it on its
+ * next co_await. The done check is left to the call that resumed the sequence.
+ */
+void ModbusMaster::postReadEvent(ReadEvent event)
 {
-    logError(QString("Request Failed:  %0 (%1)").arg(errorString).arg(error));
+    if (_bSequenceRunning)
+    {
+        _readEvents.post(std::move(event));
+        return;
+    }
 
-    // When we don't receive an exception, abort read and close connection
-    _readRegisters.addAllErrors();
+    _bSequenceRunning = true;
+    _readEvents.post(std::move(event));
+    _bSequenceRunning = false;
 
-    // Start next read
-    emit triggerNextRequest();
+    checkReadDone();
 }
 
-void ModbusMaster::handleTriggerNextRequest(void)
+/*!
+ * Schedule finish of the read when its sequence is done
+ * Only allowed while the sequence is suspended, done() of a running coroutine is undefined
+ */
+void ModbusMaster::checkReadDone()
 {
-    if (_readRegisters.hasNext())
+    if (_bReadActive && !_bSequenceRunning && !_bFinishPending && _readTask.isDone())
     {
-        ModbusReadItem readItem = _readRegisters.next();
+        _bFinishPending = true;
+        QMetaObject::invokeMethod(this, &ModbusMaster::handleReadDone, Qt::QueuedConnection);
+    }
+}
 
-        logInfo("Partial list read: " + QString("Start address (%0) and count (%1)").arg(readItem.address().toString()).arg(readItem.count()));
+ModbusConnection* ModbusMaster::createModbusConnection()
+{
+    _bNativeEngine = useNativeEngine();
 
-        _modbusConnection.sendReadRequest(readItem.address(), readItem.count(), _pSettingsModel->slaveId(_connectionId));
+    if (_bNativeEngine)
+    {
+        return new NativeModbusConnection(this);
     }
     else
     {
-        finishRead(false);
+        return new ModbusConnection(this);
     }
 }
 
+/*!
+ * Return whether the connection uses the native engine
+ * Qt has no Modbus UDP client, so UDP connections always use the native engine
+ */
+bool ModbusMaster::useNativeEngine()
+{
+    return _pSettingsModel->nativeEngine() || (_pSettingsModel->connectionType(_connectionId) == Connection::TYPE_UDP);
+}
+
+void ModbusMaster::connectModbusConnection()
+{
+    connect(_pModbusConnection, &ModbusConnection::connectionSuccess, this, &ModbusMaster::handleConnectionOpened);
+    connect(_pModbusConnection, &ModbusConnection::connectionError, this, &ModbusMaster::handlerConnectionError);
+    connect(_pModbusConnection, &ModbusConnection::readRequestSuccess, this, &ModbusMaster::handleRequestSuccess);
+    connect(_pModbusConnection, &ModbusConnection::readRequestProtocolError, this, &ModbusMaster::handleRequestProtocolError);
+    connect(_pModbusConnection, &ModbusConnection::readRequestError, this, &ModbusMaster::handleRequestError);
+}
+
 void ModbusMaster::finishRead(bool bError)
 {
-    ModbusResultMap results = _readRegisters.resultMap();
+    _bReadActive = false;
+
+    /* Late replies of this read should not end up in the next read */
+    _pModbusConnection->abortPendingRequests();
+
+    _readRegisters.learnReadLimits();
+    if (!bError && !_bRequestFailed)
+    {
+        _readRegisters.addSuccessfulPoll();
+    }
+    storeDeviceProfile();
+
+    ModbusResultFrame results = _readRegisters.resultFrame();
 
-    logResults(results);
+    /* Sample is timestamped with the last response, or now when no response was received (connection error) */
+    const qint64 timestamp = _responseTimestamp != 0 ? _responseTimestamp : AcquisitionClock::timestamp();
 
-    bool bcloseConnection;
+    _bReadFailed = bError || _bRequestFailed;
 
-    if (bError)
+    logResults(results, timestamp);
+
+    if (bError || _bRequestFailed)
     {
         /* Always close connection on error */
-        bcloseConnection = true;
+        _pModbusConnection->closeConnection();
+    }
+    else if (!_pSettingsModel->persistentConnection(_connectionId))
+    {
+        /* Keep connection open for a while, so the next poll doesn't need to reconnect */
+        _pModbusConnection->lingerConnection(_pSettingsModel->lingerTime(_connectionId));
+    }
+    else
+    {
+        /* Keep connection open */
+    }
+}
+
+ReadCostModel ModbusMaster::readCostModel()
+{
+    if (_pSettingsModel->connectionType(_connectionId) == Connection::TYPE_SERIAL)
+    {
+        return ReadCostModel::serial(_pSettingsModel->baudrate(_connectionId),
+                                     _pSettingsModel->parity(_connectionId),
+                                     _pSettingsModel->databits(_connectionId),
+                                     _pSettingsModel->stopbits(_connectionId));
+    }
+    else
+    {
+        /* Use measured round-trip time when available */
+        const RttEstimator& rttEstimator = _pModbusConnection->rttEstimator();
+        if (rttEstimator.sampleCount() > 0)
+        {
+            const qint64 roundTripTime = qBound<qint64>(0, rttEstimator.smoothedRtt(), std::numeric_limits<quint32>::max());
+            return ReadCostModel::tcp(static_cast<quint32>(roundTripTime));
+        }
+
+        return ReadCostModel::tcp(ReadCostModel::cTcpRoundTripEstimate);
+    }
+}
+
+QString ModbusMaster::deviceProfileKey()
+{
+    const quint8 slaveId = _pSettingsModel->slaveId(_connectionId);
+
+    if (_pSettingsModel->connectionType(_connectionId) == Connection::TYPE_SERIAL)
+    {
+        return DeviceProfile::serialKey(_pSettingsModel->portName(_connectionId), slaveId);
+    }
+    else if (_pSettingsModel->connectionType(_connectionId) == Connection::TYPE_UDP)
+    {
+        return DeviceProfile::udpKey(_pSettingsModel->ipAddress(_connectionId), _pSettingsModel->port(_connectionId), slaveId);
     }
     else
     {
-        bcloseConnection = !_pSettingsModel->persistentConnection(_connectionId);
+        return DeviceProfile::tcpKey(_pSettingsModel->ipAddress(_connectionId), _pSettingsModel->port(_connectionId), slaveId);
+    }
+}
+
+void ModbusMaster::updateDeviceProfile()
+{
+    const QString key = deviceProfileKey();
+
+    /* Only (re)load profile when a different device is read */
+    if (key != _deviceProfileKey)
+    {
+        _deviceProfileKey = key;
+
+        DeviceProfile deviceProfile;
+        if (_pDeviceProfileStore != nullptr)
+        {
+            deviceProfile = _pDeviceProfileStore->load(key);
+        }
+
+        _readRegisters.setDeviceProfile(deviceProfile);
+        _storedProfileRevision = deviceProfile.revision();
     }
+}
 
-    if (bcloseConnection)
+void ModbusMaster::storeDeviceProfile()
+{
+    const DeviceProfile deviceProfile = _readRegisters.deviceProfile();
+
+    if (
+        (_pDeviceProfileStore != nullptr)
+        && (deviceProfile.revision() != _storedProfileRevision)
+    )
     {
-        _modbusConnection.closeConnection();
+        _pDeviceProfileStore->save(_deviceProfileKey, deviceProfile);
+        _storedProfileRevision = deviceProfile.revision();
     }
 }
 
-QString ModbusMaster::dumpToString(ModbusResultMap map) const
+QString ModbusMaster::dumpToString(ModbusResultFrame frame) const
 {
     QString str;
     QDebug dStream(&str);
 
-    dStream << map;
+    dStream << frame.toResultMap();
 
     return str;
 }
@@ -222,10 +616,15 @@ QString ModbusMaster::dumpToString(QList<ModbusAddress> list) const
     return str;
 }
 
-void ModbusMaster::logResults(ModbusResultMap const &results)
+void ModbusMaster::logResults(ModbusResultFrame const &results, qint64 timestamp)
 {
-    logInfo("Result map: " + dumpToString(results));
-    emit modbusPollDone(results, _connectionId);
+    /* Only convert results for the log when it is actually shown */
+    if (scopeCommConnection().isDebugEnabled())
+    {
+        logInfo("Result map: " + dumpToString(results));
+    }
+
+    emit modbusPollDone(results, _connectionId, timestamp);
 }
 
 void ModbusMaster::logInfo(QString msg)
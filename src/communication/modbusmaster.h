@@ -6,54 +6,107 @@
 #include <QModbusDevice>
 #include <QModbusReply>
 
-#include "modbusresultmap.h"
+#include "modbusresultframe.h"
 #include "modbusconnection.h"
 #include "readregisters.h"
+#include "readcostmodel.h"
+#include "readsequence.h"
 
 /* Forward declaration */
 class SettingsModel;
+class DeviceProfileStore;
+class BusArbiter;
 
 class ModbusMaster : public QObject
 {
     Q_OBJECT
 public:
-    explicit ModbusMaster(SettingsModel * pSettingsModel, quint8 connectionId);
+    explicit ModbusMaster(SettingsModel * pSettingsModel, quint8 connectionId, QObject *parent = nullptr);
     virtual ~ModbusMaster();
 
     void readRegisterList(QList<ModbusAddress> registerList);
+    void warmUp();
+
+    void setDeviceProfileStore(DeviceProfileStore * pDeviceProfileStore);
+    void resetDeviceProfile();
+    void setBusArbiter(BusArbiter * pBusArbiter);
+
+    bool readFailed() const;
 
     void cleanUp();
 
 signals:
-    void modbusPollDone(ModbusResultMap modbusResults, quint8 connectionId);
+    void modbusPollDone(ModbusResultFrame modbusResults, quint8 connectionId, qint64 timestamp);
     void modbusLogError(QString msg);
     void modbusLogInfo(QString msg);
-    void triggerNextRequest();
+    void connectionReady(quint8 connectionId, bool bReady);
 
 private slots:
     void handleConnectionOpened();
     void handlerConnectionError(QModbusDevice::Error error, QString msg);
 
-    void handleRequestSuccess(ModbusAddress startRegister, QList<quint16> registerDataList);
-    void handleRequestProtocolError(QModbusPdu::ExceptionCode exceptionCode);
-    void handleRequestError(QString errorString, QModbusDevice::Error error);
+    void handleRequestSuccess(ModbusAddress startRegister, QList<quint16> registerDataList, qint64 timestamp);
+    void handleRequestProtocolError(ModbusAddress startRegister, QModbusPdu::ExceptionCode exceptionCode, qint64 timestamp);
+    void handleRequestError(ModbusAddress startRegister, QString errorString, QModbusDevice::Error error, qint64 timestamp);
 
-    void handleTriggerNextRequest(void);
+    void handleReadDone();
 
 private:
+    ModbusConnection* createModbusConnection();
+    bool useNativeEngine();
+    void connectModbusConnection();
+    ReadTask readSequence();
+    void openConnection();
+    void handleException(ModbusAddress startRegister, QModbusPdu::ExceptionCode exceptionCode);
+    void postReadEvent(ReadEvent event);
+    void checkReadDone();
     void finishRead(bool bError);
-    QString dumpToString(ModbusResultMap map) const;
+    ReadCostModel readCostModel();
+    QString deviceProfileKey();
+    void updateDeviceProfile();
+    void storeDeviceProfile();
+    QString dumpToString(ModbusResultFrame frame) const;
     QString dumpToString(QList<ModbusAddress> list) const;
 
-    void logResults(const ModbusResultMap &results);
+    void logResults(const ModbusResultFrame &results, qint64 timestamp);
 
     void logInfo(QString msg);
     void logError(QString msg);
 
     quint8 _connectionId{};
+    quint8 _requestWindow{1};
+    bool _bReadActive{false};
+
+    /* Connection is opened ahead of the first read */
+    bool _bWarmUpActive{false};
+
+    /* Request of active read failed without exception (timeout, connection lost) */
+    bool _bRequestFailed{false};
+
+    /* Last read failed because of the connection or a request without response */
+    bool _bReadFailed{false};
+
+    /* Sequence of active read and the connection events it waits for */
+    ReadEventQueue _readEvents;
+    ReadTask _readTask;
+    bool _bFinishPending{false};
+
+    /* Sequence is running (not suspended), its state can't be inspected */
+    bool _bSequenceRunning{false};
+
+    /* Moment of last response of active read (in µs, see AcquisitionClock) */
+    qint64 _responseTimestamp{0};
 
     SettingsModel * _pSettingsModel{};
-    ModbusConnection _modbusConnection{};
+    DeviceProfileStore * _pDeviceProfileStore{nullptr};
+    QString _deviceProfileKey;
+    quint32 _storedProfileRevision{0};
+
+    /* Own connection, or channel of a shared bus */
+    ModbusConnection * _pModbusConnection{};
+    BusArbiter * _pBusArbiter{nullptr};
+    bool _bNativeEngine{false};
+
     ReadRegisters _readRegisters{};
 };
 
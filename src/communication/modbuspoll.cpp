@@ -1,75 +1,132 @@
 
-#include <QDateTime>
+#include <QThread>
+#include <algorithm>
+#include <limits>
 
 #include "modbusmaster.h"
+#include "busarbiter.h"
 #include "settingsmodel.h"
 #include "scopelogging.h"
 #include "formatdatetime.h"
 #include "registervaluehandler.h"
+#include "acquisitionclock.h"
 
 #include "modbuspoll.h"
 
+/*!
+ * Constructor for ModbusPoll
+ * All objects of the acquisition are children of this object, so the complete acquisition can be moved to a
+ * dedicated thread with \ref QObject::moveToThread. Results are then delivered to the GUI thread as queued signals.
+ * \param pSettingsModel   Settings of the GUI (a snapshot is taken when communication starts)
+ * \param parent           Parent object
+ */
 ModbusPoll::ModbusPoll(SettingsModel * pSettingsModel, QObject *parent) :
     QObject(parent), _bPollActive(false)
 {
+    qRegisterMetaType<SampleFrame>("SampleFrame");
 
-    _pPollTimer = new QTimer();
     _pSettingsModel = pSettingsModel;
+    _pSettingsSnapshot = new SettingsModel(this);
+    _pSettingsSnapshot->copySettings(*_pSettingsModel);
 
-    _pRegisterValueHandler = new RegisterValueHandler(_pSettingsModel);
+    _pRegisterValueHandler = new RegisterValueHandler(_pSettingsSnapshot, this);
     connect(_pRegisterValueHandler, &RegisterValueHandler::registerDataReady, this, &ModbusPoll::registerDataReady);
 
     /* Setup modbus master */
-    for (quint8 i = 0u; i < Connection::ID_CNT; i++)
-    {
-        auto modbusData = new ModbusMasterData(new ModbusMaster(_pSettingsModel, i));
-        _modbusMasters.append(modbusData);
-
-        connect(_modbusMasters.last()->pModbusMaster, &ModbusMaster::modbusPollDone, this, &ModbusPoll::handlePollDone);
-        connect(_modbusMasters.last()->pModbusMaster, &ModbusMaster::modbusLogError, this, &ModbusPoll::handleModbusError);
-        connect(_modbusMasters.last()->pModbusMaster, &ModbusMaster::modbusLogInfo, this, &ModbusPoll::handleModbusInfo);
-    }
-
-    _activeMastersCount = 0;
-    _lastPollStart = QDateTime::currentMSecsSinceEpoch();
+    updateConnectionCount();
 }
 
 ModbusPoll::~ModbusPoll()
 {
-    for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+    for (qsizetype i = 0; i < _modbusMasters.size(); i++)
     {
         _modbusMasters[i]->pModbusMaster->disconnect();
 
         delete _modbusMasters[i]->pModbusMaster;
         delete _modbusMasters[i];
     }
+}
+
+/*!
+ * Start polling registers
+ * Registers with the same poll interval form a poll group. Every poll, the groups that are due are read together.
+ * Every connection has its own poll timeline and publishes its results as soon as they are received, so
+ * a slow connection doesn't delay the others.
+ * Can be called from another thread: the caller is blocked until the settings snapshot is taken.
+ * \param registerList     List of registers
+ * \param pollIntervalList Poll interval (in ms) of every register (poll time of log settings when empty or 0)
+ */
+void ModbusPoll::startCommunication(QList<ModbusRegister>& registerList, QList<quint32> pollIntervalList)
+{
+    /* Settings model belongs to the thread of the caller, block it while the snapshot is taken */
+    const auto connectionType = QThread::currentThread() == thread() ? Qt::DirectConnection : Qt::BlockingQueuedConnection;
 
-    delete _pPollTimer;
+    QMetaObject::invokeMethod(this, [this, registerList, pollIntervalList]() {
+            _pSettingsSnapshot->copySettings(*_pSettingsModel);
+            startPolling(registerList, pollIntervalList);
+        }, connectionType);
 }
 
-void ModbusPoll::startCommunication(QList<ModbusRegister>& registerList)
+void ModbusPoll::startPolling(QList<ModbusRegister> registerList, QList<quint32> pollIntervalList)
 {
-    _pRegisterValueHandler->setRegisters(registerList);
+    updateConnectionCount();
+    updateBusArbiters();
 
-    // Trigger read immediately
-    _pPollTimer->singleShot(1, this, &ModbusPoll::triggerRegisterRead);
+    const QList<quint8> pollGroupList = createPollGroups(registerList, pollIntervalList);
+    _pRegisterValueHandler->setRegisters(registerList, pollGroupList);
+    _pRegisterValueHandler->setRegisterDemand(_demandList);
 
     _bPollActive = true;
 
+    /* Only poll connections with registers, but keep one timeline when there are only constant expressions */
+    bool bAnyPolled = false;
+    for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+    {
+        _modbusMasters[i]->bPolled = _pRegisterValueHandler->pollGroups(i) != 0;
+        bAnyPolled |= _modbusMasters[i]->bPolled;
+    }
+
+    if (!bAnyPolled)
+    {
+        _modbusMasters[Connection::ID_1]->bPolled = true;
+    }
+
+    _pollClock.start();
+
+    _activeCount = 0;
+    _waitingConnections.clear();
+    _warmUpConnections.clear();
+
+    for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+    {
+        _modbusMasters[i]->bActive = false;
+        _modbusMasters[i]->bWaiting = false;
+        _modbusMasters[i]->circuitBreaker.reset();
+    }
+
+    /* Without registers, constant expressions are calculated at the poll time of the log settings */
+    _groupPeriods.clear();
+    const QList<quint32> intervals = _groupIntervals.isEmpty() ? QList<quint32>({_pSettingsSnapshot->pollTime()}) : _groupIntervals;
+    for (const quint32 interval : intervals)
+    {
+        _groupPeriods.append(static_cast<qint64>(interval) * 1000000);
+    }
+
     qCInfo(scopeComm) << QString("Start logging: %1").arg(FormatDateTime::currentDateTime());
 
-    for (quint8 i = 0u; i < Connection::ID_CNT; i++)
+    for (quint8 i = 0u; i < _modbusMasters.size(); i++)
     {
-        if (_pSettingsModel->connectionState(i))
+        if (_pSettingsSnapshot->connectionState(i))
         {
             QString str;
-            if (_pSettingsModel->connectionType(i) == Connection::TYPE_TCP)
+            if (_pSettingsSnapshot->connectionType(i) != Connection::TYPE_SERIAL)
             {
-                str = QString("[Conn %0] %1:%2 - slave id %3")
+                str = QString("[Conn %0] %1%2:%3 - slave id %4")
                                 .arg(i + 1)
-                                .arg(_pSettingsModel->ipAddress(i))
-                                .arg(_pSettingsModel->port(i))
-                                .arg(_pSettingsModel->slaveId(i))
+                                .arg(_pSettingsSnapshot->connectionType(i) == Connection::TYPE_UDP ? "udp://" : "")
+                                .arg(_pSettingsSnapshot->ipAddress(i))
+                                .arg(_pSettingsSnapshot->port(i))
+                                .arg(_pSettingsSnapshot->slaveId(i))
                                 ;
             }
             else
@@ -77,14 +134,14 @@ void ModbusPoll::startCommunication(QList<ModbusRegister>& registerList)
                 QString strParity;
                 QString strDataBits;
                 QString strStopBits;
-                _pSettingsModel->serialConnectionStrings(i, strParity, strDataBits, strStopBits);
+                _pSettingsSnapshot->serialConnectionStrings(i, strParity, strDataBits, strStopBits);
 
                 str = QString("[Conn %0] %1, %2, %3, %4, %5 - slave id %6")
                                 .arg(i + 1)
-                                .arg(_pSettingsModel->portName(i))
-                                .arg(_pSettingsModel->baudrate(i))
+                                .arg(_pSettingsSnapshot->portName(i))
+                                .arg(_pSettingsSnapshot->baudrate(i))
                                 .arg(strParity, strDataBits, strStopBits)
-                                .arg(_pSettingsModel->slaveId(i))
+                                .arg(_pSettingsSnapshot->slaveId(i))
                                 ;
             }
 
@@ -93,62 +150,187 @@ void ModbusPoll::startCommunication(QList<ModbusRegister>& registerList)
     }
 
     resetCommunicationStats();
+
+    /* Open all connections at the same time, so their connect times and connection timeouts overlap */
+    for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+    {
+        if (_modbusMasters[i]->bPolled)
+        {
+            if (
+                _pSettingsSnapshot->connectionState(i)
+                && (_pRegisterValueHandler->pollGroups(i) != 0)
+            )
+            {
+                _warmUpConnections.insert(i);
+            }
+            else
+            {
+                startPollTimeline(i);
+            }
+        }
+    }
+
+    /* A master can report its connection as ready immediately */
+    const QSet<quint8> warmUpConnections = _warmUpConnections;
+    for (const quint8 connectionId : warmUpConnections)
+    {
+        _modbusMasters[connectionId]->pModbusMaster->warmUp();
+    }
+}
+
+/*!
+ * Handle connection that is opened ahead of the first poll
+ * The first poll of a connection starts when its connection is opened or failed. A connection that
+ * isn't reachable doesn't delay the first poll of the other connections.
+ * \param connectionId     Connection id
+ * \param bReady           True when connection is opened
+ */
+void ModbusPoll::handleConnectionReady(quint8 connectionId, bool bReady)
+{
+    if (!_bPollActive || !_warmUpConnections.remove(connectionId))
+    {
+        return;
+    }
+
+    if (bReady)
+    {
+        qCInfo(scopeCommConnection) << QString("[Conn %0] Connection ready").arg(connectionId + 1);
+    }
+    else
+    {
+        qCWarning(scopeCommConnection) << QString("[Conn %0] Connection not ready").arg(connectionId + 1);
+    }
+
+    emit connectionReady(connectionId, bReady);
+
+    startPollTimeline(connectionId);
+}
+
+/*!
+ * Start poll timeline of a connection, all its poll groups are due immediately
+ * \param connectionId     Connection id
+ */
+void ModbusPoll::startPollTimeline(quint8 connectionId)
+{
+    ModbusMasterData * pMasterData = _modbusMasters[connectionId];
+
+    const quint64 groupMask = _pRegisterValueHandler->pollGroups(connectionId) != 0 ? _pRegisterValueHandler->pollGroups(connectionId) : 0x01;
+
+    /* All groups are due at start */
+    pMasterData->scheduler.reset(_groupPeriods, groupMask, _pollClock.nsecsElapsed());
+
+    // Trigger read immediately
+    pMasterData->pollTimer.start(0);
 }
 
 void ModbusPoll::resetCommunicationStats()
 {
-    _lastPollStart = QDateTime::currentMSecsSinceEpoch();
+    QMetaObject::invokeMethod(this, [this]() {
+            for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+            {
+                _modbusMasters[i]->scheduler.resetStatistics();
+            }
+        });
 }
 
-void ModbusPoll::handlePollDone(ModbusResultMap partialResultMap, quint8 connectionId)
+void ModbusPoll::setDeviceProfileStore(DeviceProfileStore * pDeviceProfileStore)
 {
-    bool lastResult = false;
+    _pDeviceProfileStore = pDeviceProfileStore;
 
-    quint8 activeCnt = 0;
-    for(quint8 i = 0; i < Connection::ID_CNT; i++)
+    for (quint8 i = 0u; i < _modbusMasters.size(); i++)
     {
-        if (_modbusMasters[i]->bActive)
-        {
-            activeCnt++;
-        }
+        _modbusMasters[i]->pModbusMaster->setDeviceProfileStore(pDeviceProfileStore);
     }
+}
 
-    /* Last active modbus master has returned its result */
-    if (activeCnt == 1 || activeCnt == 0)
+/*!
+ * Remove all learned device profiles, so the devices are probed again from scratch
+ */
+void ModbusPoll::clearDeviceProfiles()
+{
+    QMetaObject::invokeMethod(this, [this]() {
+            if (_pDeviceProfileStore != nullptr)
+            {
+                _pDeviceProfileStore->clear();
+            }
+
+            for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+            {
+                _modbusMasters[i]->pModbusMaster->resetDeviceProfile();
+            }
+        });
+}
+
+/*!
+ * Set what happens when polls can't be done at their deadline
+ * \param policy   Overrun policy of all connections
+ */
+void ModbusPoll::setOverrunPolicy(PollScheduler::OverrunPolicy policy)
+{
+    QMetaObject::invokeMethod(this, [this, policy]() {
+            _overrunPolicy = policy;
+            for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+            {
+                _modbusMasters[i]->scheduler.setOverrunPolicy(policy);
+            }
+        });
+}
+
+/*!
+ * Set registers that are read during polling
+ * Takes effect from the next poll of every connection and is kept when polling is started again.
+ * Registers without demand get no value. Can be called from another thread.
+ * \param demandList       Demand of every register of \ref startCommunication (all registers are read when empty)
+ */
+void ModbusPoll::setRegisterDemand(QList<bool> demandList)
+{
+    QMetaObject::invokeMethod(this, [this, demandList]() {
+            _demandList = demandList;
+            _pRegisterValueHandler->setRegisterDemand(demandList);
+        });
+}
+
+/*!
+ * Handle results of a connection
+ * \param resultFrame          Results of the connection
+ * \param connectionId         Connection id
+ * \param timestamp            Moment of the response (in µs, see \ref AcquisitionClock::timestamp)
+ */
+void ModbusPoll::handlePollDone(ModbusResultFrame resultFrame, quint8 connectionId, qint64 timestamp)
+{
+    if (connectionId >= _modbusMasters.size())
     {
-        /* Last result */
-        lastResult = true;
+        return;
     }
 
-    // Always add data to result map
-    _pRegisterValueHandler->processPartialResult(partialResultMap, connectionId);
+    /* Only reads that were handed to the master tell something about the health of the connection */
+    const bool bRead = _modbusMasters[connectionId]->bActive;
 
-    // Set master as inactive
-    if (connectionId < Connection::ID_CNT)
+    if (_modbusMasters[connectionId]->bActive)
     {
         _modbusMasters[connectionId]->bActive = false;
+        _activeCount--;
     }
 
-    if (lastResult)
+    if (_bPollActive)
     {
-        _pRegisterValueHandler->finishRead();
-
-        // Restart timer when previous request has been handled
-        uint waitInterval;
-        const quint32 passedInterval = static_cast<quint32>(QDateTime::currentMSecsSinceEpoch() - _lastPollStart);
-
-        if (passedInterval > _pSettingsModel->pollTime())
+        if (bRead)
         {
-            // Poll again immediately
-            waitInterval = 1;
-        }
-        else
-        {
-            // Set waitInterval to remaining time
-            waitInterval = _pSettingsModel->pollTime() - passedInterval;
+            updateCircuitBreaker(connectionId, _modbusMasters[connectionId]->pModbusMaster->readFailed());
         }
 
-        _pPollTimer->singleShot(static_cast<int>(waitInterval), this, &ModbusPoll::triggerRegisterRead);
+        // Publish results of this connection, without waiting for other connections
+        _pRegisterValueHandler->processPartialResult(resultFrame, connectionId);
+        _pRegisterValueHandler->finishConnectionRead(connectionId, timestamp);
+
+        const PollScheduler& scheduler = _modbusMasters[connectionId]->scheduler;
+        emit pollStatisticsUpdated(connectionId, scheduler.missedDeadlines(), scheduler.achievedPeriod());
+
+        // Restart timer when previous request has been handled
+        scheduleNextPoll(connectionId);
+
+        // A slot of the concurrency limit is free
+        startWaitingConnections();
     }
 }
 
@@ -162,70 +344,331 @@ void ModbusPoll::handleModbusInfo(QString msg)
     qCDebug(scopeCommConnection) << msg;
 }
 
+/*!
+ * Stop polling registers
+ * Can be called from another thread: polling is marked inactive immediately, the connections are
+ * cleaned up in the communication thread.
+ */
 void ModbusPoll::stopCommunication()
 {
     _bPollActive = false;
-    _pPollTimer->stop();
+
+    QMetaObject::invokeMethod(this, &ModbusPoll::stopPolling);
+}
+
+void ModbusPoll::stopPolling()
+{
+    _warmUpConnections.clear();
+
+    for(quint8 i = 0; i < _modbusMasters.size(); i++)
+    {
+        _modbusMasters[i]->pollTimer.stop();
+        _modbusMasters[i]->bWaiting = false;
+    }
+
+    _waitingConnections.clear();
 
     qCInfo(scopeComm) << QString("Stop logging: %1").arg(FormatDateTime::currentDateTime());
 
-    for(quint8 i = 0; i < Connection::ID_CNT; i++)
+    for(quint8 i = 0; i < _modbusMasters.size(); i++)
     {
         _modbusMasters[i]->pModbusMaster->cleanUp();
     }
 }
 
-bool ModbusPoll::isActive()
+bool ModbusPoll::isActive() const
 {
     return _bPollActive;
 }
 
-void ModbusPoll::triggerRegisterRead()
+void ModbusPoll::triggerRegisterRead(quint8 connectionId)
 {
-    if(_bPollActive)
+    ModbusMasterData * pMasterData = _modbusMasters[connectionId];
+
+    if (_bPollActive && !pMasterData->bActive && !pMasterData->bWaiting)
     {
-        _lastPollStart = QDateTime::currentMSecsSinceEpoch();
+        const quint8 maxConcurrent = _pSettingsSnapshot->maxConcurrentConnections();
+        if ((maxConcurrent != 0) && (_activeCount >= maxConcurrent))
+        {
+            // Poll as soon as another connection is done, deadlines that pass meanwhile are handled by the scheduler
+            pMasterData->bWaiting = true;
+            _waitingConnections.enqueue(connectionId);
+            return;
+        }
 
-        _pRegisterValueHandler->startRead();
+        const quint64 dueGroups = pMasterData->scheduler.takeDueGroups(_pollClock.nsecsElapsed());
 
-        /* Strange construction is required to avoid race condition:
-         *
-         * First set _activeMastersCount to correct value
-         * And only then activate masters (readRegisterList)
-         *
-         * readRegisterList can return immediately and this will give race condition otherwise
-         */
+        if (dueGroups == 0)
+        {
+            // Timer fired before first poll group is due
+            scheduleNextPoll(connectionId);
+            return;
+        }
 
-        _activeMastersCount = 0;
+        if (!pMasterData->circuitBreaker.allowRead(_pollClock.nsecsElapsed()))
+        {
+            // Connection is tripped: publish registers without value, without touching the network
+            _pRegisterValueHandler->startConnectionRead(connectionId, 0);
+            _pRegisterValueHandler->finishConnectionRead(connectionId, AcquisitionClock::timestamp());
+            scheduleNextPoll(connectionId);
+            return;
+        }
+
+        _pRegisterValueHandler->startConnectionRead(connectionId, dueGroups);
 
-        QList<QList<ModbusAddress> > regAddrList;
+        QList<ModbusAddress> regAddrList;
+        _pRegisterValueHandler->registerAddresList(regAddrList, connectionId, dueGroups);
 
-        for (quint8 i = 0u; i < Connection::ID_CNT; i++)
+        if (regAddrList.count() > 0)
         {
-            regAddrList.append(QList<ModbusAddress>());
+            /* Set active before read, readRegisterList can return immediately */
+            pMasterData->bActive = true;
+            _activeCount++;
+            pMasterData->pModbusMaster->readRegisterList(regAddrList);
+        }
+        else
+        {
+            ModbusResultFrame emptyResultFrame;
+            handlePollDone(emptyResultFrame, connectionId, AcquisitionClock::timestamp());
+        }
+    }
+}
 
-            _pRegisterValueHandler->registerAddresList(regAddrList.last(), i);
+/*!
+ * Update circuit breaker of a connection with the outcome of a read
+ * \param connectionId     Connection id
+ * \param bReadFailed      True when the read failed because of the connection or a request without response
+ */
+void ModbusPoll::updateCircuitBreaker(quint8 connectionId, bool bReadFailed)
+{
+    CircuitBreaker& circuitBreaker = _modbusMasters[connectionId]->circuitBreaker;
+    const bool bWasTripped = circuitBreaker.isTripped();
 
-            if (regAddrList.last().count() > 0)
-            {
-                _activeMastersCount++;
-            }
+    if (bReadFailed)
+    {
+        circuitBreaker.recordFailure(_pollClock.nsecsElapsed());
+    }
+    else
+    {
+        circuitBreaker.recordSuccess();
+    }
+
+    if (circuitBreaker.state() == CircuitBreaker::State::OPEN)
+    {
+        qCWarning(scopeCommConnection) << QString("[Conn %0] Connection tripped, retry in %1 ms")
+                                              .arg(connectionId + 1)
+                                              .arg(circuitBreaker.backOff() / 1000000);
+    }
+    else if (bWasTripped && !circuitBreaker.isTripped())
+    {
+        qCInfo(scopeCommConnection) << QString("[Conn %0] Connection restored").arg(connectionId + 1);
+    }
+
+    if (bWasTripped != circuitBreaker.isTripped())
+    {
+        emit connectionTripped(connectionId, circuitBreaker.isTripped());
+    }
+}
+
+/*!
+ * Start connections that are waiting for a free slot of the concurrency limit, in order of arrival
+ */
+void ModbusPoll::startWaitingConnections()
+{
+    const quint8 maxConcurrent = _pSettingsSnapshot->maxConcurrentConnections();
+
+    while (
+        !_waitingConnections.isEmpty()
+        && ((maxConcurrent == 0) || (_activeCount < maxConcurrent))
+    )
+    {
+        const quint8 connectionId = _waitingConnections.dequeue();
+
+        _modbusMasters[connectionId]->bWaiting = false;
+        triggerRegisterRead(connectionId);
+    }
+}
+
+/*!
+ * Create a modbus master for every connection of the settings snapshot
+ * Masters of connections that are removed are deleted, only allowed when not polling
+ */
+void ModbusPoll::updateConnectionCount()
+{
+    const quint8 connectionCount = _pSettingsSnapshot->connectionCount();
+
+    while (_modbusMasters.size() > connectionCount)
+    {
+        ModbusMasterData * pMasterData = _modbusMasters.takeLast();
+
+        pMasterData->pModbusMaster->disconnect();
+        delete pMasterData->pModbusMaster;
+        delete pMasterData;
+    }
+
+    while (_modbusMasters.size() < connectionCount)
+    {
+        addModbusMaster(static_cast<quint8>(_modbusMasters.size()));
+    }
+}
+
+/*!
+ * Share a single client between the enabled connections to the same serial port or TCP endpoint (gateway)
+ * The arbiter of the bus interleaves the requests of all these connections (slave ids), instead
+ * of every connection opening its own port or socket. A connection that is alone on its bus keeps its own connection.
+ */
+void ModbusPoll::updateBusArbiters()
+{
+    QHash<QString, QList<quint8> > portConnections;
+    for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+    {
+        if (_pSettingsSnapshot->connectionState(i))
+        {
+            portConnections[busKey(i)].append(i);
         }
+    }
 
-        for (quint8 i = 0u; i < Connection::ID_CNT; i++)
+    QHash<QString, BusArbiter *> busArbiters;
+    QList<BusArbiter *> masterArbiters(_modbusMasters.size(), nullptr);
+    for (auto it = portConnections.cbegin(); it != portConnections.cend(); ++it)
+    {
+        if (it.value().size() < 2)
         {
-            if (regAddrList.at(i).count() > 0)
-            {
-                _modbusMasters[i]->bActive = true;
-                _modbusMasters[i]->pModbusMaster->readRegisterList(regAddrList.at(i));
-            }
+            continue;
         }
 
-        if (_activeMastersCount == 0)
+        /* Qt has no Modbus UDP client */
+        const bool bUdp = _pSettingsSnapshot->connectionType(it.value().first()) == Connection::TYPE_UDP;
+        auto pBusArbiter = new BusArbiter(_pSettingsSnapshot->nativeEngine() || bUdp, this);
+
+        /* Delay of the slowest device on the bus */
+        quint32 turnaroundDelay = 0;
+        quint32 requestWindow = std::numeric_limits<quint8>::max();
+        for (const quint8 connectionId : it.value())
         {
-            ModbusResultMap emptyResultMap;
-            handlePollDone(emptyResultMap, Connection::ID_1);
+            turnaroundDelay = qMax(turnaroundDelay, _pSettingsSnapshot->turnaroundDelay(connectionId));
+            requestWindow = qMin(requestWindow, static_cast<quint32>(qMax(_pSettingsSnapshot->requestWindow(connectionId), static_cast<quint8>(1))));
+            masterArbiters[connectionId] = pBusArbiter;
         }
+
+        if (_pSettingsSnapshot->connectionType(it.value().first()) == Connection::TYPE_SERIAL)
+        {
+            /* One request on the line at a time, the arbiter decides which slave id goes next */
+            pBusArbiter->setMaxSentCount(1);
+            pBusArbiter->setTurnaroundDelay(turnaroundDelay);
+            pBusArbiter->setMaxBurstCount(requestWindow);
+        }
+        else
+        {
+            /* Outstanding requests on the shared socket, as supported by every connection to the gateway (TCP or UDP) */
+            pBusArbiter->setMaxSentCount(requestWindow);
+        }
+
+        busArbiters.insert(it.key(), pBusArbiter);
+    }
+
+    for (quint8 i = 0u; i < _modbusMasters.size(); i++)
+    {
+        _modbusMasters[i]->pModbusMaster->setBusArbiter(masterArbiters[i]);
+    }
+
+    /* Masters no longer use the previous arbiters */
+    qDeleteAll(_busArbiters);
+    _busArbiters = busArbiters;
+}
+
+/*!
+ * Return key of the bus of a connection, connections with the same key share a bus
+ * \param connectionId     Connection id
+ * \return Serial port name, or TCP or UDP endpoint
+ */
+QString ModbusPoll::busKey(quint8 connectionId)
+{
+    if (_pSettingsSnapshot->connectionType(connectionId) == Connection::TYPE_SERIAL)
+    {
+        return QString("serial:%1").arg(_pSettingsSnapshot->portName(connectionId));
+    }
+    else if (_pSettingsSnapshot->connectionType(connectionId) == Connection::TYPE_UDP)
+    {
+        return QString("udp:%1:%2").arg(_pSettingsSnapshot->ipAddress(connectionId)).arg(_pSettingsSnapshot->port(connectionId));
+    }
+    else
+    {
+        return QString("tcp:%1:%2").arg(_pSettingsSnapshot->ipAddress(connectionId)).arg(_pSettingsSnapshot->port(connectionId));
+    }
+}
+
+void ModbusPoll::addModbusMaster(quint8 connectionId)
+{
+    auto modbusData = new ModbusMasterData(new ModbusMaster(_pSettingsSnapshot, connectionId, this), this);
+    _modbusMasters.append(modbusData);
+
+    modbusData->scheduler.setOverrunPolicy(_overrunPolicy);
+    if (_pDeviceProfileStore != nullptr)
+    {
+        modbusData->pModbusMaster->setDeviceProfileStore(_pDeviceProfileStore);
+    }
+
+    connect(modbusData->pModbusMaster, &ModbusMaster::modbusPollDone, this, &ModbusPoll::handlePollDone);
+    connect(modbusData->pModbusMaster, &ModbusMaster::modbusLogError, this, &ModbusPoll::handleModbusError);
+    connect(modbusData->pModbusMaster, &ModbusMaster::modbusLogInfo, this, &ModbusPoll::handleModbusInfo);
+    connect(modbusData->pModbusMaster, &ModbusMaster::connectionReady, this, &ModbusPoll::handleConnectionReady);
+
+    connect(&modbusData->pollTimer, &QTimer::timeout, this, [this, connectionId]() { triggerRegisterRead(connectionId); });
+}
+
+QList<quint8> ModbusPoll::createPollGroups(QList<ModbusRegister>& registerList, QList<quint32> pollIntervalList)
+{
+    QList<quint32> intervals;
+    for (qint32 idx = 0; idx < registerList.size(); idx++)
+    {
+        const quint32 interval = (idx < pollIntervalList.size()) && (pollIntervalList[idx] != 0) ? pollIntervalList[idx] : _pSettingsSnapshot->pollTime();
+        intervals.append(interval);
+    }
+
+    QList<quint32> groupIntervals = intervals;
+    std::sort(groupIntervals.begin(), groupIntervals.end());
+    groupIntervals.erase(std::unique(groupIntervals.begin(), groupIntervals.end()), groupIntervals.end());
+
+    /* Slowest intervals are merged in last group (which is polled more often) */
+    if (groupIntervals.size() > RegisterValueHandler::cMaxPollGroups)
+    {
+        groupIntervals.resize(RegisterValueHandler::cMaxPollGroups);
+    }
+
+    _groupIntervals = groupIntervals;
+
+    QList<quint8> pollGroupList;
+    for (const quint32 interval : std::as_const(intervals))
+    {
+        qint32 group = static_cast<qint32>(groupIntervals.indexOf(interval));
+        if (group < 0)
+        {
+            group = static_cast<qint32>(groupIntervals.size()) - 1;
+        }
+
+        pollGroupList.append(static_cast<quint8>(group));
     }
+
+    return pollGroupList;
 }
 
+void ModbusPoll::scheduleNextPoll(quint8 connectionId)
+{
+    const qint64 deadline = _modbusMasters[connectionId]->scheduler.nextDeadline();
+    const qint64 remaining = deadline - _pollClock.nsecsElapsed();
+
+    int waitInterval;
+    if ((deadline == PollScheduler::cNoDeadline) || (remaining <= 0))
+    {
+        // Poll again immediately
+        waitInterval = 0;
+    }
+    else
+    {
+        // Wait until next poll group is due (rounded up, timer has ms resolution)
+        waitInterval = static_cast<int>((remaining + 999999) / 1000000);
+    }
+
+    _modbusMasters[connectionId]->pollTimer.start(waitInterval);
+}
@@ -3,13 +3,23 @@
 
 #include <QStringListModel>
 #include <QTimer>
-#include "modbusresultmap.h"
+#include <QQueue>
+#include <QHash>
+#include <QSet>
+#include <QElapsedTimer>
+#include <atomic>
+#include "modbusresultframe.h"
+#include "sampleframe.h"
 #include "modbusregister.h"
+#include "pollscheduler.h"
+#include "circuitbreaker.h"
 
 //Forward declaration
 class SettingsModel;
 class RegisterValueHandler;
 class ModbusMaster;
+class DeviceProfileStore;
+class BusArbiter;
 
 class ModbusMasterData : public QObject
 {
@@ -21,10 +31,24 @@ public:
     {
         pModbusMaster = pArgModbusMaster;
         bActive = false;
+        bPolled = false;
+        bWaiting = false;
+
+        pollTimer.setSingleShot(true);
+        pollTimer.setTimerType(Qt::PreciseTimer);
     }
 
     ModbusMaster * pModbusMaster;
     bool bActive;
+
+    /* Every connection has its own poll timeline */
+    bool bPolled;
+    bool bWaiting;
+    QTimer pollTimer{this};
+    PollScheduler scheduler;
+
+    /* Reads of a failing connection are skipped, so they don't delay the other connections */
+    CircuitBreaker circuitBreaker;
 };
 
 class ModbusPoll : public QObject
@@ -34,33 +58,80 @@ public:
     explicit ModbusPoll(SettingsModel * pSettingsModel, QObject *parent = nullptr);
     ~ModbusPoll();
 
-    void startCommunication(QList<ModbusRegister>& registerList);
+    void startCommunication(QList<ModbusRegister>& registerList, QList<quint32> pollIntervalList = QList<quint32>());
     void stopCommunication();
 
-    bool isActive();
+    bool isActive() const;
     void resetCommunicationStats();
 
+    void setDeviceProfileStore(DeviceProfileStore * pDeviceProfileStore);
+    void clearDeviceProfiles();
+    void setOverrunPolicy(PollScheduler::OverrunPolicy policy);
+    void setRegisterDemand(QList<bool> demandList);
+
 signals:
-    void registerDataReady(ResultDoubleList registers);
+    void registerDataReady(SampleFrame registers);
+    void pollStatisticsUpdated(quint8 connectionId, quint32 missedDeadlines, qint64 achievedPeriod);
+    void connectionTripped(quint8 connectionId, bool bTripped);
+    void connectionReady(quint8 connectionId, bool bReady);
 
 private slots:
-    void handlePollDone(ModbusResultMap partialResultMap, quint8 connectionId);
+    void handlePollDone(ModbusResultFrame resultFrame, quint8 connectionId, qint64 timestamp);
     void handleModbusError(QString msg);
     void handleModbusInfo(QString msg);
-    void triggerRegisterRead();
+    void handleConnectionReady(quint8 connectionId, bool bReady);
 
 private:
 
+    void startPolling(QList<ModbusRegister> registerList, QList<quint32> pollIntervalList);
+    void stopPolling();
+    QList<quint8> createPollGroups(QList<ModbusRegister>& registerList, QList<quint32> pollIntervalList);
+    void updateConnectionCount();
+    void updateBusArbiters();
+    QString busKey(quint8 connectionId);
+    void addModbusMaster(quint8 connectionId);
+    void triggerRegisterRead(quint8 connectionId);
+    void startWaitingConnections();
+    void scheduleNextPoll(quint8 connectionId);
+    void startPollTimeline(quint8 connectionId);
+    void updateCircuitBreaker(quint8 connectionId, bool bReadFailed);
+
     QList<ModbusMasterData *> _modbusMasters;
-    quint32 _activeMastersCount;
 
-    bool _bPollActive;
-    QTimer * _pPollTimer;
-    qint64 _lastPollStart;
+    /* Serial ports and TCP gateways that are shared by multiple connections, by bus key */
+    QHash<QString, BusArbiter *> _busArbiters;
+
+    /* Number of connections with an active poll and connections waiting for a free slot (concurrency limit) */
+    quint32 _activeCount{};
+    QQueue<quint8> _waitingConnections;
+
+    /* Connections that are opened ahead of the first poll */
+    QSet<quint8> _warmUpConnections;
+
+    /* Applied to connections that are added later */
+    DeviceProfileStore * _pDeviceProfileStore{nullptr};
+    PollScheduler::OverrunPolicy _overrunPolicy{PollScheduler::OverrunPolicy::SKIP};
+
+    /* Read from the GUI thread, written in the communication thread */
+    std::atomic<bool> _bPollActive;
+
+    /* Registers that are read, also applied when polling starts (all registers when empty) */
+    QList<bool> _demandList;
+
+    /* Poll interval of every poll group, and its period (in ns) */
+    QList<quint32> _groupIntervals;
+    QList<qint64> _groupPeriods;
+
+    /* Monotonic clock of the poll schedules */
+    QElapsedTimer _pollClock;
 
     RegisterValueHandler* _pRegisterValueHandler;
 
+    /* Settings of the GUI, only used to take a snapshot when communication starts */
     SettingsModel * _pSettingsModel;
+
+    /* Constant copy of the settings during a log session */
+    SettingsModel * _pSettingsSnapshot;
 };
 
 #endif // COMMUNICATION_MANAGER_H
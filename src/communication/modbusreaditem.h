@@ -0,0 +1,54 @@
+#ifndef MODBUSREADITEM_H
+#define MODBUSREADITEM_H
+
+#include <QList>
+
+#include "modbusaddress.h"
+
+class ModbusReadItem
+{
+public:
+    ModbusReadItem(ModbusAddress address, quint16 count) :
+        _address(address), _count(count)
+    {
+    }
+
+    ModbusAddress address(void) const { return _address; }
+    quint16 count(void) const { return _count; }
+
+    /* Coils and discrete inputs are read as bits */
+    static bool isBitType(ModbusAddress::ObjectType type)
+    {
+        return (type == ModbusAddress::ObjectType::COIL) || (type == ModbusAddress::ObjectType::DISCRETE_INPUT);
+    }
+
+    /* Limit of the read function code of an object type */
+    static quint16 maxCount(ModbusAddress::ObjectType type)
+    {
+        return isBitType(type) ? cMaxBitCount : cMaxRegisterCount;
+    }
+
+    /*
+     * The native engine passes bits packed in 16-bit words: bit i is bit (i % 16) of word (i / 16),
+     * the same order as in the response of the device. Qt's client passes a value per bit.
+     */
+    static qsizetype packedSize(qsizetype bitCount)
+    {
+        return (bitCount + 15) / 16;
+    }
+
+    static quint16 packedBit(const QList<quint16>& packedList, qsizetype idx)
+    {
+        return (packedList[idx / 16] >> (idx % 16)) & 0x1;
+    }
+
+    static constexpr quint16 cMaxRegisterCount = 125;
+    static constexpr quint16 cMaxBitCount = 2000;
+
+private:
+    ModbusAddress _address{0, ModbusAddress::ObjectType::UNKNOWN};
+    quint16 _count{};
+
+};
+
+#endif // MODBUSREADITEM_H
@@ -0,0 +1,732 @@
+
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QtSerialPort/QSerialPort>
+#include <QtMath>
+
+#include "scopelogging.h"
+#include "acquisitionclock.h"
+#include "nativemodbusconnection.h"
+
+using ParseResult = ModbusFrameCodec::ParseResult;
+
+/*!
+ * Constructor for NativeModbusConnection
+ * The request list and receive buffer are allocated once, so sending a request and handling its
+ * response doesn't allocate memory (apart from the values that are passed with the result).
+ */
+NativeModbusConnection::NativeModbusConnection(QObject *parent) :
+    ModbusConnection(parent), _connectionTimer(this), _requestTimer(this), _interFrameTimer(this)
+{
+    _connectionTimer.setSingleShot(true);
+
+    _requestTimer.setSingleShot(true);
+    _requestTimer.setTimerType(Qt::PreciseTimer);
+
+    _interFrameTimer.setSingleShot(true);
+    _interFrameTimer.setTimerType(Qt::PreciseTimer);
+
+    connect(&_connectionTimer, &QTimer::timeout, this, &NativeModbusConnection::connectionTimeOut);
+    connect(&_requestTimer, &QTimer::timeout, this, &NativeModbusConnection::requestTimeOut);
+    connect(&_interFrameTimer, &QTimer::timeout, this, &NativeModbusConnection::sendNextRtuRequest);
+
+    _requests.reserve(_cMaxRequestCount);
+    _rxBuffer.reserve(_cRxBufferSize);
+}
+
+NativeModbusConnection::~NativeModbusConnection()
+{
+    releaseDevice();
+}
+
+/*!
+ * Start opening of TCP connection
+ * Emits signals (\ref connectionSuccess, \ref connectionError) when connection is ready or failed
+ *
+ * \param[in]   tcpSettings     TCP setting for server
+ * \param[in]   timeout         Timeout of connection and requests (in milliseconds)
+ */
+void NativeModbusConnection::openTcpConnection(struct TcpSettings tcpSettings, quint32 timeout)
+{
+    if (prepareOpen())
+    {
+        auto pSocket = new QTcpSocket(this);
+
+        /* Requests are small and latency matters: don't wait to combine them */
+        pSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        _transport = Transport::TCP;
+
+        connect(pSocket, &QTcpSocket::connected, this, &NativeModbusConnection::handleConnected);
+        connect(pSocket, &QTcpSocket::errorOccurred, this, &NativeModbusConnection::handleDeviceError);
+        connect(pSocket, &QTcpSocket::disconnected, this, &NativeModbusConnection::handleDeviceError);
+
+        startOpen(pSocket, timeout);
+
+        pSocket->connectToHost(tcpSettings.ip, static_cast<quint16>(tcpSettings.port));
+    }
+}
+
+/*!
+ * Open serial connection
+ * Emits signals (\ref connectionSuccess, \ref connectionError) when connection is ready or failed
+ *
+ * \param[in]   serialSettings  Serial setting for server
+ * \param[in]   timeout         Timeout of requests (in milliseconds)
+ */
+void NativeModbusConnection::openSerialConnection(struct SerialSettings serialSettings, quint32 timeout)
+{
+    if (prepareOpen())
+    {
+        auto pSerialPort = new QSerialPort(this);
+
+        pSerialPort->setPortName(serialSettings.portName);
+        pSerialPort->setParity(serialSettings.parity);
+        pSerialPort->setBaudRate(serialSettings.baudrate);
+        pSerialPort->setDataBits(serialSettings.databits);
+        pSerialPort->setStopBits(serialSettings.stopbits);
+
+        const quint32 interFrameDelay = serialSettings.interFrameDelay != 0 ? serialSettings.interFrameDelay
+                                                                            : defaultInterFrameDelay(serialSettings.baudrate);
+        _interFrameDelay = qMax(qCeil(static_cast<double>(interFrameDelay) / 1000), 1);
+
+        _transport = Transport::RTU;
+
+        connect(pSerialPort, &QSerialPort::errorOccurred, this, &NativeModbusConnection::handleDeviceError);
+
+        startOpen(pSerialPort, timeout);
+
+        if (pSerialPort->open(QIODevice::ReadWrite))
+        {
+            pSerialPort->clear();
+            handleConnected();
+        }
+        else
+        {
+            failConnection(QString("Connect failed: %0").arg(pSerialPort->errorString()));
+        }
+    }
+}
+
+/*!
+ * Start opening of UDP connection
+ * UDP has no connection setup: the connection is ready as soon as the address of the server is resolved.
+ * Every request and response is a single datagram with the MBAP header of Modbus TCP. Lost datagrams
+ * are detected by the request timeout and handled by the retries.
+ * Emits signals (\ref connectionSuccess, \ref connectionError) when connection is ready or failed
+ *
+ * \param[in]   udpSettings     UDP setting for server
+ * \param[in]   timeout         Timeout of connection and requests (in milliseconds)
+ */
+void NativeModbusConnection::openUdpConnection(struct TcpSettings udpSettings, quint32 timeout)
+{
+    if (prepareOpen())
+    {
+        auto pSocket = new QUdpSocket(this);
+
+        _transport = Transport::UDP;
+
+        connect(pSocket, &QUdpSocket::connected, this, &NativeModbusConnection::handleConnected);
+        connect(pSocket, &QUdpSocket::errorOccurred, this, &NativeModbusConnection::handleDeviceError);
+
+        startOpen(pSocket, timeout);
+
+        /* Only datagrams of the server are received on a connected socket */
+        pSocket->connectToHost(udpSettings.ip, static_cast<quint16>(udpSettings.port));
+    }
+}
+
+/*!
+ *  Close connection
+ *  Outstanding requests are dropped without result
+ */
+void NativeModbusConnection::closeConnection(void)
+{
+    _lingerTimer.stop();
+
+    if (_pDevice != nullptr)
+    {
+        qCDebug(scopeCommConnection) << "Connection close: " << _pDevice;
+    }
+
+    releaseDevice();
+}
+
+/*!
+ * Keep idle connection open for a while, so a next read doesn't need to open a new connection
+ * \param[in]   lingerTime      Linger time (in milliseconds), 0 closes the connection immediately
+ */
+void NativeModbusConnection::lingerConnection(quint32 lingerTime)
+{
+    if ((lingerTime == 0) || !isConnected())
+    {
+        closeConnection();
+    }
+    else
+    {
+        qCDebug(scopeCommConnection) << "Connection linger: " << _pDevice;
+        _lingerTimer.start(static_cast<int>(lingerTime));
+    }
+}
+
+/*!
+ * Send read request over connection
+ * TCP and UDP requests are sent immediately and matched on transaction ID. RTU requests are queued
+ * and sent one by one, separated by the inter-frame delay.
+ *
+ * \param regAddress        register address
+ * \param size              number of registers (or bits for coils and discrete inputs)
+ * \param serverAddress     slave address
+ * \param requestId         identity of the request, passed back with its result
+ */
+void NativeModbusConnection::sendReadRequest(ModbusAddress regAddress, quint16 size, int serverAddress, quint32 requestId)
+{
+    if (!isConnected())
+    {
+        emit connectionError(QModbusDevice::ReadError, QString("Not connected"));
+        return;
+    }
+
+    Request request;
+    request.pending.address = regAddress;
+    request.pending.requestId = requestId;
+    request.pending.sendTimestamp = 0;
+    request.pending.timeout = _bAdaptiveTimeout ? _rttEstimator.requestTimeout(_maxTimeout) : _maxTimeout;
+
+    /* RTU requests are timestamped when they are put on the line, so queuing doesn't inflate the round-trip time */
+    request.pending.bRttSample = (_transport == Transport::RTU) || _requests.isEmpty();
+
+    request.serverAddress = serverAddress;
+    request.functionCode = ModbusFrameCodec::functionCode(regAddress.objectType());
+    request.count = size;
+    request.transactionId = _nextTransactionId++;
+    request.retriesLeft = _retries;
+    request.deadline = 0;
+
+    if (_transport != Transport::RTU)
+    {
+        ModbusFrameCodec::buildTcpReadRequest(request.frame, request.transactionId, static_cast<quint8>(serverAddress),
+                                              request.functionCode, regAddress.protocolAddress(), size);
+        request.frameSize = ModbusFrameCodec::cTcpReadRequestSize;
+    }
+    else
+    {
+        ModbusFrameCodec::buildRtuReadRequest(request.frame, static_cast<quint8>(serverAddress),
+                                              request.functionCode, regAddress.protocolAddress(), size);
+        request.frameSize = ModbusFrameCodec::cRtuReadRequestSize;
+    }
+
+    _requests.append(request);
+
+    if (
+        (_transport != Transport::RTU)
+        || ((_requests.size() == 1) && !_interFrameTimer.isActive())
+    )
+    {
+        sendRequest(_requests.last());
+    }
+}
+
+/*!
+ * Forget all outstanding requests
+ * Responses that are still received afterwards are ignored.
+ */
+void NativeModbusConnection::abortPendingRequests(void)
+{
+    if (
+        (_transport == Transport::RTU)
+        && !_requests.isEmpty()
+        && (_requests.first().deadline != 0)
+    )
+    {
+        /* Response of the request on the line can still arrive: keep the line reserved until its deadline */
+        const qint64 remaining = qMax(_requests.first().deadline - AcquisitionClock::timestamp(), static_cast<qint64>(0));
+        _interFrameTimer.start(static_cast<int>((remaining + 999) / 1000) + _interFrameDelay);
+    }
+
+    _requests.clear();
+    _requestTimer.stop();
+}
+
+/*!
+ *  Return whether connection is ok
+ *
+ * \return Connection state
+ */
+bool NativeModbusConnection::isConnected(void)
+{
+    if ((_pDevice == nullptr) || _bConnecting)
+    {
+        return false;
+    }
+    else if (_transport != Transport::RTU)
+    {
+        return static_cast<QAbstractSocket *>(_pDevice)->state() == QAbstractSocket::ConnectedState;
+    }
+    else
+    {
+        return _pDevice->isOpen();
+    }
+}
+
+/*!
+ * Return silent interval between RTU frames of the Modbus standard
+ * \param baudrate      Baud rate of serial port
+ * \return Inter-frame delay (in µs): 3.5 characters of 11 bits, fixed to 1750 µs above 19200 baud
+ */
+quint32 NativeModbusConnection::defaultInterFrameDelay(qint32 baudrate)
+{
+    if ((baudrate <= 0) || (baudrate > 19200))
+    {
+        return 1750;
+    }
+
+    return static_cast<quint32>(qCeil(3.5 * 11 * 1000000 / baudrate));
+}
+
+void NativeModbusConnection::handleConnected()
+{
+    _connectionTimer.stop();
+    _bConnecting = false;
+
+    emit connectionSuccess();
+}
+
+/*!
+ * Handle error or disconnect of socket or serial port
+ */
+void NativeModbusConnection::handleDeviceError()
+{
+    if ((_pDevice == nullptr) || (QObject::sender() != _pDevice))
+    {
+        return;
+    }
+
+    auto pSerialPort = qobject_cast<QSerialPort *>(_pDevice);
+    if ((pSerialPort != nullptr) && (pSerialPort->error() == QSerialPort::NoError))
+    {
+        return;
+    }
+
+    failConnection(QString("Error: %0").arg(_pDevice->errorString()));
+}
+
+/*!
+ * Handle received bytes
+ * Bytes are read directly into the receive buffer, complete frames are parsed in place
+ */
+void NativeModbusConnection::handleReadyRead()
+{
+    if ((_pDevice == nullptr) || (QObject::sender() != _pDevice))
+    {
+        return;
+    }
+
+    if (_transport == Transport::UDP)
+    {
+        /* Datagrams keep their boundaries, every datagram is a complete frame */
+        processUdpDatagrams();
+        return;
+    }
+
+    const qint64 available = _pDevice->bytesAvailable();
+    if (available > 0)
+    {
+        const qsizetype size = _rxBuffer.size();
+        _rxBuffer.resize(size + available);
+
+        const qint64 readCount = _pDevice->read(_rxBuffer.data() + size, available);
+        _rxBuffer.resize(size + qMax(readCount, static_cast<qint64>(0)));
+    }
+
+    if (_transport == Transport::TCP)
+    {
+        processTcpFrames();
+    }
+    else
+    {
+        processRtuFrame();
+    }
+}
+
+void NativeModbusConnection::connectionTimeOut()
+{
+    failConnection(QString("Connection timeout"));
+}
+
+/*!
+ * Handle requests that passed their deadline
+ * A request is sent again while it has retries left, otherwise it fails with a timeout
+ */
+void NativeModbusConnection::requestTimeOut()
+{
+    const qint64 now = AcquisitionClock::timestamp();
+
+    /* One request at a time: the handler of the error can change the outstanding requests */
+    while (_pDevice != nullptr)
+    {
+        qsizetype expiredIdx = -1;
+        for (qsizetype idx = 0; idx < _requests.size(); idx++)
+        {
+            if ((_requests[idx].deadline != 0) && (_requests[idx].deadline <= now))
+            {
+                expiredIdx = idx;
+                break;
+            }
+        }
+
+        if (expiredIdx == -1)
+        {
+            break;
+        }
+
+        if (_requests[expiredIdx].retriesLeft > 0)
+        {
+            /* Response of a retry is ambiguous, so no round-trip time sample (Karn's algorithm) */
+            _requests[expiredIdx].retriesLeft--;
+            _requests[expiredIdx].pending.bRttSample = false;
+            sendRequest(_requests[expiredIdx]);
+        }
+        else
+        {
+            const Request request = _requests.takeAt(expiredIdx);
+
+            updateRttEstimate(request.pending, QModbusDevice::TimeoutError, now);
+
+            if (_transport == Transport::RTU)
+            {
+                _interFrameTimer.start(_interFrameDelay);
+            }
+
+            emit readRequestError(request.pending.address, QString("Response timeout"), QModbusDevice::TimeoutError, now, request.serverAddress,
+                                  request.pending.requestId);
+        }
+    }
+
+    if (_pDevice != nullptr)
+    {
+        startRequestTimer();
+    }
+}
+
+/*!
+ * Send first queued RTU request, when the line is free
+ */
+void NativeModbusConnection::sendNextRtuRequest()
+{
+    if (
+        (_pDevice != nullptr)
+        && !_requests.isEmpty()
+        && (_requests.first().deadline == 0)
+    )
+    {
+        sendRequest(_requests.first());
+    }
+}
+
+/*!
+ * \brief Prepare for opening a connection
+ * \retval  true        when connection needs to be opened
+ * \retval  false       when connection already opened
+ */
+bool NativeModbusConnection::prepareOpen()
+{
+    /* A lingering connection is reused */
+    _lingerTimer.stop();
+
+    if (isConnected())
+    {
+        qCDebug(scopeCommConnection) << "Connection already open";
+
+        emit connectionSuccess();
+        return false;
+    }
+
+    /* Connection that is still opening or closed by the peer */
+    releaseDevice();
+
+    return true;
+}
+
+void NativeModbusConnection::startOpen(QIODevice* pDevice, quint32 timeout)
+{
+    _pDevice = pDevice;
+    _maxTimeout = timeout;
+    _bConnecting = true;
+
+    connect(_pDevice, &QIODevice::readyRead, this, &NativeModbusConnection::handleReadyRead);
+
+    qCDebug(scopeCommConnection) << "Connection start: " << _pDevice;
+
+    _connectionTimer.start(static_cast<int>(timeout));
+}
+
+/*!
+ * Close socket or serial port and drop all state of the connection
+ * Capacity of the request list and receive buffer is kept
+ */
+void NativeModbusConnection::releaseDevice()
+{
+    _connectionTimer.stop();
+    _requestTimer.stop();
+    _interFrameTimer.stop();
+
+    _requests.clear();
+    _rxBuffer.resize(0);
+    _bConnecting = false;
+
+    if (_pDevice != nullptr)
+    {
+        _pDevice->disconnect(this);
+        _pDevice->close();
+
+        /* Can be called from a signal of the device */
+        _pDevice->deleteLater();
+        _pDevice = nullptr;
+    }
+
+    _transport = Transport::NONE;
+}
+
+/*!
+ * Close connection after an error
+ * The error is only reported while opening or with outstanding requests, an idle connection that is
+ * closed by the peer is opened again by the next read.
+ * \param msg   Error message
+ */
+void NativeModbusConnection::failConnection(QString msg)
+{
+    if (_pDevice == nullptr)
+    {
+        return;
+    }
+
+    qCDebug(scopeCommConnection) << "Connection error:" << msg;
+
+    const bool bReport = _bConnecting || !_requests.isEmpty();
+
+    closeConnection();
+
+    if (bReport)
+    {
+        emit connectionError(QModbusDevice::ConnectionError, msg);
+    }
+}
+
+void NativeModbusConnection::sendRequest(Request& request)
+{
+    if (_transport == Transport::RTU)
+    {
+        /* Bytes of a late response are no part of the response to this request */
+        _rxBuffer.resize(0);
+    }
+
+    request.pending.sendTimestamp = AcquisitionClock::timestamp();
+    request.deadline = request.pending.sendTimestamp + static_cast<qint64>(request.pending.timeout) * 1000;
+
+    _pDevice->write(request.frame, request.frameSize);
+
+    startRequestTimer();
+}
+
+/*!
+ * Start timer for first deadline of the sent requests
+ */
+void NativeModbusConnection::startRequestTimer()
+{
+    qint64 firstDeadline = 0;
+    for (const Request& request : std::as_const(_requests))
+    {
+        if ((request.deadline != 0) && ((firstDeadline == 0) || (request.deadline < firstDeadline)))
+        {
+            firstDeadline = request.deadline;
+        }
+    }
+
+    if (firstDeadline == 0)
+    {
+        _requestTimer.stop();
+    }
+    else
+    {
+        const qint64 remaining = qMax(firstDeadline - AcquisitionClock::timestamp(), static_cast<qint64>(0));
+        _requestTimer.start(static_cast<int>((remaining + 999) / 1000));
+    }
+}
+
+/*!
+ * Handle all complete TCP frames in the receive buffer
+ * Responses are matched on transaction ID and unit ID, responses of dropped requests are ignored
+ */
+void NativeModbusConnection::processTcpFrames()
+{
+    while (_pDevice != nullptr)
+    {
+        const qsizetype frameSize = ModbusFrameCodec::tcpFrameSize(_rxBuffer.constData(), _rxBuffer.size());
+
+        if (frameSize < 0)
+        {
+            failConnection(QString("Invalid response frame"));
+            break;
+        }
+        else if ((frameSize == 0) || (frameSize > _rxBuffer.size()))
+        {
+            /* Wait for rest of frame */
+            break;
+        }
+
+        processMbapFrame(frameSize);
+    }
+}
+
+/*!
+ * Handle all received UDP datagrams
+ * A datagram is read directly into the receive buffer. Truncated or invalid datagrams are dropped, their
+ * request is handled by its timeout (and retries). The connection stays open.
+ */
+void NativeModbusConnection::processUdpDatagrams()
+{
+    auto pSocket = static_cast<QUdpSocket *>(_pDevice);
+
+    /* Handler of a result can close the connection */
+    while ((_pDevice == pSocket) && pSocket->hasPendingDatagrams())
+    {
+        const qint64 datagramSize = qMax(pSocket->pendingDatagramSize(), static_cast<qint64>(0));
+        _rxBuffer.resize(datagramSize);
+
+        const qint64 readCount = pSocket->readDatagram(_rxBuffer.data(), datagramSize);
+        _rxBuffer.resize(qMax(readCount, static_cast<qint64>(0)));
+
+        const qsizetype frameSize = ModbusFrameCodec::tcpFrameSize(_rxBuffer.constData(), _rxBuffer.size());
+        if ((frameSize > 0) && (frameSize == _rxBuffer.size()))
+        {
+            processMbapFrame(frameSize);
+        }
+
+        _rxBuffer.resize(0);
+    }
+}
+
+/*!
+ * Handle frame with MBAP header at the start of the receive buffer
+ * Response is matched on transaction ID and unit ID, responses of dropped requests are ignored
+ * \param frameSize    Size of complete frame
+ */
+void NativeModbusConnection::processMbapFrame(qsizetype frameSize)
+{
+    const qint64 timestamp = AcquisitionClock::timestamp();
+    const quint16 transactionId = ModbusFrameCodec::tcpTransactionId(_rxBuffer.constData());
+    const quint8 unitId = ModbusFrameCodec::tcpUnitId(_rxBuffer.constData());
+
+    qsizetype requestIdx = -1;
+    for (qsizetype idx = 0; idx < _requests.size(); idx++)
+    {
+        if (
+            (_requests[idx].deadline != 0)
+            && (_requests[idx].transactionId == transactionId)
+            && (static_cast<quint8>(_requests[idx].serverAddress) == unitId)
+        )
+        {
+            requestIdx = idx;
+            break;
+        }
+    }
+
+    if (requestIdx == -1)
+    {
+        /* Response of a dropped request, or a duplicate response after a retry */
+        _rxBuffer.remove(0, frameSize);
+        return;
+    }
+
+    const Request request = _requests.takeAt(requestIdx);
+
+    QList<quint16> values;
+    quint8 exceptionCode = 0;
+    const ParseResult result = ModbusFrameCodec::parseReadResponse(_rxBuffer.constData() + ModbusFrameCodec::cMbapHeaderSize,
+                                                                   frameSize - ModbusFrameCodec::cMbapHeaderSize,
+                                                                   request.functionCode, request.count, values, exceptionCode);
+
+    /* Remove frame before passing the result, the handler can close the connection */
+    _rxBuffer.remove(0, frameSize);
+    startRequestTimer();
+
+    finishRequest(request, result, values, exceptionCode, timestamp);
+}
+
+/*!
+ * Handle RTU response in the receive buffer
+ * Only a single request is on the line, so the response belongs to the first request
+ */
+void NativeModbusConnection::processRtuFrame()
+{
+    if (_requests.isEmpty() || (_requests.first().deadline == 0))
+    {
+        /* No request on the line: late response of a dropped request */
+        _rxBuffer.resize(0);
+        return;
+    }
+
+    const qsizetype frameSize = ModbusFrameCodec::rtuFrameSize(_rxBuffer.constData(), _rxBuffer.size());
+    if ((frameSize == 0) || (frameSize > _rxBuffer.size()))
+    {
+        /* Wait for rest of frame */
+        return;
+    }
+
+    const qint64 timestamp = AcquisitionClock::timestamp();
+
+    if (
+        !ModbusFrameCodec::isRtuCrcValid(_rxBuffer.constData(), frameSize)
+        || (static_cast<quint8>(_rxBuffer.at(0)) != static_cast<quint8>(_requests.first().serverAddress))
+    )
+    {
+        /* Corrupted frame or frame of another slave: request is handled by its timeout (and retries) */
+        _rxBuffer.resize(0);
+        return;
+    }
+
+    const Request request = _requests.takeFirst();
+
+    QList<quint16> values;
+    quint8 exceptionCode = 0;
+
+    /* PDU is between slave address and CRC */
+    const ParseResult result = ModbusFrameCodec::parseReadResponse(_rxBuffer.constData() + 1, frameSize - 3,
+                                                                   request.functionCode, request.count, values, exceptionCode);
+
+    _rxBuffer.resize(0);
+    startRequestTimer();
+
+    /* Next request after the silent interval */
+    _interFrameTimer.start(_interFrameDelay);
+
+    finishRequest(request, result, values, exceptionCode, timestamp);
+}
+
+/*!
+ * Pass result of a request
+ * Coils and discrete inputs are passed as packed bits, 16 per word
+ */
+void NativeModbusConnection::finishRequest(const Request& request, ModbusFrameCodec::ParseResult result, const QList<quint16>& values,
+                                           quint8 exceptionCode, qint64 timestamp)
+{
+    if (result == ParseResult::SUCCESS)
+    {
+        updateRttEstimate(request.pending, QModbusDevice::NoError, timestamp);
+
+        emit readRequestSuccess(request.pending.address, values, timestamp, request.serverAddress, request.pending.requestId);
+    }
+    else if (result == ParseResult::EXCEPTION)
+    {
+        updateRttEstimate(request.pending, QModbusDevice::ProtocolError, timestamp);
+
+        emit readRequestProtocolError(request.pending.address, static_cast<QModbusPdu::ExceptionCode>(exceptionCode),
+                                      timestamp, request.serverAddress, request.pending.requestId);
+    }
+    else
+    {
+        emit readRequestError(request.pending.address, QString("Invalid response"), QModbusDevice::UnknownError,
+                              timestamp, request.serverAddress, request.pending.requestId);
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef NATIVEMODBUSCONNECTION_H
+#define NATIVEMODBUSCONNECTION_H
+
+#include <QIODevice>
+#include <QByteArray>
+
+#include "modbusconnection.h"
+#include "modbusframecodec.h"
+
+/*!
+ * Lightweight Modbus client for reading registers over TCP, UDP or RTU
+ * Behaves as a normal \ref ModbusConnection, but talks to the socket or serial port directly: requests are
+ * built into preallocated buffers and responses are parsed in place, without a reply object per request.
+ */
+class NativeModbusConnection : public ModbusConnection
+{
+    Q_OBJECT
+public:
+    explicit NativeModbusConnection(QObject *parent = nullptr);
+    ~NativeModbusConnection();
+
+    void openTcpConnection(struct TcpSettings tcpSettings, quint32 timeout) override;
+    void openSerialConnection(struct SerialSettings serialSettings, quint32 timeout) override;
+    void openUdpConnection(struct TcpSettings udpSettings, quint32 timeout) override;
+    void closeConnection(void) override;
+    void lingerConnection(quint32 lingerTime) override;
+
+    void sendReadRequest(ModbusAddress regAddress, quint16 size, int serverAddress, quint32 requestId = 0) override;
+    void abortPendingRequests(void) override;
+
+    bool isConnected(void) override;
+
+    static quint32 defaultInterFrameDelay(qint32 baudrate);
+
+private slots:
+    void handleConnected();
+    void handleDeviceError();
+    void handleReadyRead();
+
+    void connectionTimeOut();
+    void requestTimeOut();
+    void sendNextRtuRequest();
+
+private:
+
+    enum class Transport
+    {
+        NONE,
+        TCP,
+        UDP,
+        RTU,
+    };
+
+    struct Request
+    {
+        ConnectionData::PendingRequest pending;
+        int serverAddress;
+        quint8 functionCode;
+        quint16 count;
+        quint16 transactionId;
+        quint8 retriesLeft;
+
+        /* Moment the request times out (in µs, see AcquisitionClock), 0 when not sent yet */
+        qint64 deadline;
+
+        /* Request frame, built once and reused for retries */
+        char frame[ModbusFrameCodec::cTcpReadRequestSize];
+        qsizetype frameSize;
+    };
+
+    bool prepareOpen();
+    void startOpen(QIODevice* pDevice, quint32 timeout);
+    void releaseDevice();
+    void failConnection(QString msg);
+
+    void sendRequest(Request& request);
+    void startRequestTimer();
+
+    void processTcpFrames();
+    void processUdpDatagrams();
+    void processMbapFrame(qsizetype frameSize);
+    void processRtuFrame();
+    void finishRequest(const Request& request, ModbusFrameCodec::ParseResult result, const QList<quint16>& values,
+                       quint8 exceptionCode, qint64 timestamp);
+
+    Transport _transport{Transport::NONE};
+    QIODevice* _pDevice{nullptr};
+    bool _bConnecting{false};
+
+    QTimer _connectionTimer;
+    QTimer _requestTimer;
+
+    /* RTU: silent interval between frames (in ms) */
+    QTimer _interFrameTimer;
+    qint32 _interFrameDelay{};
+
+    /* Outstanding requests, in order of sending (RTU: only the first one is on the line) */
+    QList<Request> _requests;
+    quint16 _nextTransactionId{};
+
+    /* Received bytes that aren't handled yet */
+    QByteArray _rxBuffer;
+
+    static constexpr qsizetype _cMaxRequestCount = 32;
+    static constexpr qsizetype _cRxBufferSize = 2048;
+};
+
+#endif // NATIVEMODBUSCONNECTION_H
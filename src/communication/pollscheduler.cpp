@@ -0,0 +1,167 @@
+#include "pollscheduler.h"
+
+/*!
+ * Constructor for PollScheduler
+ * Keeps absolute deadlines for every poll group of a connection. A deadline is always advanced
+ * with the period of the group (instead of restarting from the moment of the poll), so the poll
+ * rate doesn't drift. All times are in ns on a monotonic clock.
+ */
+PollScheduler::PollScheduler()
+{
+
+}
+
+/*!
+ * Start a new schedule, all groups are due immediately
+ * \param groupPeriods  Period of every poll group (in ns)
+ * \param groupMask     Bit mask of groups that are scheduled
+ * \param now           Current time (in ns)
+ */
+void PollScheduler::reset(QList<qint64> groupPeriods, quint64 groupMask, qint64 now)
+{
+    _groupPeriods = groupPeriods;
+    _groupDeadlines = QList<qint64>(_groupPeriods.size(), now);
+    _groupMask = groupMask;
+
+    _referenceGroup = -1;
+    for (qint32 group = 0; group < _groupPeriods.size(); group++)
+    {
+        if (
+            (_groupMask & (static_cast<quint64>(1) << group))
+            && ((_referenceGroup < 0) || (_groupPeriods[group] < _groupPeriods[_referenceGroup]))
+        )
+        {
+            _referenceGroup = group;
+        }
+    }
+
+    resetStatistics();
+}
+
+void PollScheduler::resetStatistics()
+{
+    _pollCount = 0;
+    _missedDeadlines = 0;
+    _referencePollCount = 0;
+    _firstReferencePoll = 0;
+    _lastReferencePoll = 0;
+}
+
+void PollScheduler::setOverrunPolicy(OverrunPolicy policy)
+{
+    _overrunPolicy = policy;
+}
+
+PollScheduler::OverrunPolicy PollScheduler::overrunPolicy() const
+{
+    return _overrunPolicy;
+}
+
+/*!
+ * Return groups of which the deadline has passed and advance their deadline
+ * When a poll starts after the next deadline of a group already passed, the poll is late. With the skip policy,
+ * the passed deadlines are dropped and counted as missed. With the catch up policy, the passed deadlines are
+ * still polled immediately and every late poll is counted as missed.
+ * \param now   Current time (in ns)
+ * \return Bit mask of due groups
+ */
+quint64 PollScheduler::takeDueGroups(qint64 now)
+{
+    quint64 dueGroups = 0;
+
+    for (qint32 group = 0; group < _groupPeriods.size(); group++)
+    {
+        const quint64 groupBit = static_cast<quint64>(1) << group;
+
+        if (!(_groupMask & groupBit) || (_groupDeadlines[group] > now))
+        {
+            continue;
+        }
+
+        const qint64 period = qMax(_groupPeriods[group], static_cast<qint64>(1));
+
+        /* Number of deadlines that passed after the deadline of this poll */
+        const qint64 missed = (now - _groupDeadlines[group]) / period;
+
+        if (_overrunPolicy == OverrunPolicy::SKIP)
+        {
+            /* Passed deadlines are dropped */
+            _missedDeadlines += static_cast<quint32>(missed);
+            _groupDeadlines[group] += (missed + 1) * period;
+        }
+        else
+        {
+            /* Passed deadlines are polled later, so only this poll is late */
+            if (missed > 0)
+            {
+                _missedDeadlines++;
+            }
+            _groupDeadlines[group] += period;
+        }
+
+        dueGroups |= groupBit;
+
+        if (group == _referenceGroup)
+        {
+            if (_referencePollCount == 0)
+            {
+                _firstReferencePoll = now;
+            }
+            _lastReferencePoll = now;
+            _referencePollCount++;
+        }
+    }
+
+    if (dueGroups != 0)
+    {
+        _pollCount++;
+    }
+
+    return dueGroups;
+}
+
+/*!
+ * Return first deadline of all scheduled groups
+ * \return Deadline (in ns), \ref cNoDeadline when no group is scheduled
+ */
+qint64 PollScheduler::nextDeadline() const
+{
+    qint64 deadline = cNoDeadline;
+
+    for (qint32 group = 0; group < _groupDeadlines.size(); group++)
+    {
+        if (
+            (_groupMask & (static_cast<quint64>(1) << group))
+            && ((deadline == cNoDeadline) || (_groupDeadlines[group] < deadline))
+        )
+        {
+            deadline = _groupDeadlines[group];
+        }
+    }
+
+    return deadline;
+}
+
+quint32 PollScheduler::pollCount() const
+{
+    return _pollCount;
+}
+
+quint32 PollScheduler::missedDeadlines() const
+{
+    return _missedDeadlines;
+}
+
+/*!
+ * Return average period between the polls of the fastest group
+ * \return Achieved period (in ns), 0 when not enough polls are done yet
+ */
+qint64 PollScheduler::achievedPeriod() const
+{
+    if (_referencePollCount < 2)
+    {
+        return 0;
+    }
+
+    return (_lastReferencePoll - _firstReferencePoll) / (_referencePollCount - 1);
+}
@@ -0,0 +1,52 @@
+#ifndef POLLSCHEDULER_H
+#define POLLSCHEDULER_H
+
+#include <QList>
+
+class PollScheduler
+{
+public:
+
+    enum class OverrunPolicy
+    {
+        CATCH_UP, /* Missed polls are done as fast as possible, until the schedule is met again */
+        SKIP,     /* Missed polls are dropped, next poll is on the next deadline in the future */
+    };
+
+    PollScheduler();
+
+    void reset(QList<qint64> groupPeriods, quint64 groupMask, qint64 now);
+    void resetStatistics();
+
+    void setOverrunPolicy(OverrunPolicy policy);
+    OverrunPolicy overrunPolicy() const;
+
+    quint64 takeDueGroups(qint64 now);
+    qint64 nextDeadline() const;
+
+    quint32 pollCount() const;
+    quint32 missedDeadlines() const;
+    qint64 achievedPeriod() const;
+
+    static constexpr qint64 cNoDeadline = -1;
+
+private:
+
+    OverrunPolicy _overrunPolicy{OverrunPolicy::SKIP};
+
+    /* Period and absolute deadline of every poll group (in ns on a monotonic clock) */
+    QList<qint64> _groupPeriods;
+    QList<qint64> _groupDeadlines;
+    quint64 _groupMask{};
+
+    /* Fastest group, its poll moments are used for the achieved period */
+    qint32 _referenceGroup{-1};
+    qint64 _firstReferencePoll{};
+    qint64 _lastReferencePoll{};
+    quint32 _referencePollCount{};
+
+    quint32 _pollCount{};
+    quint32 _missedDeadlines{};
+};
+
+#endif // POLLSCHEDULER_H
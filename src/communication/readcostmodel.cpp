@@ -0,0 +1,116 @@
+#include "readcostmodel.h"
+
+#include <QtMath>
+#include <limits>
+
+/*!
+ * Constructor for ReadCostModel
+ * A default model has no request overhead, so gaps are never bridged
+ */
+ReadCostModel::ReadCostModel()
+{
+
+}
+
+ReadCostModel::ReadCostModel(quint32 requestOverhead, double registerCost) :
+    _requestOverhead(requestOverhead), _registerCost(registerCost)
+{
+
+}
+
+/*!
+ * Create cost model for a Modbus TCP connection
+ * The transfer time of the data is small compared to the round trip time of a request
+ * \param roundTripTime     Round trip time of a request (in µs)
+ * \return Cost model
+ */
+ReadCostModel ReadCostModel::tcp(quint32 roundTripTime)
+{
+    /* MBAP header + function code, address and count (request), MBAP header + function code and byte count (response) */
+    const quint32 headerBytes = 12 + 9;
+
+    const quint32 requestOverhead = roundTripTime + (headerBytes * 8 * 1000000) / _cTcpBitRate;
+    const double registerCost = (16 * 1000000.0) / _cTcpBitRate;
+
+    return ReadCostModel(requestOverhead, registerCost);
+}
+
+/*!
+ * Create cost model for a Modbus RTU connection
+ * Every request costs the frame overhead (address, function code, CRC, ...) and the silent interval
+ * after both request and response frame
+ * \param baudrate      Baud rate
+ * \param parity        Parity
+ * \param databits      Number of data bits
+ * \param stopbits      Number of stop bits
+ * \return Cost model
+ */
+ReadCostModel ReadCostModel::serial(QSerialPort::BaudRate baudrate,
+                                    QSerialPort::Parity parity,
+                                    QSerialPort::DataBits databits,
+                                    QSerialPort::StopBits stopbits)
+{
+    double charBits = 1 + static_cast<double>(databits);
+
+    if (parity != QSerialPort::NoParity)
+    {
+        charBits += 1;
+    }
+
+    switch (stopbits)
+    {
+    case QSerialPort::OneAndHalfStop:
+        charBits += 1.5;
+        break;
+    case QSerialPort::TwoStop:
+        charBits += 2;
+        break;
+    case QSerialPort::OneStop:
+    default:
+        charBits += 1;
+        break;
+    }
+
+    const double charTime = charBits * 1000000 / qMax(static_cast<qint32>(baudrate), 1);
+
+    /* Modbus specifies a fixed silent interval above 19200 baud */
+    const double interFrameDelay = baudrate > QSerialPort::Baud19200 ? _cRtuFixedInterFrameDelay : 3.5 * charTime;
+
+    const double requestOverhead = _cRtuFrameOverheadChars * charTime + 2 * interFrameDelay;
+
+    return ReadCostModel(static_cast<quint32>(qCeil(requestOverhead)), 2 * charTime);
+}
+
+/*!
+ * Return fixed cost of a single request
+ * \return Request overhead (in µs)
+ */
+quint32 ReadCostModel::requestOverhead() const
+{
+    return _requestOverhead;
+}
+
+/*!
+ * Return cost of reading one extra register
+ * \return Register cost (in µs)
+ */
+double ReadCostModel::registerCost() const
+{
+    return _registerCost;
+}
+
+/*!
+ * Return the largest number of unused registers that is cheaper to read than to start an extra request
+ * \return Maximum gap size (in registers)
+ */
+quint16 ReadCostModel::maxBridgedGap() const
+{
+    if (_registerCost <= 0)
+    {
+        return 0;
+    }
+
+    const double gap = qFloor(_requestOverhead / _registerCost);
+
+    return static_cast<quint16>(qMin(gap, static_cast<double>(std::numeric_limits<quint16>::max())));
+}
@@ -0,0 +1,40 @@
+#ifndef READCOSTMODEL_H
+#define READCOSTMODEL_H
+
+#include <QSerialPort>
+
+class ReadCostModel
+{
+public:
+    ReadCostModel();
+
+    static ReadCostModel tcp(quint32 roundTripTime);
+    static ReadCostModel serial(QSerialPort::BaudRate baudrate,
+                                QSerialPort::Parity parity,
+                                QSerialPort::DataBits databits,
+                                QSerialPort::StopBits stopbits);
+
+    quint32 requestOverhead() const;
+    double registerCost() const;
+
+    quint16 maxBridgedGap() const;
+
+    /* Round-trip time of a TCP request until it is measured (in µs) */
+    static const quint32 cTcpRoundTripEstimate = 1000;
+
+private:
+    ReadCostModel(quint32 requestOverhead, double registerCost);
+
+    /* Fixed cost of a single request (in µs) */
+    quint32 _requestOverhead{};
+
+    /* Cost of reading one extra 16-bit register (in µs) */
+    double _registerCost{};
+
+    static const quint32 _cTcpBitRate = 10000000;
+
+    static const quint32 _cRtuFrameOverheadChars = 13;
+    static const quint32 _cRtuFixedInterFrameDelay = 1750;
+};
+
+#endif // READCOSTMODEL_H
@@ -1,6 +1,6 @@
 #include "readregisters.h"
 
-using State = ResultState::State;
+#include <algorithm>
 
 ReadRegisters::ReadRegisters()
 {
@@ -9,75 +9,39 @@ ReadRegisters::ReadRegisters()
 
 /*!
  * Load ReadRegisterCollection with register read list
- * \param registerList  Register read list
- * \param consecutiveMax Number of consecutive registers that is allowed to read at once
+ * Registers are combined in a single read when they are of the same object type and fit within
+ * consecutiveMax. Gaps of at most maxBridgedGap unused registers are read along to avoid an extra
+ * request. The results of these unused registers are dropped.
+ * Coils and discrete inputs are read as bits: consecutiveMax doesn't apply to them, a single read
+ * holds up to \ref ModbusReadItem::cMaxBitCount bits and a gap of 16 bits costs the same as a gap of one register.
+ * The device profile further limits the reads: the learned maximum block size is respected, blocks
+ * are built around unreadable ranges and for object types that aren't supported only the first
+ * register is read (to detect when support returns).
+ * The plan is cached and only rebuilt when the register list, the settings or the device profile change.
+ * The result frame is kept along with the plan, only its results are cleared for a new read.
+ * \param registerList     Register read list (sorted)
+ * \param consecutiveMax   Number of consecutive registers that is allowed to read at once
+ * \param maxBridgedGap    Maximum number of unused registers between two registers in a single read
  */
-void ReadRegisters::resetRead(QList<ModbusAddress> registerList, quint16 consecutiveMax)
+void ReadRegisters::resetRead(QList<ModbusAddress> registerList, quint16 consecutiveMax, quint16 maxBridgedGap)
 {
-    _resultMap.clear();
+    _inFlightList.clear();
+    _successList.clear();
 
-    if (registerList.size() == 0)
+    if (!isPlanValid(registerList, consecutiveMax, maxBridgedGap))
     {
-        _readItemList.clear();
-    }
+        compilePlan(registerList, consecutiveMax, maxBridgedGap);
 
-    while(registerList.size() > 0)
+        _requestedList = _plan.requestedList;
+        _resultFrame = ModbusResultFrame(_requestedList);
+    }
+    else
     {
-        if (
-            (registerList.size() == 1)
-            || (consecutiveMax == 1)
-        )
-        {
-            // Only single reads allowed
-            _readItemList.append(ModbusReadItem(registerList.first(), 1));
-
-            registerList.removeFirst();
-        }
-        else
-        {
-            int currentIdx = 0;
-
-            bool bSubsequent = false;
-            do
-            {
-
-                // if next is current + 1, dan subsequent = true
-                if (registerList.at(currentIdx).next() == registerList.at(currentIdx + 1))
-                {
-                    bSubsequent = true;
-                    currentIdx++;
-                }
-                else
-                {
-                    bSubsequent = false;
-                }
-
-                // Break loop when end of list
-                if (currentIdx >= (registerList.size() - 1))
-                {
-                    break;
-                }
-
-                // Limit number of register in 1 read
-                if ((currentIdx + 1) >= consecutiveMax)
-                {
-                    break;
-                }
-
-            } while(bSubsequent == true);
-
-
-            // Convert idx to count
-            quint8 count = static_cast<quint8>(currentIdx) + 1;
-
-            _readItemList.append(ModbusReadItem(registerList.first(), count));
-
-            for (int idx = 0; idx < count; idx++)
-            {
-                registerList.removeFirst();
-            }
-        }
+        /* Same requested registers, so only the results of the previous read are cleared */
+        _resultFrame.reset();
     }
+
+    _readItemList = _plan.readItemList;
 }
 
 /*!
@@ -107,84 +71,550 @@ ModbusReadItem ReadRegisters::next()
 }
 
 /*!
- * Add success result for current ReadRegister cluster
+ * Take next ModbusReadItem and mark it as in flight
+ * The result of an in flight item can be added in any order (\ref addSuccess, \ref addError)
+ * \return next ModbusReadItem (item with count 0 when no item available)
+ */
+ModbusReadItem ReadRegisters::takeNext()
+{
+    if (hasNext())
+    {
+        ModbusReadItem readItem = _readItemList.takeFirst();
+        _inFlightList.append(readItem);
+
+        return readItem;
+    }
+    else
+    {
+        return ModbusReadItem(ModbusAddress(0), 0);
+    }
+}
+
+/*!
+ * Return number of ModbusReadItems that are in flight
+ * \return Number of in flight items
+ */
+qint32 ReadRegisters::inFlightCount()
+{
+    return _inFlightList.size();
+}
+
+/*!
+ * Get in flight ModbusReadItem based on start register
  * \param startRegister     Start register address
- * \param registerDataList  List with result data
+ * \return in flight ModbusReadItem (item with count 0 when not in flight)
+ */
+ModbusReadItem ReadRegisters::inFlightItem(ModbusAddress startRegister)
+{
+    const qint32 inFlightIdx = findInFlight(startRegister);
+    if (inFlightIdx != -1)
+    {
+        return _inFlightList.at(inFlightIdx);
+    }
+    else
+    {
+        return ModbusReadItem(ModbusAddress(0), 0);
+    }
+}
+
+/*!
+ * Add success result for ReadRegister cluster
+ * An in flight item with matching start register is handled first, otherwise the "next" item is used
+ * When the reply contains less data than requested, the item is added as error
+ * \param startRegister     Start register address
+ * \param registerDataList  List with result data. Coils and discrete inputs are either packed (\ref ModbusReadItem::packedBit)
+ *                          or a value per bit, the layout follows from the size of the list
  */
 void ReadRegisters::addSuccess(ModbusAddress startRegister, QList<quint16> registerDataList)
 {
-    if (
-        hasNext()
-        && (next().address() == startRegister)
-        && (registerDataList.size() >= next().count())
-    )
+    const qint32 inFlightIdx = findInFlight(startRegister);
+    QList<ModbusReadItem>* pItemList;
+    qint32 itemIdx;
+
+    if (inFlightIdx != -1)
+    {
+        pItemList = &_inFlightList;
+        itemIdx = inFlightIdx;
+    }
+    else if (hasNext() && (next().address() == startRegister))
+    {
+        pItemList = &_readItemList;
+        itemIdx = 0;
+    }
+    else
     {
-        for (qint32 i = 0; i < next().count(); i++)
+        return;
+    }
+
+    ModbusReadItem readItem = pItemList->at(itemIdx);
+    const bool bBits = ModbusReadItem::isBitType(startRegister.objectType());
+    const qsizetype dataSize = bBits ? ModbusReadItem::packedSize(readItem.count()) : readItem.count();
+
+    /* Both layouts are the same for a single bit, otherwise a packed list is always shorter */
+    const bool bPacked = bBits && (registerDataList.size() < readItem.count());
+
+    if (registerDataList.size() >= dataSize)
+    {
+        /* Slots are sorted, so the registers of the item are matched in a single pass */
+        qint32 slot = firstSlot(startRegister);
+        for (qint32 i = 0; (i < readItem.count()) && (slot < _resultFrame.size()); i++)
         {
             const auto registerAddr = startRegister.next(i);
-            const auto result = Result<quint16>(registerDataList[i], State::SUCCESS);
 
-            _resultMap.insert(registerAddr, result);
+            while ((slot < _resultFrame.size()) && (_resultFrame.address(slot) == registerAddr))
+            {
+                _resultFrame.setValue(slot, bPacked ? ModbusReadItem::packedBit(registerDataList, i) : registerDataList[i]);
+                slot++;
+            }
         }
 
-        _readItemList.removeFirst();
+        /* Registers are readable after all */
+        _deviceProfile.removeReadableRanges(readItem);
+        _deviceProfile.setSupported(readItem.address().objectType(), true);
+
+        _successList.append(readItem);
+
+        pItemList->removeAt(itemIdx);
+    }
+    else
+    {
+        /* Incomplete reply: item is finished with errors, otherwise the read would wait for it forever */
+        addErrorResults(pItemList->takeAt(itemIdx));
     }
 }
 
 /*!
- * Add error result for current ReadRegister cluster
+ * Add error result for in flight ReadRegister cluster
+ * \param startRegister     Start register address of in flight item
  */
-void ReadRegisters::addError()
+void ReadRegisters::addError(ModbusAddress startRegister)
 {
-    if (hasNext())
+    const qint32 inFlightIdx = findInFlight(startRegister);
+    if (inFlightIdx != -1)
+    {
+        addErrorResults(_inFlightList.takeAt(inFlightIdx));
+    }
+}
+
+/*!
+ * Mark all remaining and in flight register as errors
+ */
+void ReadRegisters::addAllErrors()
+{
+    while(!_inFlightList.isEmpty())
+    {
+        addErrorResults(_inFlightList.takeFirst());
+    }
+
+    while(hasNext())
+    {
+        addErrorResults(_readItemList.takeFirst());
+    }
+}
+
+/*!
+ * Split in flight ModbusReadItem in two halves
+ * Each half only spans requested registers. Both halves are added in front of the remaining items.
+ * Repeatedly splitting a failing half isolates an unreadable register in O(log n) reads.
+ * \param startRegister     Start register address of in flight item
+ */
+void ReadRegisters::splitInHalf(ModbusAddress startRegister)
+{
+    const qint32 inFlightIdx = findInFlight(startRegister);
+    if (inFlightIdx != -1)
     {
-        auto nextRequestData = next();
-        for (quint32 i = 0; i < nextRequestData.count(); i++)
+        ModbusReadItem readItem = _inFlightList.takeAt(inFlightIdx);
+        const QList<ModbusAddress> requestedList = requestedRegisters(readItem);
+
+        if (requestedList.size() > 1)
         {
-            const auto registerAddr = nextRequestData.address().next(i);
-            const auto result = Result<quint16>(0, State::INVALID);
+            const qint32 half = requestedList.size() / 2;
 
-            _resultMap.insert(registerAddr, result);
+            _readItemList.prepend(spanningItem(requestedList.mid(half)));
+            _readItemList.prepend(spanningItem(requestedList.mid(0, half)));
+        }
+        else if (requestedList.size() == 1)
+        {
+            _readItemList.prepend(ModbusReadItem(requestedList.first(), 1));
         }
+        else
+        {
+            // Nothing requested in item
+        }
+    }
+}
 
-        _readItemList.removeFirst();
+/*!
+ * Remember that in flight ModbusReadItem contains at least one register that can't be read
+ * Future reads will not combine registers into a block that contains this range.
+ * \param startRegister     Start register address of in flight item
+ */
+void ReadRegisters::markUnreadable(ModbusAddress startRegister)
+{
+    const qint32 inFlightIdx = findInFlight(startRegister);
+    if (inFlightIdx != -1)
+    {
+        _deviceProfile.addUnreadableRange(_inFlightList.at(inFlightIdx));
     }
 }
 
 /*!
- * Mark all remaining register as errors
+ * Remember that the object type of in flight ModbusReadItem can't be read
+ * The in flight item and the remaining items of the same object type are added as errors.
+ * \param startRegister     Start register address of in flight item
  */
-void ReadRegisters::addAllErrors()
+void ReadRegisters::markUnsupported(ModbusAddress startRegister)
 {
-    while(hasNext())
+    const qint32 inFlightIdx = findInFlight(startRegister);
+    if (inFlightIdx != -1)
     {
-        addError();
+        const auto type = startRegister.objectType();
+
+        _deviceProfile.setSupported(type, false);
+
+        addErrorResults(_inFlightList.takeAt(inFlightIdx));
+
+        for (qint32 idx = _readItemList.size() - 1; idx >= 0; idx--)
+        {
+            if (_readItemList[idx].address().objectType() == type)
+            {
+                addErrorResults(_readItemList.takeAt(idx));
+            }
+        }
     }
 }
 
 /*!
- * Split "next" ModbusReadItem into single reads.
+ * Learn maximum block size from unreadable ranges of which all registers were read successfully
+ * in smaller blocks. Such a range doesn't contain an unreadable register, but is too large for the device.
+ * Should be called when all reads are finished.
  */
-void ReadRegisters::splitNextToSingleReads()
+void ReadRegisters::learnReadLimits()
 {
-    if (hasNext())
+    const QList<ModbusReadItem> unreadableList = _deviceProfile.unreadableList();
+
+    for (const ModbusReadItem& range : unreadableList)
     {
-        ModbusReadItem firstItem = _readItemList.first();
+        if (range.count() <= 1)
+        {
+            continue;
+        }
 
-        _readItemList.removeFirst();
+        bool bAllReadable = true;
+        for (quint32 i = 0; i < range.count(); i++)
+        {
+            const auto registerAddr = range.address().next(i);
+
+            const qint32 slot = _resultFrame.slot(registerAddr);
+            if (
+                (slot == ModbusResultFrame::cNoSlot)
+                || !_resultFrame.isValid(slot)
+            )
+            {
+                bAllReadable = false;
+                break;
+            }
+        }
 
-        for(int idx = firstItem.count(); idx > 0; idx--)
+        if (bAllReadable)
         {
-            _readItemList.prepend(ModbusReadItem(firstItem.address().next(idx - 1), 1));
+            /* Largest successful block within range is known to be readable */
+            quint16 readableCount = range.count() / 2;
+            for (const ModbusReadItem& successItem : std::as_const(_successList))
+            {
+                if (DeviceProfile::isRangeInItem(successItem, range))
+                {
+                    readableCount = qMax(readableCount, static_cast<quint16>(successItem.count()));
+                }
+            }
+
+            readableCount = qMax(readableCount, static_cast<quint16>(1));
+            if (ModbusReadItem::isBitType(range.address().objectType()))
+            {
+                _deviceProfile.limitBitBlockSize(readableCount);
+            }
+            else
+            {
+                _deviceProfile.limitBlockSize(readableCount);
+            }
+            _deviceProfile.removeUnreadableRange(range);
         }
     }
 }
 
+/*!
+ * Count successful poll in the device profile, so learned limits are probed again after a while
+ * (see \ref DeviceProfile::addSuccessfulPoll)
+ */
+void ReadRegisters::addSuccessfulPoll()
+{
+    _deviceProfile.addSuccessfulPoll();
+}
+
+/*!
+ * Set device profile that is used to plan the reads
+ * \param deviceProfile     Device profile
+ */
+void ReadRegisters::setDeviceProfile(DeviceProfile deviceProfile)
+{
+    _deviceProfile = deviceProfile;
+
+    /* Revision of other profile isn't related */
+    _plan.bValid = false;
+}
+
+/*!
+ * Return device profile, including what is learned during the reads
+ * \return Device profile
+ */
+DeviceProfile ReadRegisters::deviceProfile()
+{
+    return _deviceProfile;
+}
+
+/*!
+ * Return results of the requested registers
+ * \return Result frame
+ */
+ModbusResultFrame ReadRegisters::resultFrame()
+{
+    return _resultFrame;
+}
+
 /*!
  * Return result map
  * \return Result map
  */
 ModbusResultMap ReadRegisters::resultMap()
 {
-    return _resultMap;
+    return _resultFrame.toResultMap();
+}
+
+/*!
+ * Find in flight item based on start register
+ * \param startRegister     Start register address
+ * \retval -1       Not found
+ * \retval != -1    Index in in flight list
+ */
+qint32 ReadRegisters::findInFlight(ModbusAddress startRegister)
+{
+    for (qint32 idx = 0; idx < _inFlightList.size(); idx++)
+    {
+        if (_inFlightList[idx].address() == startRegister)
+        {
+            return idx;
+        }
+    }
+
+    return -1;
+}
+
+/*!
+ * Return whether register is part of the requested register list (and not only read to bridge a gap)
+ * \param address   Register address
+ * \retval true     Register is requested
+ * \retval false    Register is not requested
+ */
+bool ReadRegisters::isRequested(ModbusAddress address)
+{
+    return std::binary_search(_requestedList.cbegin(), _requestedList.cend(), address);
+}
+
+/*!
+ * Return requested registers in a ModbusReadItem
+ * \param readItem  Read item
+ * \return List with requested registers
+ */
+QList<ModbusAddress> ReadRegisters::requestedRegisters(ModbusReadItem readItem)
+{
+    QList<ModbusAddress> requestedList;
+
+    for (quint32 i = 0; i < readItem.count(); i++)
+    {
+        const auto registerAddr = readItem.address().next(i);
+
+        if (isRequested(registerAddr))
+        {
+            requestedList.append(registerAddr);
+        }
+    }
+
+    return requestedList;
+}
+
+/*!
+ * Create ModbusReadItem that spans from first to last register of a sorted list
+ * \param registerList  Sorted register list (not empty)
+ * \return Read item
+ */
+ModbusReadItem ReadRegisters::spanningItem(QList<ModbusAddress> registerList)
+{
+    const quint32 count = static_cast<quint32>(registerList.last().protocolAddress() - registerList.first().protocolAddress()) + 1;
+
+    return ModbusReadItem(registerList.first(), static_cast<quint16>(count));
+}
+
+/*!
+ * Return whether cached read plan can be reused for register list
+ * The register list of a poll is compiled once, so the lists normally share their data and
+ * the comparison doesn't need to check every address
+ * \retval true     Plan is still valid
+ * \retval false    Plan needs to be rebuilt
+ */
+bool ReadRegisters::isPlanValid(const QList<ModbusAddress>& registerList, quint16 consecutiveMax, quint16 maxBridgedGap)
+{
+    return _plan.bValid
+           && (_plan.consecutiveMax == consecutiveMax)
+           && (_plan.maxBridgedGap == maxBridgedGap)
+           && (_plan.profileRevision == _deviceProfile.revision())
+           && (_plan.registerList == registerList);
+}
+
+/*!
+ * Build read plan of register list
+ * \param registerList     Register read list (sorted)
+ * \param consecutiveMax   Number of consecutive registers that is allowed to read at once
+ * \param maxBridgedGap    Maximum number of unused registers between two registers in a single read
+ */
+void ReadRegisters::compilePlan(QList<ModbusAddress> registerList, quint16 consecutiveMax, quint16 maxBridgedGap)
+{
+    _plan = ReadPlan();
+    _plan.bValid = true;
+    _plan.registerList = registerList;
+    _plan.consecutiveMax = consecutiveMax;
+    _plan.maxBridgedGap = maxBridgedGap;
+    _plan.profileRevision = _deviceProfile.revision();
+
+    /* A sorted list keeps sharing its data with the list of the caller */
+    _plan.requestedList = registerList;
+    if (!std::is_sorted(_plan.requestedList.cbegin(), _plan.requestedList.cend()))
+    {
+        std::sort(_plan.requestedList.begin(), _plan.requestedList.end());
+    }
+
+    /* Don't read unsupported object types, except for first register */
+    QList<ModbusAddress::ObjectType> probedTypes;
+    for (qint32 idx = registerList.size() - 1; idx >= 0; idx--)
+    {
+        const auto type = registerList.at(idx).objectType();
+        if (!_deviceProfile.isSupported(type))
+        {
+            const bool bFirstOfType = (idx == 0) || (registerList.at(idx - 1).objectType() != type);
+            if (!bFirstOfType || probedTypes.contains(type))
+            {
+                registerList.removeAt(idx);
+            }
+            else
+            {
+                probedTypes.append(type);
+            }
+        }
+    }
+
+    qint32 idx = 0;
+    while (idx < registerList.size())
+    {
+        const ModbusAddress startAddress = registerList.at(idx);
+        const quint32 maxCount = maxItemCount(startAddress.objectType(), consecutiveMax);
+        const bool bBits = ModbusReadItem::isBitType(startAddress.objectType());
+
+        /* A register holds 16 bits, so a gap of 16 bits costs the same as a gap of a single register */
+        const quint32 maxGap = bBits ? static_cast<quint32>(maxBridgedGap) * 16 : maxBridgedGap;
+
+        quint32 count = 1;
+
+        while ((idx + 1) < registerList.size())
+        {
+            const ModbusAddress currentAddress = registerList.at(idx);
+            const ModbusAddress nextAddress = registerList.at(idx + 1);
+
+            if (
+                (nextAddress.objectType() != startAddress.objectType())
+                || (nextAddress.protocolAddress() <= currentAddress.protocolAddress())
+            )
+            {
+                break;
+            }
+
+            const quint32 gap = static_cast<quint32>(nextAddress.protocolAddress() - currentAddress.protocolAddress()) - 1;
+            const quint32 newCount = static_cast<quint32>(nextAddress.protocolAddress() - startAddress.protocolAddress()) + 1;
+
+            if (
+                (gap > maxGap)
+                || (newCount > maxCount)
+                || _deviceProfile.containsUnreadableRange(ModbusReadItem(startAddress, static_cast<quint16>(newCount)))
+            )
+            {
+                break;
+            }
+
+            count = newCount;
+            idx++;
+        }
+
+        _plan.readItemList.append(ModbusReadItem(startAddress, static_cast<quint16>(count)));
+
+        idx++;
+    }
+}
+
+/*!
+ * Return maximum number of objects in a single read of an object type
+ * The limit of the function code is further limited by the settings (registers only) and the device profile
+ * \param type             Object type
+ * \param consecutiveMax   Number of consecutive registers that is allowed to read at once
+ * \return Maximum count (at least 1)
+ */
+quint32 ReadRegisters::maxItemCount(ModbusAddress::ObjectType type, quint16 consecutiveMax) const
+{
+    quint32 maxCount = ModbusReadItem::maxCount(type);
+    quint16 maxBlockSize;
+
+    if (ModbusReadItem::isBitType(type))
+    {
+        maxBlockSize = _deviceProfile.maxBitBlockSize();
+    }
+    else
+    {
+        maxCount = qBound(static_cast<quint32>(1), static_cast<quint32>(consecutiveMax), maxCount);
+        maxBlockSize = _deviceProfile.maxBlockSize();
+    }
+
+    if (maxBlockSize > 0)
+    {
+        maxCount = qMin(maxCount, static_cast<quint32>(maxBlockSize));
+    }
+
+    return maxCount;
+}
+
+/*!
+ * Add error result for all registers of a ModbusReadItem
+ * \param readItem  Read item
+ */
+void ReadRegisters::addErrorResults(ModbusReadItem readItem)
+{
+    qint32 slot = firstSlot(readItem.address());
+    for (quint32 i = 0; (i < readItem.count()) && (slot < _resultFrame.size()); i++)
+    {
+        const auto registerAddr = readItem.address().next(i);
+
+        while ((slot < _resultFrame.size()) && (_resultFrame.address(slot) == registerAddr))
+        {
+            _resultFrame.setError(slot);
+            slot++;
+        }
+    }
+}
+
+/*!
+ * Return first slot of the result frame with an address that isn't lower than address
+ * \param address  Register address
+ * \return Slot (size of frame when all addresses are lower)
+ */
+qint32 ReadRegisters::firstSlot(ModbusAddress address)
+{
+    const QList<ModbusAddress>& addressList = _resultFrame.addressList();
+
+    return static_cast<qint32>(std::lower_bound(addressList.cbegin(), addressList.cend(), address) - addressList.cbegin());
 }
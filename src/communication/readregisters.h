@@ -4,48 +4,79 @@
 #include <QObject>
 
 #include "modbusresultmap.h"
-
-class ModbusReadItem
-{
-public:
-    ModbusReadItem(ModbusAddress address, quint8 count) :
-        _address(address), _count(count)
-    {
-    }
-
-    ModbusAddress address(void) { return _address; }
-    quint8 count(void) { return _count; }
-
-private:
-    ModbusAddress _address{0, ModbusAddress::ObjectType::UNKNOWN};
-    quint8 _count{};
-
-};
-
+#include "modbusresultframe.h"
+#include "modbusreaditem.h"
+#include "deviceprofile.h"
 
 class ReadRegisters
 {
 public:
     ReadRegisters();
 
-    void resetRead(QList<ModbusAddress> registerList, quint16 consecutiveMax);
+    void resetRead(QList<ModbusAddress> registerList, quint16 consecutiveMax, quint16 maxBridgedGap = 0);
 
     bool hasNext();
     ModbusReadItem next();
 
+    ModbusReadItem takeNext();
+    qint32 inFlightCount();
+    ModbusReadItem inFlightItem(ModbusAddress startRegister);
+
     void addSuccess(ModbusAddress startRegister, QList<quint16> registerDataList);
-    void addError();
+    void addError(ModbusAddress startRegister);
     void addAllErrors();
-    void splitNextToSingleReads();
+    void splitInHalf(ModbusAddress startRegister);
+
+    void markUnreadable(ModbusAddress startRegister);
+    void markUnsupported(ModbusAddress startRegister);
+    void learnReadLimits();
+    void addSuccessfulPoll();
+
+    void setDeviceProfile(DeviceProfile deviceProfile);
+    DeviceProfile deviceProfile();
 
+    ModbusResultFrame resultFrame();
     ModbusResultMap resultMap();
 
 private:
 
+    /* Read plan of a register list, only rebuilt when its inputs change */
+    struct ReadPlan
+    {
+        bool bValid{false};
+
+        QList<ModbusAddress> registerList;
+        quint16 consecutiveMax{};
+        quint16 maxBridgedGap{};
+        quint32 profileRevision{};
+
+        QList<ModbusAddress> requestedList;
+        QList<ModbusReadItem> readItemList;
+    };
+
+    bool isPlanValid(const QList<ModbusAddress>& registerList, quint16 consecutiveMax, quint16 maxBridgedGap);
+    void compilePlan(QList<ModbusAddress> registerList, quint16 consecutiveMax, quint16 maxBridgedGap);
+
+    qint32 findInFlight(ModbusAddress startRegister);
+    bool isRequested(ModbusAddress address);
+    QList<ModbusAddress> requestedRegisters(ModbusReadItem readItem);
+    ModbusReadItem spanningItem(QList<ModbusAddress> registerList);
+    void addErrorResults(ModbusReadItem readItem);
+    qint32 firstSlot(ModbusAddress address);
+    quint32 maxItemCount(ModbusAddress::ObjectType type, quint16 consecutiveMax) const;
 
     QList<ModbusReadItem> _readItemList;
+    QList<ModbusReadItem> _inFlightList;
+    QList<ModbusAddress> _requestedList;
+
+    /* Successful reads of current read list */
+    QList<ModbusReadItem> _successList;
+
+    DeviceProfile _deviceProfile;
+    ReadPlan _plan;
 
-    ModbusResultMap _resultMap;
+    /* Results of the requested registers, unused registers of bridged gaps have no slot */
+    ModbusResultFrame _resultFrame;
 
 };
 
@@ -0,0 +1,177 @@
+#ifndef READSEQUENCE_H
+#define READSEQUENCE_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include <QList>
+#include <QQueue>
+#include <QString>
+#include <QModbusDevice>
+#include <QModbusPdu>
+
+#include "modbusaddress.h"
+
+/*!
+ * Event of the connection that a read sequence waits for
+ */
+struct ReadEvent
+{
+    enum class Type
+    {
+        CONNECTED,
+        CONNECTION_ERROR,
+        REQUEST_SUCCESS,
+        REQUEST_PROTOCOL_ERROR,
+        REQUEST_ERROR,
+    };
+
+    Type type;
+    ModbusAddress address{};
+    QList<quint16> values{};
+    QModbusPdu::ExceptionCode exceptionCode{};
+    QString message{};
+    QModbusDevice::Error error{QModbusDevice::NoError};
+
+    /* Moment of the response (in µs, see AcquisitionClock) */
+    qint64 timestamp{};
+};
+
+/*!
+ * Queue of connection events that is awaited by a read sequence
+ * A posted event resumes the waiting sequence directly, without a trip through the event loop. Events that
+ * are posted while the sequence is running (for example an error signal emitted from within a request)
+ * are queued and returned by its next co_await, without suspending.
+ */
+class ReadEventQueue
+{
+public:
+
+    class Awaiter
+    {
+    public:
+        explicit Awaiter(ReadEventQueue& queue) : _queue(queue) {}
+
+        bool await_ready() const
+        {
+            return !_queue._events.isEmpty();
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            _queue._waitingHandle = handle;
+        }
+
+        ReadEvent await_resume()
+        {
+            return _queue._events.dequeue();
+        }
+
+    private:
+        ReadEventQueue& _queue;
+    };
+
+    Awaiter next()
+    {
+        return Awaiter(*this);
+    }
+
+    void post(ReadEvent event)
+    {
+        _events.enqueue(std::move(event));
+
+        if (_waitingHandle)
+        {
+            /* Clear before resuming, the sequence can wait again before resume returns */
+            std::coroutine_handle<> handle = std::exchange(_waitingHandle, nullptr);
+            handle.resume();
+        }
+    }
+
+    void clear()
+    {
+        _events.clear();
+        _waitingHandle = nullptr;
+    }
+
+private:
+    QQueue<ReadEvent> _events;
+    std::coroutine_handle<> _waitingHandle{nullptr};
+};
+
+/*!
+ * Coroutine of a single read of a modbus master
+ * Starts running immediately and stays suspended at its end, so the owner can take the result when it is done.
+ * The result is true when the read failed because of the connection or a request without response.
+ */
+class ReadTask
+{
+public:
+
+    struct promise_type
+    {
+        bool bError{false};
+
+        ReadTask get_return_object()
+        {
+            return ReadTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        void return_value(bool bResult) { bError = bResult; }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    ReadTask() = default;
+
+    ReadTask(ReadTask&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+
+    ReadTask& operator=(ReadTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            _handle = std::exchange(other._handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    ReadTask(const ReadTask&) = delete;
+    ReadTask& operator=(const ReadTask&) = delete;
+
+    ~ReadTask()
+    {
+        destroy();
+    }
+
+    bool isDone() const
+    {
+        return _handle && _handle.done();
+    }
+
+    bool result() const
+    {
+        return _handle.promise().bError;
+    }
+
+    /* Only allowed while the coroutine is suspended */
+    void destroy()
+    {
+        if (_handle)
+        {
+            _handle.destroy();
+            _handle = nullptr;
+        }
+    }
+
+private:
+    explicit ReadTask(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+    std::coroutine_handle<promise_type> _handle{nullptr};
+};
+
+#endif // READSEQUENCE_H
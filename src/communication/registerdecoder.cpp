@@ -0,0 +1,213 @@
+#include "registerdecoder.h"
+
+#include <bit>
+#include <cmath>
+
+namespace {
+
+    template <bool bLittleEndian>
+    inline quint32 combineRegisters(quint16 lower, quint16 upper)
+    {
+        if constexpr (bLittleEndian)
+        {
+            return (static_cast<quint32>(upper) << 16) | lower;
+        }
+        else
+        {
+            return (static_cast<quint32>(lower) << 16) | upper;
+        }
+    }
+
+    /* The loops below have no branches and no calls, so the compiler can vectorize them */
+
+    template <typename T>
+    void decode16(const quint16* pRegisters, const qint32* pLowerSlots, double* pValues, qsizetype count)
+    {
+        for (qsizetype idx = 0; idx < count; idx++)
+        {
+            pValues[idx] = static_cast<double>(static_cast<T>(pRegisters[pLowerSlots[idx]]));
+        }
+    }
+
+    template <typename T, bool bLittleEndian>
+    void decode32(const quint16* pRegisters, const qint32* pLowerSlots, const qint32* pUpperSlots, double* pValues, qsizetype count)
+    {
+        for (qsizetype idx = 0; idx < count; idx++)
+        {
+            const quint32 combinedValue = combineRegisters<bLittleEndian>(pRegisters[pLowerSlots[idx]], pRegisters[pUpperSlots[idx]]);
+            pValues[idx] = static_cast<double>(static_cast<T>(combinedValue));
+        }
+    }
+
+    template <bool bLittleEndian>
+    void decodeFloat(const quint16* pRegisters, const qint32* pLowerSlots, const qint32* pUpperSlots, double* pValues, qsizetype count)
+    {
+        for (qsizetype idx = 0; idx < count; idx++)
+        {
+            const quint32 combinedValue = combineRegisters<bLittleEndian>(pRegisters[pLowerSlots[idx]], pRegisters[pUpperSlots[idx]]);
+            const float value = std::bit_cast<float>(combinedValue);
+
+            /* Same as ModbusRegister::processValue: infinite and NaN are shown as zero */
+            pValues[idx] = (std::isfinite(value) && (value != 0.0f)) ? static_cast<double>(value) : 0.0;
+        }
+    }
+}
+
+/*!
+ * Constructor for RegisterDecoder
+ * Decodes the registers of a connection from the raw values of a result frame. The registers are grouped by
+ * data type and word order when the read is compiled, so every group is converted in a single pass over
+ * contiguous slot lists into a contiguous value buffer, instead of a type check per register.
+ */
+RegisterDecoder::RegisterDecoder()
+{
+
+}
+
+/*!
+ * Add register to the group of its data type and word order
+ * \param resultIdx             Index of the register in the result list
+ * \param type                  Data type
+ * \param bInt32LittleEndian    Word order of 32 bit types
+ * \param lowerSlot             Slot of the register in the result frame
+ * \param upperSlot             Slot of the next register in the result frame (only used for 32 bit types)
+ */
+void RegisterDecoder::addRegister(qint32 resultIdx, ModbusDataType::Type type, bool bInt32LittleEndian, qint32 lowerSlot, qint32 upperSlot)
+{
+    /* Word order doesn't matter for 16 bit types, keep them in a single group */
+    const bool b32Bit = ModbusDataType::is32Bit(type);
+    DecodeGroup& decodeGroup = group(type, b32Bit && bInt32LittleEndian);
+
+    decodeGroup.resultIndexes.append(resultIdx);
+    decodeGroup.lowerSlots.append(lowerSlot);
+    if (b32Bit)
+    {
+        decodeGroup.upperSlots.append(upperSlot);
+    }
+}
+
+qsizetype RegisterDecoder::registerCount() const
+{
+    qsizetype count = 0;
+    for (const DecodeGroup& decodeGroup : _groups)
+    {
+        count += decodeGroup.resultIndexes.size();
+    }
+
+    return count;
+}
+
+/*!
+ * Decode all registers of a result frame
+ * The frame must use the address list the slots were compiled for.
+ * \param resultFrame   Results of the connection
+ * \param resultList    Result list that receives the decoded values
+ * \param valueBuffer   Buffer for the decoded values of a group, reused between calls to avoid allocations
+ */
+void RegisterDecoder::decode(const ModbusResultFrame& resultFrame, ResultDoubleList& resultList, QList<double>& valueBuffer) const
+{
+    const quint16* pRegisters = resultFrame.valueList().constData();
+
+    for (const DecodeGroup& decodeGroup : _groups)
+    {
+        const qsizetype count = decodeGroup.resultIndexes.size();
+        if (valueBuffer.size() < count)
+        {
+            valueBuffer.resize(count);
+        }
+
+        decodeValues(decodeGroup.type, decodeGroup.bInt32LittleEndian, pRegisters, decodeGroup.lowerSlots.constData(),
+                     decodeGroup.upperSlots.constData(), valueBuffer.data(), count);
+
+        /* Validity is applied afterwards, so the conversion itself stays branch free */
+        const bool b32Bit = ModbusDataType::is32Bit(decodeGroup.type);
+        for (qsizetype idx = 0; idx < count; idx++)
+        {
+            const bool bSuccess = resultFrame.isValid(decodeGroup.lowerSlots[idx])
+                                  && (!b32Bit || resultFrame.isValid(decodeGroup.upperSlots[idx]));
+
+            ResultDouble& result = resultList[decodeGroup.resultIndexes[idx]];
+            if (bSuccess)
+            {
+                result.setValue(valueBuffer[idx]);
+            }
+            else
+            {
+                result.setError();
+            }
+        }
+    }
+}
+
+/*!
+ * Convert raw registers of a single data type and word order to values
+ * \param type                  Data type
+ * \param bInt32LittleEndian    Word order of 32 bit types
+ * \param pRegisters            Raw register values
+ * \param pLowerSlots           Slot of the (lower) register of every value
+ * \param pUpperSlots           Slot of the upper register of every value (only used for 32 bit types)
+ * \param pValues               Buffer that receives the values
+ * \param count                 Number of values
+ */
+void RegisterDecoder::decodeValues(ModbusDataType::Type type, bool bInt32LittleEndian, const quint16* pRegisters,
+                                   const qint32* pLowerSlots, const qint32* pUpperSlots, double* pValues, qsizetype count)
+{
+    switch (type)
+    {
+    case ModbusDataType::Type::SIGNED_16:
+        decode16<qint16>(pRegisters, pLowerSlots, pValues, count);
+        break;
+
+    case ModbusDataType::Type::UNSIGNED_32:
+        if (bInt32LittleEndian)
+        {
+            decode32<quint32, true>(pRegisters, pLowerSlots, pUpperSlots, pValues, count);
+        }
+        else
+        {
+            decode32<quint32, false>(pRegisters, pLowerSlots, pUpperSlots, pValues, count);
+        }
+        break;
+
+    case ModbusDataType::Type::SIGNED_32:
+        if (bInt32LittleEndian)
+        {
+            decode32<qint32, true>(pRegisters, pLowerSlots, pUpperSlots, pValues, count);
+        }
+        else
+        {
+            decode32<qint32, false>(pRegisters, pLowerSlots, pUpperSlots, pValues, count);
+        }
+        break;
+
+    case ModbusDataType::Type::FLOAT_32:
+        if (bInt32LittleEndian)
+        {
+            decodeFloat<true>(pRegisters, pLowerSlots, pUpperSlots, pValues, count);
+        }
+        else
+        {
+            decodeFloat<false>(pRegisters, pLowerSlots, pUpperSlots, pValues, count);
+        }
+        break;
+
+    case ModbusDataType::Type::UNSIGNED_16:
+    default:
+        decode16<quint16>(pRegisters, pLowerSlots, pValues, count);
+        break;
+    }
+}
+
+RegisterDecoder::DecodeGroup& RegisterDecoder::group(ModbusDataType::Type type, bool bInt32LittleEndian)
+{
+    for (DecodeGroup& decodeGroup : _groups)
+    {
+        if ((decodeGroup.type == type) && (decodeGroup.bInt32LittleEndian == bInt32LittleEndian))
+        {
+            return decodeGroup;
+        }
+    }
+
+    _groups.append(DecodeGroup{type, bInt32LittleEndian, {}, {}, {}});
+    return _groups.last();
+}
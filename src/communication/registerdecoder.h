@@ -0,0 +1,43 @@
+#ifndef REGISTERDECODER_H
+#define REGISTERDECODER_H
+
+#include <QList>
+
+#include "modbusdatatype.h"
+#include "modbusresultframe.h"
+#include "result.h"
+
+class RegisterDecoder
+{
+public:
+
+    RegisterDecoder();
+
+    void addRegister(qint32 resultIdx, ModbusDataType::Type type, bool bInt32LittleEndian, qint32 lowerSlot, qint32 upperSlot);
+    qsizetype registerCount() const;
+
+    void decode(const ModbusResultFrame& resultFrame, ResultDoubleList& resultList, QList<double>& valueBuffer) const;
+
+    static void decodeValues(ModbusDataType::Type type, bool bInt32LittleEndian, const quint16* pRegisters,
+                             const qint32* pLowerSlots, const qint32* pUpperSlots, double* pValues, qsizetype count);
+
+private:
+
+    /* Registers with the same data type and word order, decoded in a single pass */
+    struct DecodeGroup
+    {
+        ModbusDataType::Type type;
+        bool bInt32LittleEndian;
+
+        /* Per register: index in result list and slots in the result frame (upper slot only for 32 bit types) */
+        QList<qint32> resultIndexes;
+        QList<qint32> lowerSlots;
+        QList<qint32> upperSlots;
+    };
+
+    DecodeGroup& group(ModbusDataType::Type type, bool bInt32LittleEndian);
+
+    QList<DecodeGroup> _groups;
+};
+
+#endif // REGISTERDECODER_H
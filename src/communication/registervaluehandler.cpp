@@ -2,109 +2,331 @@
 #include "modbusaddress.h"
 #include "settingsmodel.h"
 #include "modbusdatatype.h"
+#include "acquisitionclock.h"
+
+#include <algorithm>
 
 using State = ResultState::State;
 
-RegisterValueHandler::RegisterValueHandler(SettingsModel *pSettingsModel) :
-    _pSettingsModel(pSettingsModel)
+RegisterValueHandler::RegisterValueHandler(SettingsModel *pSettingsModel, QObject *parent) :
+    QObject(parent), _pSettingsModel(pSettingsModel)
 {
 }
 
-void RegisterValueHandler::startRead()
+/*!
+ * Prepare result list for a new read of all connections
+ * Registers of poll groups that aren't due get no value
+ * \param dueGroups    Bit mask of poll groups that are read
+ */
+void RegisterValueHandler::startRead(quint64 dueGroups)
 {
-    _resultList.clear();
-
-    for(quint16 listIdx = 0; listIdx < _registerList.size(); listIdx++)
+    for (quint8 connectionId = 0; connectionId < _resultIndexLists.size(); connectionId++)
     {
-        _resultList.append(ResultDouble(0, State::INVALID));
+        startConnectionRead(connectionId, dueGroups);
     }
 }
 
 void RegisterValueHandler::finishRead()
 {
-    emit registerDataReady(_resultList);
+    emit registerDataReady(SampleFrame(_resultList, AcquisitionClock::timestamp()));
 }
 
-void RegisterValueHandler::processPartialResult(ModbusResultMap partialResultMap, quint8 connectionId)
+/*!
+ * Prepare results of a single connection for a new read
+ * Registers of poll groups that aren't due get no value
+ * \param connectionId     Connection id
+ * \param dueGroups        Bit mask of poll groups that are read
+ */
+void RegisterValueHandler::startConnectionRead(quint8 connectionId, quint64 dueGroups)
 {
-    for(qint32 listIdx = 0; listIdx < _registerList.size(); listIdx++)
+    if (connectionId >= _resultIndexLists.size())
+    {
+        return;
+    }
+
+    _dueGroups[connectionId] = dueGroups;
+
+    for (const qint32 listIdx : std::as_const(_resultIndexLists[connectionId]))
     {
-        const ModbusRegister mbReg = _registerList[listIdx];
+        const auto state = isDue(listIdx, dueGroups) ? State::INVALID : State::NO_VALUE;
+        _resultList[listIdx] = ResultDouble(0, state);
+    }
+}
 
-        if (
-            (mbReg.connectionId() == connectionId)
-            && (partialResultMap.contains(mbReg.address()))
-            )
+/*!
+ * Publish results of a single connection
+ * Registers of other connections get no value
+ * \param connectionId     Connection id
+ * \param timestamp        Moment of the response (in µs, see \ref AcquisitionClock::timestamp)
+ */
+void RegisterValueHandler::finishConnectionRead(quint8 connectionId, qint64 timestamp)
+{
+    SampleFrame frame = SampleFrame::create(_registerList.size(), timestamp);
+
+    if (connectionId < _resultIndexLists.size())
+    {
+        for (const qint32 listIdx : std::as_const(_resultIndexLists[connectionId]))
         {
-            Result<quint16> upperRegister;
-            Result<quint16> lowerRegister;
+            frame.setResult(listIdx, _resultList[listIdx]);
+        }
+    }
 
-            lowerRegister = partialResultMap.value(mbReg.address());
+    emit registerDataReady(frame);
+}
 
-            if (ModbusDataType::is32Bit(mbReg.type()))
-            {
-                const auto addr = mbReg.address().next();
-                if (partialResultMap.contains(addr))
-                {
-                    upperRegister = partialResultMap.value(addr);
-                }
-            }
-            else
-            {
-                /* Dummy valid value */
-                upperRegister = Result<quint16>(0, State::SUCCESS);
-            }
+/*!
+ * Decode results of a connection
+ * Frames of a poll use the compiled address list of the due poll groups, so the slots of every register are
+ * known in advance and the registers are decoded in batches per data type and word order. Other frames are
+ * matched by address.
+ * \param resultFrame      Results of the connection
+ * \param connectionId     Connection id
+ */
+void RegisterValueHandler::processPartialResult(const ModbusResultFrame& resultFrame, quint8 connectionId)
+{
+    if (connectionId >= _resultIndexLists.size())
+    {
+        return;
+    }
 
-            bool bSuccess = lowerRegister.isValid() && upperRegister.isValid();
-            ResultDouble result;
-            if (bSuccess)
-            {
-                double processedResult = mbReg.processValue(lowerRegister.value(), upperRegister.value(), _pSettingsModel->int32LittleEndian(connectionId));
-                result.setValue(processedResult);
-            }
-            else
-            {
-                result.setError();
-            }
+    const CompiledRead& read = compiledRead(_dueGroups[connectionId]);
+    if (resultFrame.addressList() == read.addressLists[connectionId])
+    {
+        read.decoders[connectionId].decode(resultFrame, _resultList, _decodeBuffer);
+        return;
+    }
+
+    const QList<RegisterSlots>& registerSlots = read.registerSlots[connectionId];
+    const bool bInt32LittleEndian = _pSettingsModel->int32LittleEndian(connectionId);
+    const QList<qint32>& resultIndexList = _resultIndexLists[connectionId];
+
+    for (qint32 idx = 0; idx < resultIndexList.size(); idx++)
+    {
+        const qint32 listIdx = resultIndexList[idx];
+
+        /* Not due */
+        if (registerSlots[idx].lower == ModbusResultFrame::cNoSlot)
+        {
+            continue;
+        }
+
+        const RegisterSlots regSlots = frameSlots(resultFrame, listIdx);
+        if (regSlots.lower == ModbusResultFrame::cNoSlot)
+        {
+            continue;
+        }
+
+        const ModbusRegister& mbReg = _registerList[listIdx];
+        const bool b32Bit = ModbusDataType::is32Bit(mbReg.type());
+
+        bool bSuccess = resultFrame.isValid(regSlots.lower);
+        if (b32Bit)
+        {
+            bSuccess = bSuccess && (regSlots.upper != ModbusResultFrame::cNoSlot) && resultFrame.isValid(regSlots.upper);
+        }
+
+        ResultDouble result;
+        if (bSuccess)
+        {
+            const quint16 upperRegister = b32Bit ? resultFrame.value(regSlots.upper) : 0;
+            double processedResult = mbReg.processValue(resultFrame.value(regSlots.lower), upperRegister, bInt32LittleEndian);
+            result.setValue(processedResult);
+        }
+        else
+        {
+            result.setError();
+        }
+
+        _resultList[listIdx] = result;
+    }
+}
+
+// Get sorted list of active (unique) register addresses of due poll groups for a specific connection id
+void RegisterValueHandler::registerAddresList(QList<ModbusAddress>& registerList, quint8 connectionId, quint64 dueGroups)
+{
+    const auto& addressLists = compiledRead(dueGroups).addressLists;
+    if (connectionId < addressLists.size())
+    {
+        /* Implicitly shared, so the compiled list isn't copied */
+        registerList = addressLists[connectionId];
+    }
+    else
+    {
+        registerList.clear();
+    }
+}
 
-            _resultList[listIdx] = result;
+/*!
+ * Set registers to read
+ * The mapping of the results on the registers is compiled here once. The per connection address
+ * lists and result frame slots are compiled once for every combination of due poll groups, so they don't
+ * need to be rebuilt every poll
+ * \param registerList     List of registers
+ * \param pollGroupList    Poll group of every register (all registers in group 0 when empty)
+ */
+void RegisterValueHandler::setRegisters(QList<ModbusRegister>& registerList, QList<quint8> pollGroupList)
+{
+    _registerList = registerList;
+    _pollGroupList = pollGroupList;
+    _demandList.clear();
+    _resultList = ResultDoubleList(_registerList.size(), ResultDouble(0, State::NO_VALUE));
+
+    /* Single pass over the registers, so the cost doesn't grow with the number of connections */
+    const quint8 connectionCount = _pSettingsModel->connectionCount();
+
+    _usedGroups = 0;
+    _connectionGroups = QList<quint64>(connectionCount, 0);
+    _dueGroups = QList<quint64>(connectionCount, cAllPollGroups);
+    _resultIndexLists = QList<QList<qint32> >(connectionCount);
+
+    for (qint32 listIdx = 0; listIdx < _registerList.size(); listIdx++)
+    {
+        const quint8 connectionId = _registerList[listIdx].connectionId();
+        if (connectionId < connectionCount)
+        {
+            const quint8 group = listIdx < _pollGroupList.size() ? _pollGroupList[listIdx] : 0;
+            _connectionGroups[connectionId] |= static_cast<quint64>(1) << (group % cMaxPollGroups);
+
+            _resultIndexLists[connectionId].append(listIdx);
         }
     }
+
+    for (const quint64 connectionGroups : std::as_const(_connectionGroups))
+    {
+        _usedGroups |= connectionGroups;
+    }
+
+    _readCache.clear();
+    _readCache.insert(_usedGroups, compileRead(_usedGroups));
 }
 
-// Get sorted list of active (unique) register addresses for a specific connection id
-void RegisterValueHandler::registerAddresList(QList<ModbusAddress>& registerList, quint8 connectionId)
+/*!
+ * Set registers that are read
+ * Registers without demand are left out of the reads and get no value, so the reads only contain the
+ * registers that are needed. The compiled reads are rebuilt, the mapping of the results stays the same.
+ * \param demandList       Demand of every register in the register list (all registers are read when empty)
+ */
+void RegisterValueHandler::setRegisterDemand(QList<bool> demandList)
 {
-    QList<ModbusAddress> connRegisterList;
+    _demandList = demandList;
 
-    foreach(ModbusRegister mbReg, _registerList)
+    /* Registers that are dropped during a read aren't decoded anymore */
+    for (qint32 listIdx = 0; listIdx < _resultList.size(); listIdx++)
     {
-        if (mbReg.connectionId() == connectionId)
+        if (!isDemanded(listIdx))
         {
-            if (!connRegisterList.contains(mbReg.address()))
+            _resultList[listIdx] = ResultDouble(0, State::NO_VALUE);
+        }
+    }
+
+    _readCache.clear();
+    _readCache.insert(_usedGroups, compileRead(_usedGroups));
+}
+
+/*!
+ * Return poll groups that have registers of a connection
+ * \param connectionId     Connection id
+ * \return Bit mask of poll groups (0 when connection has no registers)
+ */
+quint64 RegisterValueHandler::pollGroups(quint8 connectionId) const
+{
+    return connectionId < _connectionGroups.size() ? _connectionGroups[connectionId] : 0;
+}
+
+bool RegisterValueHandler::isDue(qint32 listIdx, quint64 dueGroups) const
+{
+    const quint8 group = listIdx < _pollGroupList.size() ? _pollGroupList[listIdx] : 0;
+
+    return isDemanded(listIdx) && ((dueGroups & (static_cast<quint64>(1) << (group % cMaxPollGroups))) != 0);
+}
+
+bool RegisterValueHandler::isDemanded(qint32 listIdx) const
+{
+    return (listIdx >= _demandList.size()) || _demandList[listIdx];
+}
+
+/*!
+ * Return compiled read of a combination of due poll groups, compile it when it isn't cached yet
+ * \param dueGroups    Bit mask of due poll groups
+ * \return Compiled read
+ */
+const RegisterValueHandler::CompiledRead& RegisterValueHandler::compiledRead(quint64 dueGroups)
+{
+    /* Bits of unused groups don't change the read */
+    dueGroups &= _usedGroups;
+
+    auto it = _readCache.find(dueGroups);
+    if (it == _readCache.end())
+    {
+        it = _readCache.insert(dueGroups, compileRead(dueGroups));
+    }
+
+    return it.value();
+}
+
+RegisterValueHandler::CompiledRead RegisterValueHandler::compileRead(quint64 dueGroups) const
+{
+    CompiledRead read;
+
+    for (quint8 connectionId = 0; connectionId < _resultIndexLists.size(); connectionId++)
+    {
+        QList<ModbusAddress> connRegisterList;
+
+        for (const qint32 listIdx : std::as_const(_resultIndexLists[connectionId]))
+        {
+            if (isDue(listIdx, dueGroups))
             {
+                const ModbusRegister& mbReg = _registerList[listIdx];
+
                 connRegisterList.append(mbReg.address());
-            }
 
-            /* When reading 32 bit value, also read next address */
-            if (ModbusDataType::is32Bit(mbReg.type()))
-            {
-                const auto reg = mbReg.address().next();
-                if (!connRegisterList.contains(reg))
+                /* When reading 32 bit value, also read next address */
+                if (ModbusDataType::is32Bit(mbReg.type()))
                 {
-                    connRegisterList.append(reg);
+                    connRegisterList.append(mbReg.address().next());
                 }
             }
         }
-    }
 
-    // sort qList
-    std::sort(connRegisterList.begin(), connRegisterList.end(), std::less<ModbusAddress>());
+        // sort and remove duplicates
+        std::sort(connRegisterList.begin(), connRegisterList.end(), std::less<ModbusAddress>());
+        connRegisterList.erase(std::unique(connRegisterList.begin(), connRegisterList.end()), connRegisterList.end());
 
-    registerList = connRegisterList;
+        /* Slots in the result frame of this address list */
+        const ModbusResultFrame slotFrame(connRegisterList);
+        QList<RegisterSlots> registerSlots;
+        RegisterDecoder decoder;
+        const bool bInt32LittleEndian = _pSettingsModel->int32LittleEndian(connectionId);
+        for (const qint32 listIdx : std::as_const(_resultIndexLists[connectionId]))
+        {
+            const RegisterSlots regSlots = isDue(listIdx, dueGroups) ? frameSlots(slotFrame, listIdx) : RegisterSlots();
+            registerSlots.append(regSlots);
+
+            if (regSlots.lower != ModbusResultFrame::cNoSlot)
+            {
+                decoder.addRegister(listIdx, _registerList[listIdx].type(), bInt32LittleEndian, regSlots.lower, regSlots.upper);
+            }
+        }
+
+        read.addressLists.append(connRegisterList);
+        read.registerSlots.append(registerSlots);
+        read.decoders.append(decoder);
+    }
+
+    return read;
 }
 
-void RegisterValueHandler::setRegisters(QList<ModbusRegister>& registerList)
+RegisterValueHandler::RegisterSlots RegisterValueHandler::frameSlots(const ModbusResultFrame& resultFrame, qint32 listIdx) const
 {
-    _registerList = registerList;
+    const ModbusRegister& mbReg = _registerList[listIdx];
+
+    RegisterSlots regSlots;
+    regSlots.lower = resultFrame.slot(mbReg.address());
+
+    if (ModbusDataType::is32Bit(mbReg.type()))
+    {
+        regSlots.upper = resultFrame.slot(mbReg.address().next());
+    }
+
+    return regSlots;
 }
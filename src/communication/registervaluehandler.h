@@ -2,9 +2,12 @@
 #define REGISTERVALUEHANDLER_H
 
 #include <QObject>
+#include <QHash>
 
-#include "modbusresultmap.h"
+#include "modbusresultframe.h"
 #include "modbusregister.h"
+#include "registerdecoder.h"
+#include "sampleframe.h"
 
 class SettingsModel;
 
@@ -13,24 +16,73 @@ class RegisterValueHandler : public QObject
     Q_OBJECT
 public:
 
-    explicit RegisterValueHandler(SettingsModel *pSettingsModel);
+    explicit RegisterValueHandler(SettingsModel *pSettingsModel, QObject *parent = nullptr);
 
-    void setRegisters(QList<ModbusRegister> &registerList);
+    void setRegisters(QList<ModbusRegister> &registerList, QList<quint8> pollGroupList = QList<quint8>());
+    void setRegisterDemand(QList<bool> demandList);
 
-    void startRead();
-    void processPartialResult(ModbusResultMap partialResultMap, quint8 connectionId);
+    void startRead(quint64 dueGroups = cAllPollGroups);
+    void processPartialResult(const ModbusResultFrame& resultFrame, quint8 connectionId);
     void finishRead();
 
-    void registerAddresList(QList<ModbusAddress>& registerList, quint8 connectionId);
+    void startConnectionRead(quint8 connectionId, quint64 dueGroups = cAllPollGroups);
+    void finishConnectionRead(quint8 connectionId, qint64 timestamp);
+
+    void registerAddresList(QList<ModbusAddress>& registerList, quint8 connectionId, quint64 dueGroups = cAllPollGroups);
+    quint64 pollGroups(quint8 connectionId) const;
+
+    static const quint64 cAllPollGroups = ~static_cast<quint64>(0);
+    static const quint8 cMaxPollGroups = 64;
 
 signals:
-    void registerDataReady(ResultDoubleList registers);
+    void registerDataReady(SampleFrame registers);
 
 private:
+
+    /* Slots of the lower and upper register of a result in the result frame of its connection */
+    struct RegisterSlots
+    {
+        qint32 lower{ModbusResultFrame::cNoSlot};
+        qint32 upper{ModbusResultFrame::cNoSlot};
+    };
+
+    /* Reads of all connections for a combination of due poll groups */
+    struct CompiledRead
+    {
+        QList<QList<ModbusAddress> > addressLists;
+
+        /* Per connection, in order of its result index list (no slot when not due) */
+        QList<QList<RegisterSlots> > registerSlots;
+
+        /* Per connection, due registers grouped by data type and word order */
+        QList<RegisterDecoder> decoders;
+    };
+
+    bool isDue(qint32 listIdx, quint64 dueGroups) const;
+    bool isDemanded(qint32 listIdx) const;
+    const CompiledRead& compiledRead(quint64 dueGroups);
+    CompiledRead compileRead(quint64 dueGroups) const;
+    RegisterSlots frameSlots(const ModbusResultFrame& resultFrame, qint32 listIdx) const;
+
     SettingsModel* _pSettingsModel;
 
     QList<ModbusRegister> _registerList;
+    QList<quint8> _pollGroupList;
+
+    /* Registers that are read, all registers when empty */
+    QList<bool> _demandList;
     ResultDoubleList _resultList;
+
+    quint64 _usedGroups{};
+    QList<quint64> _connectionGroups;
+    QList<quint64> _dueGroups;
+
+    /* Compiled per combination of due poll groups */
+    QHash<quint64, CompiledRead> _readCache;
+    QList<QList<qint32> > _resultIndexLists;
+
+    /* Decoded values of a group, reused every poll */
+    QList<double> _decodeBuffer;
 };
 
 #endif // REGISTERVALUEHANDLER_H
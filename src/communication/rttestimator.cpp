@@ -0,0 +1,95 @@
+#include "rttestimator.h"
+
+#include <QtMath>
+
+/*!
+ * Constructor for RttEstimator
+ * Estimates the round-trip time of requests in the same way as TCP (RFC 6298): a smoothed round-trip time
+ * and its mean deviation are updated with every sample, the request timeout is the smoothed round-trip
+ * time plus four times the deviation. All round-trip times are in µs, timeouts in ms.
+ */
+RttEstimator::RttEstimator()
+{
+
+}
+
+/*!
+ * Forget all samples
+ */
+void RttEstimator::reset()
+{
+    _smoothedRtt = 0;
+    _rttVariation = 0;
+    _sampleCount = 0;
+    _backOffShift = 0;
+}
+
+/*!
+ * Add round-trip time of an answered request
+ * Only requests that are answered on their first try should be added (Karn's algorithm)
+ * \param roundTripTime     Time between sending the request and receiving the response (in µs)
+ */
+void RttEstimator::addSample(qint64 roundTripTime)
+{
+    roundTripTime = qMax(roundTripTime, static_cast<qint64>(0));
+
+    if (_sampleCount == 0)
+    {
+        _smoothedRtt = roundTripTime;
+        _rttVariation = roundTripTime / 2;
+    }
+    else
+    {
+        /* Gains of 1/4 for the deviation and 1/8 for the round-trip time */
+        _rttVariation += (qAbs(_smoothedRtt - roundTripTime) - _rttVariation) / 4;
+        _smoothedRtt += (roundTripTime - _smoothedRtt) / 8;
+    }
+
+    _sampleCount++;
+    _backOffShift = 0;
+}
+
+/*!
+ * Double the request timeout after a request has timed out
+ * The timeout stays doubled until a new sample is added
+ */
+void RttEstimator::backOff()
+{
+    if (_backOffShift < _cMaxBackOffShift)
+    {
+        _backOffShift++;
+    }
+}
+
+quint32 RttEstimator::sampleCount() const
+{
+    return _sampleCount;
+}
+
+qint64 RttEstimator::smoothedRtt() const
+{
+    return _smoothedRtt;
+}
+
+qint64 RttEstimator::rttVariation() const
+{
+    return _rttVariation;
+}
+
+/*!
+ * Return timeout of the next request
+ * \param maxTimeout    Configured timeout (in ms), used as long as there are no samples
+ * \return Request timeout (in ms), between \ref cMinTimeout and maxTimeout
+ */
+quint32 RttEstimator::requestTimeout(quint32 maxTimeout) const
+{
+    if (_sampleCount == 0)
+    {
+        return maxTimeout;
+    }
+
+    const qint64 timeoutUs = (_smoothedRtt + (4 * _rttVariation)) << _backOffShift;
+    const qint64 timeout = qCeil(static_cast<double>(timeoutUs) / 1000);
+
+    return static_cast<quint32>(qBound(static_cast<qint64>(qMin(cMinTimeout, maxTimeout)), timeout, static_cast<qint64>(maxTimeout)));
+}
@@ -0,0 +1,37 @@
+#ifndef RTTESTIMATOR_H
+#define RTTESTIMATOR_H
+
+#include <QtGlobal>
+
+class RttEstimator
+{
+public:
+    RttEstimator();
+
+    void reset();
+
+    void addSample(qint64 roundTripTime);
+    void backOff();
+
+    quint32 sampleCount() const;
+    qint64 smoothedRtt() const;
+    qint64 rttVariation() const;
+
+    quint32 requestTimeout(quint32 maxTimeout) const;
+
+    static constexpr quint32 cMinTimeout = 20;
+
+private:
+
+    /* Smoothed round-trip time and its mean deviation (in µs) */
+    qint64 _smoothedRtt{};
+    qint64 _rttVariation{};
+    quint32 _sampleCount{};
+
+    /* Timeout is doubled for every timeout since the last sample */
+    quint32 _backOffShift{};
+
+    static constexpr quint32 _cMaxBackOffShift = 6;
+};
+
+#endif // RTTESTIMATOR_H
@@ -11,6 +11,7 @@ ConnectionForm::ConnectionForm(QWidget *parent) :
 
     _pUi->comboType->addItem("TCP", QVariant(Connection::TYPE_TCP));
     _pUi->comboType->addItem("Serial", QVariant(Connection::TYPE_SERIAL));
+    _pUi->comboType->addItem("UDP", QVariant(Connection::TYPE_UDP));
     _pUi->comboType->setCurrentIndex(0);
     connect(_pUi->comboType, QOverload<const int>::of(&QComboBox::currentIndexChanged), this, &ConnectionForm::connTypeSelected);
 
@@ -55,6 +56,7 @@ void ConnectionForm::setState(bool bEnabled)
     _pUi->spinConsecutiveMax->setEnabled(bEnabled);
     _pUi->checkInt32LittleEndian->setEnabled(bEnabled);
     _pUi->checkPersistentConn->setEnabled(bEnabled);
+    _pUi->spinLingerTime->setEnabled(bEnabled);
 
     _pUi->comboType->setEnabled(bEnabled);
 
@@ -67,6 +69,7 @@ void ConnectionForm::setState(bool bEnabled)
     {
         _pUi->lineIP->setEnabled(false);
         _pUi->spinPort->setEnabled(false);
+        _pUi->spinRequestWindow->setEnabled(false);
         _pUi->comboPortName->setEnabled(false);
         _pUi->comboBaud->setEnabled(false);
         _pUi->comboParity->setEnabled(false);
@@ -80,8 +83,10 @@ void ConnectionForm::fillSettingsModel(SettingsModel* pSettingsModel, quint8 con
     pSettingsModel->setSlaveId(connectionId, _pUi->spinSlaveId->value());
     pSettingsModel->setTimeout(connectionId, _pUi->spinTimeout->value());
     pSettingsModel->setConsecutiveMax(connectionId, _pUi->spinConsecutiveMax->value());
+    pSettingsModel->setRequestWindow(connectionId, _pUi->spinRequestWindow->value());
     pSettingsModel->setInt32LittleEndian(connectionId, _pUi->checkInt32LittleEndian->checkState() == Qt::Checked);
     pSettingsModel->setPersistentConnection(connectionId, _pUi->checkPersistentConn->checkState() == Qt::Checked);
+    pSettingsModel->setLingerTime(connectionId, _pUi->spinLingerTime->value());
 
     pSettingsModel->setConnectionType(connectionId, static_cast<Connection::type_t>(_pUi->comboType->currentData().toUInt()));
 
@@ -170,6 +175,11 @@ void ConnectionForm::setConsecutiveMax(quint8 max)
     _pUi->spinConsecutiveMax->setValue(max);
 }
 
+void ConnectionForm::setRequestWindow(quint8 window)
+{
+    _pUi->spinRequestWindow->setValue(window);
+}
+
 void ConnectionForm::setInt32LittleEndian(bool int32LittleEndian)
 {
     _pUi->checkInt32LittleEndian->setChecked(int32LittleEndian);
@@ -180,6 +190,11 @@ void ConnectionForm::setPersistentConnection(bool persistentConnection)
     _pUi->checkPersistentConn->setChecked(persistentConnection);
 }
 
+void ConnectionForm::setLingerTime(quint32 lingerTime)
+{
+    _pUi->spinLingerTime->setValue(static_cast<int>(lingerTime));
+}
+
 void ConnectionForm::connTypeSelected()
 {
     enableSpecificSettings();
@@ -187,10 +202,12 @@ void ConnectionForm::connTypeSelected()
 
 void ConnectionForm::enableSpecificSettings()
 {
-    bool bTcp = static_cast<Connection::type_t>(_pUi->comboType->currentData().toUInt()) == Connection::TYPE_TCP;
+    /* UDP uses the network settings of TCP */
+    bool bTcp = static_cast<Connection::type_t>(_pUi->comboType->currentData().toUInt()) != Connection::TYPE_SERIAL;
 
     _pUi->lineIP->setEnabled(bTcp);
     _pUi->spinPort->setEnabled(bTcp);
+    _pUi->spinRequestWindow->setEnabled(bTcp);
     _pUi->comboPortName->setEnabled(!bTcp);
     _pUi->comboBaud->setEnabled(!bTcp);
     _pUi->comboParity->setEnabled(!bTcp);
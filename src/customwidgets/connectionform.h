@@ -32,8 +32,10 @@ public:
     void setSlaveId(quint8 id);
     void setTimeout(quint32 timeout);
     void setConsecutiveMax(quint8 max);
+    void setRequestWindow(quint8 window);
     void setInt32LittleEndian(bool int32LittleEndian);
     void setPersistentConnection(bool persistentConnection);
+    void setLingerTime(quint32 lingerTime);
 
 public slots:
     void setState(bool bEnabled);
@@ -162,9 +162,23 @@ void Legend::legendCellDoubleClicked(int row, int column)
     }
 }
 
-void Legend::addLastReceivedDataToLegend(ResultDoubleList resultList)
+void Legend::addLastReceivedDataToLegend(SampleFrame resultList)
 {
-    _lastReceivedList = resultList;
+    if (_lastReceivedList.size() == resultList.size())
+    {
+        /* Keep last value of graphs that weren't polled */
+        for (qint32 idx = 0; idx < resultList.size(); idx++)
+        {
+            if (resultList[idx].state() != State::NO_VALUE)
+            {
+                _lastReceivedList[idx] = resultList[idx];
+            }
+        }
+    }
+    else
+    {
+        _lastReceivedList = resultList.toResultList();
+    }
 
     updateDataInLegend();
 }
@@ -9,7 +9,7 @@
 #include <QColor>
 #include <QMenu>
 
-#include "result.h"
+#include "sampleframe.h"
 
 /* Forward declaration */
 class GuiModel;
@@ -29,7 +29,7 @@ public:
     void clearLegendData();
 
 public slots:
-    void addLastReceivedDataToLegend(ResultDoubleList resultList);
+    void addLastReceivedDataToLegend(SampleFrame resultList);
     void graphToForeground(int row);
     void updateDataInLegend();
 
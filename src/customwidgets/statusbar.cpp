@@ -1,6 +1,7 @@
 #include "statusbar.h"
 
 #include <QDateTime>
+#include <QStringList>
 
 #include "clickablelabel.h"
 #include "guimodel.h"
@@ -14,6 +15,8 @@ const QString StatusBar::_cStateDataLoaded = QString("Data File loaded");
 const QString StatusBar::_cStatsTemplate = QString("Success: %1\tErrors: %2");
 const QString StatusBar::_cRuntime = QString("Runtime: %1");
 const QString StatusBar::_cRuntimeWithPoll = QString("Runtime: %1\tPoll time: %2");
+const QString StatusBar::_cMissedPolls = QString("\tMissed polls: %1");
+const QString StatusBar::_cTrippedConnections = QString("\tOffline: %1");
 
 StatusBar::StatusBar(GuiModel* pGuiModel, GraphDataModel* pGraphDataModel, QWidget *parent) :
     QStatusBar(parent), _pGuiModel(pGuiModel), _pGraphDataModel(pGraphDataModel)
@@ -105,6 +108,27 @@ void StatusBar::updateTimeStats()
 
     QString strTimePassed = QString("%1:%2:%3").arg(h).arg(m, 2, 10, QChar('0')).arg(s, 2, 10, QChar('0'));
 
-    _pStatusRuntime->setText(_cRuntimeWithPoll.arg(strTimePassed).arg(_pGraphDataModel->medianPollTime()));
+    QString strRuntime = _cRuntimeWithPoll.arg(strTimePassed).arg(_pGraphDataModel->medianPollTime());
+
+    /* Only show missed polls when configured poll rate isn't reached */
+    if (_pGraphDataModel->missedPollCount() > 0)
+    {
+        strRuntime.append(_cMissedPolls.arg(_pGraphDataModel->missedPollCount()));
+    }
+
+    /* Connections that are skipped because of their circuit breaker */
+    const QList<quint8> trippedConnections = _pGraphDataModel->trippedConnections();
+    if (!trippedConnections.isEmpty())
+    {
+        QStringList connectionNames;
+        for (const quint8 connectionId : trippedConnections)
+        {
+            connectionNames.append(QString("Conn %1").arg(connectionId + 1));
+        }
+
+        strRuntime.append(_cTrippedConnections.arg(connectionNames.join(", ")));
+    }
+
+    _pStatusRuntime->setText(strRuntime);
 
 }
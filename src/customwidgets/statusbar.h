@@ -38,6 +38,8 @@ private:
     static const QString _cStateDataLoaded;
     static const QString _cRuntime;
     static const QString _cRuntimeWithPoll;
+    static const QString _cMissedPolls;
+    static const QString _cTrippedConnections;
 };
 
 #endif // STATUSBAR_H
@@ -28,9 +28,11 @@ ConnectionDialog::ConnectionDialog(SettingsModel * pSettingsModel, QWidget *pare
     connect(_pSettingsModel, &SettingsModel::slaveIdChanged, this, &ConnectionDialog::updateSlaveId);
     connect(_pSettingsModel, &SettingsModel::timeoutChanged, this, &ConnectionDialog::updateTimeout);
     connect(_pSettingsModel, &SettingsModel::consecutiveMaxChanged, this, &ConnectionDialog::updateConsecutiveMax);
+    connect(_pSettingsModel, &SettingsModel::requestWindowChanged, this, &ConnectionDialog::updateRequestWindow);
     connect(_pSettingsModel, &SettingsModel::connectionStateChanged, this, &ConnectionDialog::updateConnectionState);
     connect(_pSettingsModel, &SettingsModel::int32LittleEndianChanged, this, &ConnectionDialog::updateInt32LittleEndian);
     connect(_pSettingsModel, &SettingsModel::persistentConnectionChanged, this, &ConnectionDialog::updatePersistentConnection);
+    connect(_pSettingsModel, &SettingsModel::lingerTimeChanged, this, &ConnectionDialog::updateLingerTime);
 
     _pUi->connectionForm_2->setState(false);
     connect(_pUi->checkConn_2, &QCheckBox::stateChanged, _pUi->connectionForm_2, &ConnectionForm::setState);
@@ -154,6 +156,13 @@ void ConnectionDialog::updateConsecutiveMax(quint8 connectionId)
     pConnectionSettings->setConsecutiveMax(_pSettingsModel->consecutiveMax(connectionId));
 }
 
+void ConnectionDialog::updateRequestWindow(quint8 connectionId)
+{
+    auto pConnectionSettings = connectionSettingsWidget(connectionId);
+
+    pConnectionSettings->setRequestWindow(_pSettingsModel->requestWindow(connectionId));
+}
+
 void ConnectionDialog::updateInt32LittleEndian(quint8 connectionId)
 {
     auto pConnectionSettings = connectionSettingsWidget(connectionId);
@@ -168,6 +177,13 @@ void ConnectionDialog::updatePersistentConnection(quint8 connectionId)
     pConnectionSettings->setPersistentConnection(_pSettingsModel->persistentConnection(connectionId));
 }
 
+void ConnectionDialog::updateLingerTime(quint8 connectionId)
+{
+    auto pConnectionSettings = connectionSettingsWidget(connectionId);
+
+    pConnectionSettings->setLingerTime(_pSettingsModel->lingerTime(connectionId));
+}
+
 ConnectionForm* ConnectionDialog::connectionSettingsWidget(quint8 connectionId)
 {
     ConnectionForm* retRef;
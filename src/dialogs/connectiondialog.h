@@ -38,8 +38,10 @@ private slots:
     void updateSlaveId(quint8 connectionId);
     void updateTimeout(quint8 connectionId);
     void updateConsecutiveMax(quint8 connectionId);
+    void updateRequestWindow(quint8 connectionId);
     void updateInt32LittleEndian(quint8 connectionId);
     void updatePersistentConnection(quint8 connectionId);
+    void updateLingerTime(quint8 connectionId);
 
 private:
     Ui::ConnectionDialog * _pUi;
@@ -55,8 +55,15 @@ MainWindow::MainWindow(QStringList cmdArguments, GuiModel* pGuiModel,
 
     _pGraphDataHandler = new GraphDataHandler();
     _pModbusPoll = new ModbusPoll(_pSettingsModel);
+    _pModbusPoll->setDeviceProfileStore(&_deviceProfileStore);
     connect(_pModbusPoll, &ModbusPoll::registerDataReady, _pGraphDataHandler, &GraphDataHandler::handleRegisterData);
 
+    /* Results are passed to the GUI thread with queued signals */
+    _pModbusPoll->moveToThread(&_communicationThread);
+    connect(&_communicationThread, &QThread::finished, _pModbusPoll, &QObject::deleteLater);
+    _communicationThread.setObjectName("communication");
+    _communicationThread.start();
+
     _pGraphView = new GraphView(_pGuiModel, _pSettingsModel, _pGraphDataModel, _pNoteModel, _pUi->customPlot, this);
     _pDataFileHandler = new DataFileHandler(_pGuiModel, _pGraphDataModel, _pNoteModel, _pSettingsModel, _pDataParserModel, this);
     _pProjectFileHandler = new ProjectFileHandler(_pGuiModel, _pSettingsModel, _pGraphDataModel);
@@ -93,6 +100,7 @@ MainWindow::MainWindow(QStringList cmdArguments, GuiModel* pGuiModel,
     connect(_pUi->actionUpdateAvailable, &QAction::triggered, this, &MainWindow::openUpdateUrl);
     connect(_pUi->actionHighlightSamplePoints, &QAction::toggled, _pGuiModel, &GuiModel::setHighlightSamples);
     connect(_pUi->actionClearData, &QAction::triggered, this, &MainWindow::clearData);
+    connect(_pUi->actionClearDeviceProfiles, &QAction::triggered, this, &MainWindow::clearDeviceProfiles);
     connect(_pUi->actionToggleMarkers, &QAction::triggered, this, &MainWindow::toggleMarkersState);
     connect(_pUi->actionConnectionSettings, &QAction::triggered, this, &MainWindow::showConnectionDialog);
     connect(_pUi->actionLogSettings, &QAction::triggered, this, &MainWindow::showLogSettingsDialog);
@@ -204,6 +212,8 @@ MainWindow::MainWindow(QStringList cmdArguments, GuiModel* pGuiModel,
     connect(_pGraphDataHandler, &GraphDataHandler::graphDataReady, _pGraphView, &GraphView::plotResults);
     connect(_pGraphDataHandler, &GraphDataHandler::graphDataReady, _pLegend, &Legend::addLastReceivedDataToLegend);
     connect(_pGraphDataHandler, &GraphDataHandler::graphDataReady, _pCommunicationStats, &CommunicationStats::updateCommunicationStats);
+    connect(_pModbusPoll, &ModbusPoll::pollStatisticsUpdated, _pCommunicationStats, &CommunicationStats::updatePollStatistics);
+    connect(_pModbusPoll, &ModbusPoll::connectionTripped, _pCommunicationStats, &CommunicationStats::updateConnectionTripped);
 
     handleCommandLineArguments(cmdArguments);
 
@@ -227,7 +237,11 @@ MainWindow::~MainWindow()
 {
     delete _pGraphView;
     delete _pConnectionDialog;
-    delete _pModbusPoll;
+
+    /* Poll object is deleted in its own thread when the thread finishes */
+    _communicationThread.quit();
+    _communicationThread.wait();
+
     delete _pGraphShowHide;
     delete _pMostRecentMenu;
     delete _pGraphBringToFront;
@@ -481,6 +495,14 @@ void MainWindow::clearData()
     }
 }
 
+/*!
+ * Forget the learned read limits of all devices, so they are probed again on the next start
+ */
+void MainWindow::clearDeviceProfiles()
+{
+    _pModbusPoll->clearDeviceProfiles();
+}
+
 void MainWindow::startScope()
 {
     if (_pGuiModel->guiState() == GuiState::DATA_LOADED)
@@ -498,10 +520,13 @@ void MainWindow::startScope()
         clearData();
 
         QList<ModbusRegister> registerList;
+        QList<quint32> pollIntervalList;
         _pGraphDataHandler->processActiveRegisters(_pGraphDataModel);
         _pGraphDataHandler->modbusRegisterList(registerList);
+        _pGraphDataHandler->registerPollIntervals(pollIntervalList, _pSettingsModel->pollTime());
 
-        _pModbusPoll->startCommunication(registerList);
+        updateRegisterDemand();
+        _pModbusPoll->startCommunication(registerList, pollIntervalList);
         _pCommunicationStats->start();
 
         if (_pSettingsModel->writeDuringLog())
@@ -528,6 +553,22 @@ void MainWindow::stopScope()
     _pGuiModel->setGuiState(GuiState::STOPPED);
 }
 
+/*!
+ * Update registers that are polled
+ * In on-demand mode, registers that are only used by hidden graphs aren't polled. When the graphs are
+ * written to a file during logging, all registers are polled.
+ */
+void MainWindow::updateRegisterDemand()
+{
+    QList<bool> demandList;
+    if (_pSettingsModel->onDemandPolling() && !_pSettingsModel->writeDuringLog())
+    {
+        _pGraphDataHandler->registerDemand(demandList);
+    }
+
+    _pModbusPoll->setRegisterDemand(demandList);
+}
+
 void MainWindow::showDiagnostic()
 {
     _pDiagnosticDialog->show();
@@ -583,6 +624,10 @@ void MainWindow::handleGraphVisibilityChange(quint32 graphIdx)
         }
         _pGraphBringToFront->setEnabled(bVisible);
 
+        if (_pGuiModel->guiState() == GuiState::STARTED)
+        {
+            updateRegisterDemand();
+        }
     }
 }
 
@@ -716,6 +761,7 @@ void MainWindow::updateGuiState()
         _pUi->actionExportImage->setEnabled(false);
         _pUi->actionSaveProjectFileAs->setEnabled(true);
         _pUi->actionClearData->setEnabled(true);
+        _pUi->actionClearDeviceProfiles->setEnabled(true);
 
         _pDataParserModel->resetSettings();
         _pGuiModel->setProjectFilePath(QString(""));
@@ -738,6 +784,7 @@ void MainWindow::updateGuiState()
         _pUi->actionReloadProjectFile->setEnabled(false);
         _pUi->actionExportImage->setEnabled(true);
         _pUi->actionClearData->setEnabled(true);
+        _pUi->actionClearDeviceProfiles->setEnabled(false);
     }
     else if (_pGuiModel->guiState() == GuiState::STOPPED)
     {
@@ -753,6 +800,7 @@ void MainWindow::updateGuiState()
         _pUi->actionSaveProjectFileAs->setEnabled(true);
         _pUi->actionExportImage->setEnabled(true);
         _pUi->actionClearData->setEnabled(true);
+        _pUi->actionClearDeviceProfiles->setEnabled(true);
 
         _pDataParserModel->resetSettings();
 
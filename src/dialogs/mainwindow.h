@@ -5,9 +5,11 @@
 #include <QListWidgetItem>
 #include <QButtonGroup>
 #include <QMenu>
+#include <QThread>
 
 #include "updatenotify.h"
 #include "recentfilemodule.h"
+#include "deviceprofilestore.h"
 
 namespace Ui {
 class MainWindow;
@@ -69,6 +71,7 @@ private slots:
     void addNoteToGraph();
     void toggleZoom(bool checked);
     void clearData();
+    void clearDeviceProfiles();
     void startScope();
     void stopScope();
     void showDiagnostic();
@@ -104,6 +107,7 @@ private slots:
 
 private:
     void setAxisToAuto();
+    void updateRegisterDemand();
     void showRegisterDialog(QString mbcFile);
     void handleCommandLineArguments(QStringList cmdArguments);
     void handleFileOpen(QString filename);
@@ -144,6 +148,10 @@ private:
 
     MostRecentMenu* _pMostRecentMenu;
     RecentFileModule _recentFileModule;
+    DeviceProfileStore _deviceProfileStore;
+
+    /* Acquisition runs in its own thread, so it isn't delayed by the GUI */
+    QThread _communicationThread;
 
     QPointF _lastRightClickPos;
 };
@@ -338,38 +338,54 @@ void GraphView::rescalePlot()
     _pPlot->replot();
 }
 
-void GraphView::plotResults(ResultDoubleList resultList)
+/*!
+ * Add results to plot
+ * \param resultList   Result of every active graph and moment of acquisition (in µs, see \ref AcquisitionClock::timestamp)
+ */
+void GraphView::plotResults(SampleFrame resultList)
 {
-    /* QList correspond with activeGraphList */
+    /* Frame correspond with activeGraphList */
 
-    quint64 timeData;
+    /* Time axis is in ms, keep µs as fraction */
+    const qint64 timestamp = resultList.timestamp();
+    double timeData;
     if (_pSettingsModel->absoluteTimes())
     {
         // Epoch is in UTC time
-        timeData = QDateTime::currentMSecsSinceEpoch();
+        timeData = static_cast<double>(timestamp) / 1000;
     }
     else
     {
-        timeData = QDateTime::currentMSecsSinceEpoch() - _pGraphDataModel->communicationStartTime();
+        timeData = static_cast<double>(timestamp - _pGraphDataModel->communicationStartTime() * 1000) / 1000;
     }
 
-    QList<double> dataList;
+    /* Plotted values, frame is taken from the pool */
+    SampleFrame dataList = SampleFrame::create(resultList.size(), timestamp);
 
-    uint32_t i = 0;
-    for (const auto &result: resultList)
+    for (qint32 i = 0; i < resultList.size(); i++)
     {
+        const ResultDouble& result = resultList[i];
+        double value;
+
         if (result.isValid())
         {
             // No error, add points
-            _pPlot->graph(i)->addData(timeData, result.value());
-            dataList.append(result.value());
+            value = result.value();
+            _pPlot->graph(i)->addData(timeData, value);
+        }
+        else if (result.state() == ResultState::State::NO_VALUE)
+        {
+            // Graph isn't polled this time, repeat last value in data file
+            auto pData = _pPlot->graph(i)->data();
+            value = pData->isEmpty() ? 0 : (pData->constEnd() - 1)->value;
         }
         else
         {
-            _pPlot->graph(i)->addData(timeData, 0);
-            dataList.append(0);
+            value = 0;
+            _pPlot->graph(i)->addData(timeData, value);
         }
-        i++;
+
+        dataList.setResult(i, ResultDouble(value, ResultState::State::SUCCESS));
     }
 
     emit dataAddedToPlot(timeData, dataList);
@@ -3,7 +3,7 @@
 
 #include <QObject>
 
-#include "result.h"
+#include "sampleframe.h"
 #include "scopeplot.h"
 #include "graphdata.h"
 
@@ -47,12 +47,12 @@ public slots:
     void addData(QList<double> timeData, QList<QList<double> > data);
     void handleGraphVisibilityChange(quint32 graphIdx);
     void rescalePlot();
-    void plotResults(ResultDoubleList resultList);
+    void plotResults(SampleFrame resultList);
     void clearResults();
 
 signals:
     void cursorValueUpdate();
-    void dataAddedToPlot(double timeData, QList<double> dataList);
+    void dataAddedToPlot(double timeData, SampleFrame dataList);
     void afterGraphUpdate();
 
 private slots:
@@ -40,9 +40,9 @@ void DataFileExporter::disableExporterDuringLog()
     flushExportBuffer();
 }
 
-void DataFileExporter::exportDataLine(double timeData, QList <double> dataValues)
+void DataFileExporter::exportDataLine(double timeData, SampleFrame dataValues)
 {
-    /* QList correspond with activeGraphList */
+    /* Frame correspond with activeGraphList */
 
     if (_pSettingsModel->writeDuringLog())
     {
@@ -295,7 +295,7 @@ QStringList DataFileExporter::constructDataHeader(bool bDuringLog)
         }
 
         // Export communication settings
-        for (quint8 i = 0u; i < Connection::ID_CNT; i++)
+        for (quint8 i = 0u; i < _pSettingsModel->connectionCount(); i++)
         {
             if (_pSettingsModel->connectionState(i))
             {
@@ -342,6 +342,10 @@ QString DataFileExporter::constructConnSettings(quint8 connectionId)
     {
         strSettings = _pSettingsModel->ipAddress(connectionId) + ":" + QString::number(_pSettingsModel->port(connectionId));
     }
+    else if (_pSettingsModel->connectionType(connectionId) == Connection::TYPE_UDP)
+    {
+        strSettings = "udp://" + _pSettingsModel->ipAddress(connectionId) + ":" + QString::number(_pSettingsModel->port(connectionId));
+    }
     else
     {
         QString strParity;
@@ -461,30 +465,45 @@ QString DataFileExporter::createPropertyRow(registerProperty prop)
 
 QString DataFileExporter::formatData(double timeData, QList<double> dataValues)
 {
-    QString line;
+    QString line = formatTime(timeData);
 
-    if (_pSettingsModel->absoluteTimes())
-    {
-        QDateTime dateTime;
-        dateTime.setMSecsSinceEpoch(timeData);
-        line.append(FormatDateTime::formatDateTime(dateTime));
-    }
-    else
+    // Add formatted data (maximum 3 decimals, no trailing zeros)
+    for(qint32 d = 0; d < dataValues.size(); d++)
     {
-        // Format time (no decimals)
-        const quint64 t = static_cast<quint64>(timeData);
-        line.append(QString::number(t, 'f', 0));
+        line.append(Util::separatorCharacter() + Util::formatDoubleForExport(dataValues[d]));
     }
 
+    return line;
+}
+
+QString DataFileExporter::formatData(double timeData, const SampleFrame& dataValues)
+{
+    QString line = formatTime(timeData);
+
     // Add formatted data (maximum 3 decimals, no trailing zeros)
-    for(qint32 d = 0; d < dataValues.size(); d++)
+    for (const ResultDouble& result : dataValues)
     {
-        line.append(Util::separatorCharacter() + Util::formatDoubleForExport(dataValues[d]));
+        line.append(Util::separatorCharacter() + Util::formatDoubleForExport(result.value()));
     }
 
     return line;
 }
 
+QString DataFileExporter::formatTime(double timeData)
+{
+    if (_pSettingsModel->absoluteTimes())
+    {
+        QDateTime dateTime;
+        dateTime.setMSecsSinceEpoch(timeData);
+        return FormatDateTime::formatDateTime(dateTime);
+    }
+    else
+    {
+        // Format time (in ms, µs as decimals)
+        return Util::formatDoubleForExport(timeData);
+    }
+}
+
 bool DataFileExporter::writeToFile(QString filePath, QStringList logData)
 {
     bool bRet = false;
@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QStringList>
 
+#include "sampleframe.h"
+
 /* Forward declaration */
 class SettingsModel;
 class GraphDataModel;
@@ -25,7 +27,7 @@ public:
 signals:
 
 public slots:
-    void exportDataLine(double timeData, QList <double> dataValues);
+    void exportDataLine(double timeData, SampleFrame dataValues);
     void rewriteDataFile(void);
 
 private:
@@ -47,6 +49,8 @@ private:
     void createNoteRows(QStringList& noteRows);
     QString createPropertyRow(registerProperty prop);
     QString formatData(double timeData, QList<double> dataValues);
+    QString formatData(double timeData, const SampleFrame& dataValues);
+    QString formatTime(double timeData);
     bool writeToFile(QString filePath, QStringList logData);
     void clearFile(QString filePath);
 
@@ -151,7 +151,7 @@ void DataFileHandler::selectDataExportFile()
     }
 }
 
-void DataFileHandler::exportDataLine(double timeData, QList <double> dataValues)
+void DataFileHandler::exportDataLine(double timeData, SampleFrame dataValues)
 {
     _pDataFileExporter->exportDataLine(timeData, dataValues);
 }
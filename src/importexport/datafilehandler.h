@@ -33,7 +33,7 @@ public slots:
     void selectDataImportFile();
     void selectDataExportFile();
 
-    void exportDataLine(double timeData, QList <double> dataValues);
+    void exportDataLine(double timeData, SampleFrame dataValues);
     void rewriteDataFile(void);
 
     void parseDataFile();
@@ -19,6 +19,8 @@ namespace ProjectFileData
 
         quint32 valueAxis = 0;
 
+        quint32 pollInterval = 0;
+
     } RegisterSettings;
 
     typedef struct
@@ -60,6 +62,12 @@ namespace ProjectFileData
         bool bPollTime = false;
         quint32 pollTime;
 
+        quint8 maxConcurrentConnections = 0;
+
+        bool bNativeEngine = false;
+
+        bool bOnDemandPolling = false;
+
         bool bAbsoluteTimes = false;
 
         bool bLogToFile = true;
@@ -108,10 +116,27 @@ namespace ProjectFileData
         bool bConsecutiveMax = false;
         quint8 consecutiveMax;
 
+        bool bRequestWindow = false;
+        quint8 requestWindow;
+
         bool bInt32LittleEndian = true;
 
         bool bPersistentConnection = true;
 
+        bool bLingerTime = false;
+        quint32 lingerTime;
+
+        bool bInterFrameDelay = false;
+        quint32 interFrameDelay;
+
+        bool bTurnaroundDelay = false;
+        quint32 turnaroundDelay;
+
+        bool bAdaptiveTimeout = false;
+
+        bool bRetries = false;
+        quint8 retries;
+
     } ConnectionSettings;
 
     typedef struct _GeneralSettings
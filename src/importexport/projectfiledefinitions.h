@@ -26,9 +26,18 @@ namespace ProjectFileDefinitions
     const char cStopBitsTag[] = "stopbits";
     const char cTimeoutTag[] = "timeout";
     const char cConsecutiveMaxTag[] = "consecutivemax";
+    const char cRequestWindowTag[] = "requestwindow";
     const char cInt32LittleEndianTag[] = "int32littleendian";
     const char cPersistentConnectionTag[] = "persistentconnection";
+    const char cLingerTimeTag[] = "lingertime";
+    const char cInterFrameDelayTag[] = "interframedelay";
+    const char cTurnaroundDelayTag[] = "turnarounddelay";
+    const char cAdaptiveTimeoutTag[] = "adaptivetimeout";
+    const char cRetriesTag[] = "retries";
     const char cPollTimeTag[] = "polltime";
+    const char cMaxConcurrentConnectionsTag[] = "maxconcurrentconnections";
+    const char cNativeEngineTag[] = "nativeengine";
+    const char cOnDemandPollingTag[] = "ondemandpolling";
     const char cAbsoluteTimesTag[] = "absolutetimes";
     const char cLogToFileTag[] = "logtofile";
     const char cFilenameTag[] = "filename";
@@ -37,6 +46,7 @@ namespace ProjectFileDefinitions
     const char cExpressionTag[] = "expression";
     const char cColorTag[] = "color";
     const char cValueAxisTag[] = "valueaxis";
+    const char cPollIntervalTag[] = "pollinterval";
 
     const char cScaleTag[] = "scale";
     const char cXaxisTag[] = "xaxis";
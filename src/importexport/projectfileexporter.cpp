@@ -66,7 +66,7 @@ void ProjectFileExporter::createModbusTag(QDomElement * pParentElement)
 
 void ProjectFileExporter::createConnectionTags(QDomElement * pParentElement)
 {
-    for (quint8 i = 0u; i < Connection::ID_CNT; i++)
+    for (quint8 i = 0u; i < _pSettingsModel->connectionCount(); i++)
     {
         QDomElement connectionElement = _domDocument.createElement(ProjectFileDefinitions::cConnectionTag);
 
@@ -78,6 +78,10 @@ void ProjectFileExporter::createConnectionTags(QDomElement * pParentElement)
         {
             addTextNode(ProjectFileDefinitions::cConnectionTypeTag, QString("tcp"), &connectionElement);
         }
+        else if (_pSettingsModel->connectionType(i) == Connection::TYPE_UDP)
+        {
+            addTextNode(ProjectFileDefinitions::cConnectionTypeTag, QString("udp"), &connectionElement);
+        }
         else
         {
             addTextNode(ProjectFileDefinitions::cConnectionTypeTag, QString("serial"), &connectionElement);
@@ -96,8 +100,14 @@ void ProjectFileExporter::createConnectionTags(QDomElement * pParentElement)
         addTextNode(ProjectFileDefinitions::cSlaveIdTag, QString("%1").arg(_pSettingsModel->slaveId(i)), &connectionElement);
         addTextNode(ProjectFileDefinitions::cTimeoutTag, QString("%1").arg(_pSettingsModel->timeout(i)), &connectionElement);
         addTextNode(ProjectFileDefinitions::cConsecutiveMaxTag, QString("%1").arg(_pSettingsModel->consecutiveMax(i)), &connectionElement);
+        addTextNode(ProjectFileDefinitions::cRequestWindowTag, QString("%1").arg(_pSettingsModel->requestWindow(i)), &connectionElement);
         addTextNode(ProjectFileDefinitions::cInt32LittleEndianTag, convertBoolToText(_pSettingsModel->int32LittleEndian(i)), &connectionElement);
         addTextNode(ProjectFileDefinitions::cPersistentConnectionTag, convertBoolToText(_pSettingsModel->persistentConnection(i)), &connectionElement);
+        addTextNode(ProjectFileDefinitions::cLingerTimeTag, QString("%1").arg(_pSettingsModel->lingerTime(i)), &connectionElement);
+        addTextNode(ProjectFileDefinitions::cInterFrameDelayTag, QString("%1").arg(_pSettingsModel->interFrameDelay(i)), &connectionElement);
+        addTextNode(ProjectFileDefinitions::cTurnaroundDelayTag, QString("%1").arg(_pSettingsModel->turnaroundDelay(i)), &connectionElement);
+        addTextNode(ProjectFileDefinitions::cAdaptiveTimeoutTag, convertBoolToText(_pSettingsModel->adaptiveTimeout(i)), &connectionElement);
+        addTextNode(ProjectFileDefinitions::cRetriesTag, QString("%1").arg(_pSettingsModel->retries(i)), &connectionElement);
 
         pParentElement->appendChild(connectionElement);
     }
@@ -108,6 +118,9 @@ void ProjectFileExporter::createLogTag(QDomElement * pParentElement)
     QDomElement logElement = _domDocument.createElement(ProjectFileDefinitions::cLogTag);
 
     addTextNode(ProjectFileDefinitions::cPollTimeTag, QString("%1").arg(_pSettingsModel->pollTime()), &logElement);
+    addTextNode(ProjectFileDefinitions::cMaxConcurrentConnectionsTag, QString("%1").arg(_pSettingsModel->maxConcurrentConnections()), &logElement);
+    addTextNode(ProjectFileDefinitions::cNativeEngineTag, convertBoolToText(_pSettingsModel->nativeEngine()), &logElement);
+    addTextNode(ProjectFileDefinitions::cOnDemandPollingTag, convertBoolToText(_pSettingsModel->onDemandPolling()), &logElement);
     addTextNode(ProjectFileDefinitions::cAbsoluteTimesTag, convertBoolToText(_pSettingsModel->absoluteTimes()), &logElement);
 
     /* Create logtofile tag */
@@ -149,6 +162,11 @@ void ProjectFileExporter::createRegisterTag(QDomElement * pParentElement, qint32
     addTextNode(ProjectFileDefinitions::cColorTag, _pGraphDataModel->color(idx).name(), &registerElement);
     addTextNode(ProjectFileDefinitions::cValueAxisTag, QString("%1").arg(_pGraphDataModel->valueAxis(idx)), &registerElement);
 
+    if (_pGraphDataModel->pollInterval(idx) != 0)
+    {
+        addTextNode(ProjectFileDefinitions::cPollIntervalTag, QString("%1").arg(_pGraphDataModel->pollInterval(idx)), &registerElement);
+    }
+
     pParentElement->appendChild(registerElement);
 }
 
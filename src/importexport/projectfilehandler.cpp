@@ -96,6 +96,19 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
 {
     const int connCnt = pProjectSettings->general.connectionSettings.size();
 
+    /* Number of connections follows the highest connection id of the project */
+    quint8 connectionCount = Connection::cDefaultCount;
+    for(int idx = 0; idx < connCnt; idx++)
+    {
+        const auto& connectionSettings = pProjectSettings->general.connectionSettings[idx];
+        if (connectionSettings.bConnectionId && (connectionSettings.connectionId >= connectionCount))
+        {
+            /* Parser only accepts ids below cMaxCount */
+            connectionCount = static_cast<quint8>(connectionSettings.connectionId + 1);
+        }
+    }
+    _pSettingsModel->setConnectionCount(connectionCount);
+
     for(int idx = 0; idx < connCnt; idx++)
     {
         quint8 connectionId;
@@ -110,7 +123,7 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
             connectionId = Connection::ID_1;
         }
 
-        if (connectionId < Connection::ID_CNT)
+        if (connectionId < _pSettingsModel->connectionCount())
         {
             _pSettingsModel->setConnectionState(connectionId, pProjectSettings->general.connectionSettings[idx].bConnectionState);
 
@@ -120,6 +133,12 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
             {
                 _pSettingsModel->setConnectionType(connectionId, Connection::TYPE_SERIAL);
             }
+            else if (pProjectSettings->general.connectionSettings[idx].bConnectionType
+                     && pProjectSettings->general.connectionSettings[idx].connectionType.toLower() == "udp"
+                     )
+            {
+                _pSettingsModel->setConnectionType(connectionId, Connection::TYPE_UDP);
+            }
             else
             {
                 _pSettingsModel->setConnectionType(connectionId, Connection::TYPE_TCP);
@@ -154,7 +173,7 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
                     || detectedBaud == QSerialPort::Baud115200
                 )
                 {
-                    _pSettingsModel->setBaudrate(idx, static_cast<QSerialPort::BaudRate>(detectedBaud));
+                    _pSettingsModel->setBaudrate(connectionId, static_cast<QSerialPort::BaudRate>(detectedBaud));
                 }
             }
 
@@ -167,7 +186,7 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
                     || detectedParity == QSerialPort::OddParity
                 )
                 {
-                    _pSettingsModel->setParity(idx, static_cast<QSerialPort::Parity>(detectedParity));
+                    _pSettingsModel->setParity(connectionId, static_cast<QSerialPort::Parity>(detectedParity));
                 }
             }
 
@@ -180,7 +199,7 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
                     || detectedStopBits == QSerialPort::TwoStop
                 )
                 {
-                    _pSettingsModel->setStopbits(idx, static_cast<QSerialPort::StopBits>(detectedStopBits));
+                    _pSettingsModel->setStopbits(connectionId, static_cast<QSerialPort::StopBits>(detectedStopBits));
                 }
             }
 
@@ -194,7 +213,7 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
                     || detectedDataBits == QSerialPort::Data8
                 )
                 {
-                    _pSettingsModel->setDatabits(idx, static_cast<QSerialPort::DataBits>(detectedDataBits));
+                    _pSettingsModel->setDatabits(connectionId, static_cast<QSerialPort::DataBits>(detectedDataBits));
                 }
             }
 
@@ -213,9 +232,36 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
                 _pSettingsModel->setConsecutiveMax(connectionId, pProjectSettings->general.connectionSettings[idx].consecutiveMax);
             }
 
+            if (pProjectSettings->general.connectionSettings[idx].bRequestWindow)
+            {
+                _pSettingsModel->setRequestWindow(connectionId, pProjectSettings->general.connectionSettings[idx].requestWindow);
+            }
+
             _pSettingsModel->setInt32LittleEndian(connectionId, pProjectSettings->general.connectionSettings[idx].bInt32LittleEndian);
 
             _pSettingsModel->setPersistentConnection(connectionId, pProjectSettings->general.connectionSettings[idx].bPersistentConnection);
+
+            if (pProjectSettings->general.connectionSettings[idx].bLingerTime)
+            {
+                _pSettingsModel->setLingerTime(connectionId, pProjectSettings->general.connectionSettings[idx].lingerTime);
+            }
+
+            if (pProjectSettings->general.connectionSettings[idx].bInterFrameDelay)
+            {
+                _pSettingsModel->setInterFrameDelay(connectionId, pProjectSettings->general.connectionSettings[idx].interFrameDelay);
+            }
+
+            if (pProjectSettings->general.connectionSettings[idx].bTurnaroundDelay)
+            {
+                _pSettingsModel->setTurnaroundDelay(connectionId, pProjectSettings->general.connectionSettings[idx].turnaroundDelay);
+            }
+
+            _pSettingsModel->setAdaptiveTimeout(connectionId, pProjectSettings->general.connectionSettings[idx].bAdaptiveTimeout);
+
+            if (pProjectSettings->general.connectionSettings[idx].bRetries)
+            {
+                _pSettingsModel->setRetries(connectionId, pProjectSettings->general.connectionSettings[idx].retries);
+            }
         }
     }
 
@@ -224,6 +270,12 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
         _pSettingsModel->setPollTime(pProjectSettings->general.logSettings.pollTime);
     }
 
+    _pSettingsModel->setMaxConcurrentConnections(pProjectSettings->general.logSettings.maxConcurrentConnections);
+
+    _pSettingsModel->setNativeEngine(pProjectSettings->general.logSettings.bNativeEngine);
+
+    _pSettingsModel->setOnDemandPolling(pProjectSettings->general.logSettings.bOnDemandPolling);
+
     _pSettingsModel->setAbsoluteTimes(pProjectSettings->general.logSettings.bAbsoluteTimes);
 
     _pSettingsModel->setWriteDuringLog(pProjectSettings->general.logSettings.bLogToFile);
@@ -287,6 +339,7 @@ void ProjectFileHandler::updateProjectSetting(ProjectFileData::ProjectSettings *
         rowData.setColor(pSettingData->color);
         rowData.setValueAxis(pSettingData->valueAxis == 1 ? GraphData::VALUE_AXIS_SECONDARY : GraphData::VALUE_AXIS_PRIMARY);
         rowData.setExpression(pSettingData->expression);
+        rowData.setPollInterval(pSettingData->pollInterval);
 
         _pGraphDataModel->add(rowData);
     }
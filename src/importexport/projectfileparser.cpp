@@ -3,6 +3,7 @@
 #include <QDir>
 #include "projectfileparser.h"
 #include "projectfiledefinitions.h"
+#include "connectiontypes.h"
 
 using ProjectFileData::ProjectSettings;
 using ProjectFileData::ConnectionSettings;
@@ -161,12 +162,13 @@ GeneralError ProjectFileParser::parseConnectionTag(const QDomElement &element, C
         if (child.tagName() == ProjectFileDefinitions::cConnectionIdTag)
         {
             pConnectionSettings->bConnectionId = true;
-            pConnectionSettings->connectionId = static_cast<quint8>(child.text().toUInt(&bRet));
-            if (!bRet)
+            const quint32 connectionId = child.text().toUInt(&bRet);
+            if (!bRet || (connectionId >= Connection::cMaxCount))
             {
-                parseErr.reportError(QString("Connection Id (%1) is not a valid number").arg(child.text()));
+                parseErr.reportError(QString("Connection Id (%1) is not a valid integer between 0 and %2").arg(child.text()).arg(Connection::cMaxCount - 1));
                 break;
             }
+            pConnectionSettings->connectionId = static_cast<quint8>(connectionId);
         }
         else if (child.tagName() == ProjectFileDefinitions::cConnectionEnabledTag)
         {
@@ -274,6 +276,16 @@ GeneralError ProjectFileParser::parseConnectionTag(const QDomElement &element, C
                 break;
             }
         }
+        else if (child.tagName() == ProjectFileDefinitions::cRequestWindowTag)
+        {
+            pConnectionSettings->bRequestWindow = true;
+            pConnectionSettings->requestWindow = static_cast<quint8>(child.text().toUInt(&bRet));
+            if (!bRet)
+            {
+                parseErr.reportError(QString("Outstanding request maximum ( %1 ) is not a valid number").arg(child.text()));
+                break;
+            }
+        }
         else if (child.tagName() == ProjectFileDefinitions::cInt32LittleEndianTag)
         {
             if (!child.text().toLower().compare(ProjectFileDefinitions::cTrueValue))
@@ -296,6 +308,57 @@ GeneralError ProjectFileParser::parseConnectionTag(const QDomElement &element, C
                 pConnectionSettings->bPersistentConnection = false;
             }
         }
+        else if (child.tagName() == ProjectFileDefinitions::cLingerTimeTag)
+        {
+            pConnectionSettings->bLingerTime = true;
+            pConnectionSettings->lingerTime = child.text().toUInt(&bRet);
+            if (!bRet)
+            {
+                parseErr.reportError(QString("Linger time ( %1 ) is not a valid number").arg(child.text()));
+                break;
+            }
+        }
+        else if (child.tagName() == ProjectFileDefinitions::cInterFrameDelayTag)
+        {
+            pConnectionSettings->bInterFrameDelay = true;
+            pConnectionSettings->interFrameDelay = child.text().toUInt(&bRet);
+            if (!bRet)
+            {
+                parseErr.reportError(QString("Inter-frame delay ( %1 ) is not a valid number").arg(child.text()));
+                break;
+            }
+        }
+        else if (child.tagName() == ProjectFileDefinitions::cTurnaroundDelayTag)
+        {
+            pConnectionSettings->bTurnaroundDelay = true;
+            pConnectionSettings->turnaroundDelay = child.text().toUInt(&bRet);
+            if (!bRet)
+            {
+                parseErr.reportError(QString("Turnaround delay ( %1 ) is not a valid number").arg(child.text()));
+                break;
+            }
+        }
+        else if (child.tagName() == ProjectFileDefinitions::cAdaptiveTimeoutTag)
+        {
+            if (!child.text().toLower().compare(ProjectFileDefinitions::cTrueValue))
+            {
+                pConnectionSettings->bAdaptiveTimeout = true;
+            }
+            else
+            {
+                pConnectionSettings->bAdaptiveTimeout = false;
+            }
+        }
+        else if (child.tagName() == ProjectFileDefinitions::cRetriesTag)
+        {
+            pConnectionSettings->bRetries = true;
+            pConnectionSettings->retries = static_cast<quint8>(child.text().toUInt(&bRet));
+            if (!bRet)
+            {
+                parseErr.reportError(QString("Retries ( %1 ) is not a valid number").arg(child.text()));
+                break;
+            }
+        }
         else
         {
             // unknown tag: ignore
@@ -323,6 +386,39 @@ GeneralError ProjectFileParser::parseLogTag(const QDomElement &element, LogSetti
                 break;
             }
         }
+        else if (child.tagName() == ProjectFileDefinitions::cMaxConcurrentConnectionsTag)
+        {
+            bool bRet;
+            const quint32 maxConcurrent = child.text().toUInt(&bRet);
+            if (!bRet || (maxConcurrent > Connection::cMaxCount))
+            {
+                parseErr.reportError(QString("Maximum concurrent connections ( %1 ) is not a valid number").arg(child.text()));
+                break;
+            }
+            pLogSettings->maxConcurrentConnections = static_cast<quint8>(maxConcurrent);
+        }
+        else if (child.tagName() == ProjectFileDefinitions::cNativeEngineTag)
+        {
+            if (!child.text().toLower().compare(ProjectFileDefinitions::cTrueValue))
+            {
+                pLogSettings->bNativeEngine = true;
+            }
+            else
+            {
+                pLogSettings->bNativeEngine = false;
+            }
+        }
+        else if (child.tagName() == ProjectFileDefinitions::cOnDemandPollingTag)
+        {
+            if (!child.text().toLower().compare(ProjectFileDefinitions::cTrueValue))
+            {
+                pLogSettings->bOnDemandPolling = true;
+            }
+            else
+            {
+                pLogSettings->bOnDemandPolling = false;
+            }
+        }
         else if (child.tagName() == ProjectFileDefinitions::cAbsoluteTimesTag)
         {
             if (!child.text().toLower().compare(ProjectFileDefinitions::cTrueValue))
@@ -506,9 +602,9 @@ GeneralError ProjectFileParser::parseRegisterTag(const QDomElement &element, Reg
                 (bRet)
                 &&
                 (
-                    (newConnectionId != 0)
-                    &&
-                    (newConnectionId != 1)
+                    (newConnectionId < 0)
+                    ||
+                    (newConnectionId >= Connection::cMaxCount)
                 )
             )
             {
@@ -521,7 +617,7 @@ GeneralError ProjectFileParser::parseRegisterTag(const QDomElement &element, Reg
             }
             else
             {
-                parseErr.reportError(QString("Connection id (%1) is not a valid integer between 0 and 1.").arg(child.text()));
+                parseErr.reportError(QString("Connection id (%1) is not a valid integer between 0 and %2.").arg(child.text()).arg(Connection::cMaxCount - 1));
                 break;
             }
         }
@@ -529,6 +625,15 @@ GeneralError ProjectFileParser::parseRegisterTag(const QDomElement &element, Reg
         {
             pRegisterSettings->expression = child.text();
         }
+        else if (child.tagName() == ProjectFileDefinitions::cPollIntervalTag)
+        {
+            pRegisterSettings->pollInterval = child.text().toUInt(&bRet);
+            if (!bRet)
+            {
+                parseErr.reportError(QString("Poll interval ( %1 ) is not a valid number").arg(child.text()));
+                break;
+            }
+        }
         else
         {
             // unknown tag: ignore
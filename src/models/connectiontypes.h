@@ -1,6 +1,8 @@
 #ifndef CONNECTION_TYPES_H
 #define CONNECTION_TYPES_H
 
+#include <QtGlobal>
+
 namespace Connection
 {
     enum
@@ -8,13 +10,19 @@ namespace Connection
         ID_1 = 0,
         ID_2,
         ID_3,
-        ID_CNT
     };
 
+    /* Number of connections is dynamic, these are available by default */
+    const quint8 cDefaultCount = 3;
+
+    /* Connection ids are stored in a quint8, valid ids are 0 up to cMaxCount - 1 */
+    const quint8 cMaxCount = 255;
+
     typedef enum
     {
         TYPE_TCP = 0,
         TYPE_SERIAL,
+        TYPE_UDP,
         TYPE_CNT
     } type_t;
 
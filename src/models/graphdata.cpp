@@ -11,6 +11,7 @@ GraphData::GraphData()
     _bActive = true;
     _expression = QStringLiteral("0");
     _expressionStatus = ExpressionStatus::UNKNOWN;
+    _pollInterval = 0; // Use poll time of log settings
 
     _pDataMap = QSharedPointer<QCPGraphDataContainer>(new QCPGraphDataContainer);
 }
@@ -97,6 +98,16 @@ void GraphData::setExpressionStatus(GraphData::ExpressionStatus status)
     _expressionStatus = status;
 }
 
+quint32 GraphData::pollInterval() const
+{
+    return _pollInterval;
+}
+
+void GraphData::setPollInterval(quint32 pollInterval)
+{
+    _pollInterval = pollInterval;
+}
+
 QSharedPointer<QCPGraphDataContainer> GraphData::dataMap()
 {
     return _pDataMap;
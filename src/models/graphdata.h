@@ -47,6 +47,9 @@ public:
     ExpressionStatus expressionStatus() const;
     void setExpressionStatus(ExpressionStatus status);
 
+    quint32 pollInterval() const;
+    void setPollInterval(quint32 pollInterval);
+
     QSharedPointer<QCPGraphDataContainer> dataMap();
 
 private:
@@ -59,6 +62,7 @@ private:
     bool _bActive;
     QString _expression;
     ExpressionStatus _expressionStatus;
+    quint32 _pollInterval;
 
     QSharedPointer<QCPGraphDataContainer> _pDataMap;
 
@@ -1,6 +1,7 @@
 
 #include "graphdata.h"
 #include "util.h"
+#include "acquisitionclock.h"
 
 #include "graphdatamodel.h"
 
@@ -13,6 +14,9 @@ GraphDataModel::GraphDataModel(QObject *parent) : QAbstractTableModel(parent)
     _endTime = 0;
     _successCount = 0;
     _errorCount = 0;
+    _medianPollTime = 0;
+    _missedPollCount = 0;
+    _achievedPollPeriod = 0;
 
     connect(this, &GraphDataModel::visibilityChanged, this, &GraphDataModel::modelDataChanged);
     connect(this, &GraphDataModel::labelChanged, this, &GraphDataModel::modelDataChanged);
@@ -345,6 +349,11 @@ GraphData::ExpressionStatus GraphDataModel::expressionStatus(quint32 index) cons
     return _graphData[index].expressionStatus();
 }
 
+quint32 GraphDataModel::pollInterval(quint32 index) const
+{
+    return _graphData[index].pollInterval();
+}
+
 QString GraphDataModel::simplifiedExpression(quint32 index) const
 {
     return _graphData[index].expression().simplified();
@@ -402,6 +411,26 @@ void GraphDataModel::setMedianPollTime(quint32 pollTime)
     _medianPollTime = pollTime;
 }
 
+/*!
+ * Set timing of the poll schedule
+ * \param missedPollCount      Number of poll deadlines that were missed
+ * \param achievedPollPeriod   Achieved poll period (in ms)
+ */
+void GraphDataModel::setPollTiming(quint32 missedPollCount, double achievedPollPeriod)
+{
+    _missedPollCount = missedPollCount;
+    _achievedPollPeriod = achievedPollPeriod;
+}
+
+/*!
+ * Set connections of which the circuit breaker is tripped
+ * \param connectionList      Sorted list of connection ids
+ */
+void GraphDataModel::setTrippedConnections(QList<quint8> connectionList)
+{
+    _trippedConnections = connectionList;
+}
+
 quint32 GraphDataModel::communicationErrorCount()
 {
     return _errorCount;
@@ -414,7 +443,7 @@ quint32 GraphDataModel::communicationSuccessCount()
 
 qint64 GraphDataModel::communicationRunTime()
 {
-    return QDateTime::currentMSecsSinceEpoch() - communicationStartTime();
+    return AcquisitionClock::currentMSecsSinceEpoch() - communicationStartTime();
 }
 
 quint32 GraphDataModel::medianPollTime()
@@ -422,6 +451,21 @@ quint32 GraphDataModel::medianPollTime()
     return _medianPollTime;
 }
 
+quint32 GraphDataModel::missedPollCount()
+{
+    return _missedPollCount;
+}
+
+double GraphDataModel::achievedPollPeriod()
+{
+    return _achievedPollPeriod;
+}
+
+QList<quint8> GraphDataModel::trippedConnections()
+{
+    return _trippedConnections;
+}
+
 void GraphDataModel::setValueAxis(quint32 index, GraphData::valueAxis_t axis)
 {
     if (_graphData[index].valueAxis() != axis)
@@ -499,6 +543,15 @@ void GraphDataModel::setExpressionStatus(quint32 index, GraphData::ExpressionSta
     }
 }
 
+void GraphDataModel::setPollInterval(quint32 index, quint32 pollInterval)
+{
+    if (_graphData[index].pollInterval() != pollInterval)
+    {
+        _graphData[index].setPollInterval(pollInterval);
+        emit pollIntervalChanged(index);
+    }
+}
+
 void GraphDataModel::add(GraphData rowData)
 {
     addToModel(rowData);
@@ -50,6 +50,7 @@ public:
     bool isActive(quint32 index) const;
     QString expression(quint32 index) const;
     GraphData::ExpressionStatus expressionStatus(quint32 index) const;
+    quint32 pollInterval(quint32 index) const;
     QString simplifiedExpression(quint32 index) const;
     QSharedPointer<QCPGraphDataContainer> dataMap(quint32 index);
 
@@ -59,6 +60,9 @@ public:
     quint32 communicationSuccessCount();
     qint64 communicationRunTime();
     quint32 medianPollTime();
+    quint32 missedPollCount();
+    double achievedPollPeriod();
+    QList<quint8> trippedConnections();
 
     void setValueAxis(quint32 index, GraphData::valueAxis_t axis);
     void setVisible(quint32 index, bool bVisible);
@@ -67,11 +71,14 @@ public:
     void setActive(quint32 index, bool bActive);
     void setExpression(quint32 index, QString expression);
     void setExpressionStatus(quint32 index, GraphData::ExpressionStatus status);
+    void setPollInterval(quint32 index, quint32 pollInterval);
 
     void setCommunicationStartTime(qint64 startTime);
     void setCommunicationEndTime(qint64 endTime);
     void setCommunicationStats(quint32 successCount, quint32 errorCount);
     void setMedianPollTime(quint32 pollTime);
+    void setPollTiming(quint32 missedPollCount, double achievedPollPeriod);
+    void setTrippedConnections(QList<quint8> connectionList);
 
     void add(GraphData rowData);
     void add(QList<GraphData> graphDataList);
@@ -96,6 +103,7 @@ signals:
     void activeChanged(const quint32 graphIdx);
     void expressionChanged(const quint32 graphIdx);
     void expressionStatusChanged(const quint32 graphIdx);
+    void pollIntervalChanged(const quint32 graphIdx);
     void graphsAddData(QList<double>, QList<QList<double> > data);
 
     void communicationStatsChanged();
@@ -121,6 +129,9 @@ private:
     quint32 _successCount;
     quint32 _errorCount;
     quint32 _medianPollTime;
+    quint32 _missedPollCount;
+    double _achievedPollPeriod;
+    QList<quint8> _trippedConnections;
 
     QList<GraphData> _graphData;
     QList<quint32> _activeGraphList;
@@ -5,35 +5,18 @@ SettingsModel::SettingsModel(QObject *parent) :
     QObject(parent)
 {
 
-    for(quint8 i = 0; i < Connection::ID_CNT; i++)
+    for(quint8 i = 0; i < Connection::cDefaultCount; i++)
     {
-        ConnectionSettings connectionSettings;
-
-        connectionSettings.connectionType = Connection::TYPE_TCP;
-
-        connectionSettings.ipAddress = "127.0.0.1";
-        connectionSettings.port = 502;
-
-        connectionSettings.portName = QStringLiteral("COM1");
-        connectionSettings.parity = QSerialPort::NoParity;
-        connectionSettings.baudrate = QSerialPort::Baud115200;
-        connectionSettings.databits = QSerialPort::Data8;
-        connectionSettings.stopbits = QSerialPort::OneStop;
-
-        connectionSettings.slaveId = 1;
-        connectionSettings.timeout = 1000;
-        connectionSettings.consecutiveMax = 125;
-        connectionSettings.bConnectionState = false;
-        connectionSettings.bInt32LittleEndian = true;
-        connectionSettings.bPersistentConnection = true;
-
-        _connectionSettings.append(connectionSettings);
+        _connectionSettings.append(defaultConnectionSettings());
     }
 
     /* Connection 1 is always enabled */
     _connectionSettings[Connection::ID_1].bConnectionState = true;
 
     _pollTime = 250;
+    _maxConcurrentConnections = 0;
+    _bNativeEngine = false;
+    _bOnDemandPolling = false;
     _bAbsoluteTimes = false;
     _bWriteDuringLog = true;
     _writeDuringLogFile = SettingsModel::defaultLogPath();
@@ -44,14 +27,35 @@ SettingsModel::~SettingsModel()
 
 }
 
+/*!
+ * Copy all settings of another model, without emitting change signals
+ * Used to take a snapshot of the settings that stays constant during a log session
+ * \param other    Model to copy
+ */
+void SettingsModel::copySettings(const SettingsModel& other)
+{
+    _connectionSettings = other._connectionSettings;
+    _pollTime = other._pollTime;
+    _maxConcurrentConnections = other._maxConcurrentConnections;
+    _bNativeEngine = other._bNativeEngine;
+    _bOnDemandPolling = other._bOnDemandPolling;
+    _bAbsoluteTimes = other._bAbsoluteTimes;
+    _bWriteDuringLog = other._bWriteDuringLog;
+    _writeDuringLogFile = other._writeDuringLogFile;
+}
+
 void SettingsModel::triggerUpdate(void)
 {
     emit pollTimeChanged();
     emit writeDuringLogChanged();
     emit writeDuringLogFileChanged();
     emit absoluteTimesChanged();
+    emit maxConcurrentConnectionsChanged();
+    emit nativeEngineChanged();
+    emit onDemandPollingChanged();
+    emit connectionCountChanged();
 
-    for(quint8 i = 0; i < Connection::ID_CNT; i++)
+    for(quint8 i = 0; i < connectionCount(); i++)
     {
         emit ipChanged(i);
         emit portChanged(i);
@@ -67,9 +71,15 @@ void SettingsModel::triggerUpdate(void)
         emit slaveIdChanged(i);
         emit timeoutChanged(i);
         emit consecutiveMaxChanged(i);
+        emit requestWindowChanged(i);
         emit connectionStateChanged(i);
         emit int32LittleEndianChanged(i);
         emit persistentConnectionChanged(i);
+        emit lingerTimeChanged(i);
+        emit interFrameDelayChanged(i);
+        emit turnaroundDelayChanged(i);
+        emit adaptiveTimeoutChanged(i);
+        emit retriesChanged(i);
     }
 }
 
@@ -87,6 +97,91 @@ quint32 SettingsModel::pollTime()
     return _pollTime;
 }
 
+/*!
+ * Set number of connections
+ * New connections get the default settings and are disabled, settings of removed connections are lost
+ * \param count    Number of connections (at least 1)
+ */
+void SettingsModel::setConnectionCount(quint8 count)
+{
+    count = qMax(count, static_cast<quint8>(1));
+
+    if (count != _connectionSettings.size())
+    {
+        while (_connectionSettings.size() < count)
+        {
+            _connectionSettings.append(defaultConnectionSettings());
+        }
+
+        _connectionSettings.resize(count);
+
+        emit connectionCountChanged();
+    }
+}
+
+quint8 SettingsModel::connectionCount() const
+{
+    return static_cast<quint8>(_connectionSettings.size());
+}
+
+/*!
+ * Set maximum number of connections that are polled at the same time
+ * Other connections wait until a poll is done.
+ * \param max      Maximum number of connections (0 is no limit)
+ */
+void SettingsModel::setMaxConcurrentConnections(quint8 max)
+{
+    if (_maxConcurrentConnections != max)
+    {
+        _maxConcurrentConnections = max;
+        emit maxConcurrentConnectionsChanged();
+    }
+}
+
+quint8 SettingsModel::maxConcurrentConnections() const
+{
+    return _maxConcurrentConnections;
+}
+
+/*!
+ * Select engine of the connections
+ * The native engine builds and parses the Modbus frames itself, instead of using a reply object per request
+ * \param bNative      True to use the native engine
+ */
+void SettingsModel::setNativeEngine(bool bNative)
+{
+    if (_bNativeEngine != bNative)
+    {
+        _bNativeEngine = bNative;
+        emit nativeEngineChanged();
+    }
+}
+
+bool SettingsModel::nativeEngine() const
+{
+    return _bNativeEngine;
+}
+
+/*!
+ * Select which registers are polled
+ * In on-demand mode, registers that are only used by hidden graphs aren't polled while the graphs
+ * aren't written to a file during logging
+ * \param bOnDemand    True to only poll registers of visible or recorded graphs
+ */
+void SettingsModel::setOnDemandPolling(bool bOnDemand)
+{
+    if (_bOnDemandPolling != bOnDemand)
+    {
+        _bOnDemandPolling = bOnDemand;
+        emit onDemandPollingChanged();
+    }
+}
+
+bool SettingsModel::onDemandPolling() const
+{
+    return _bOnDemandPolling;
+}
+
 void SettingsModel::setAbsoluteTimes(bool bAbsolute)
 {
     if (_bAbsoluteTimes != bAbsolute)
@@ -103,7 +198,7 @@ bool SettingsModel::absoluteTimes()
 
 void SettingsModel::setConsecutiveMax(quint8 connectionId, quint8 max)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].consecutiveMax != max)
     {
@@ -114,14 +209,32 @@ void SettingsModel::setConsecutiveMax(quint8 connectionId, quint8 max)
 
 quint8 SettingsModel::consecutiveMax(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].consecutiveMax;
 }
 
+void SettingsModel::setRequestWindow(quint8 connectionId, quint8 window)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    if (_connectionSettings[connectionId].requestWindow != window)
+    {
+        _connectionSettings[connectionId].requestWindow = window;
+        emit requestWindowChanged(connectionId);
+    }
+}
+
+quint8 SettingsModel::requestWindow(quint8 connectionId)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    return _connectionSettings[connectionId].requestWindow;
+}
+
 void SettingsModel::setConnectionState(quint8 connectionId, bool bState)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     /* Connection 1 can't be disabled */
     if (connectionId == Connection::ID_1)
@@ -139,14 +252,14 @@ void SettingsModel::setConnectionState(quint8 connectionId, bool bState)
 
 bool SettingsModel::connectionState(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].bConnectionState;
 }
 
 void SettingsModel::setInt32LittleEndian(quint8 connectionId, bool int32LittleEndian)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].bInt32LittleEndian != int32LittleEndian)
     {
@@ -157,14 +270,14 @@ void SettingsModel::setInt32LittleEndian(quint8 connectionId, bool int32LittleEn
 
 bool SettingsModel::int32LittleEndian(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].bInt32LittleEndian;
 }
 
 void SettingsModel::setPersistentConnection(quint8 connectionId, bool persistentConnection)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].bPersistentConnection != persistentConnection)
     {
@@ -175,11 +288,129 @@ void SettingsModel::setPersistentConnection(quint8 connectionId, bool persistent
 
 bool SettingsModel::persistentConnection(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].bPersistentConnection;
 }
 
+/*!
+ * Set linger time of a connection that isn't persistent
+ * An idle connection is kept open for the linger time after a poll, so the next poll can reuse it
+ * \param connectionId    Connection id
+ * \param lingerTime      Linger time (in ms), 0 closes the connection after every poll
+ */
+void SettingsModel::setLingerTime(quint8 connectionId, quint32 lingerTime)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    if (_connectionSettings[connectionId].lingerTime != lingerTime)
+    {
+        _connectionSettings[connectionId].lingerTime = lingerTime;
+        emit lingerTimeChanged(connectionId);
+    }
+}
+
+quint32 SettingsModel::lingerTime(quint8 connectionId)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    return _connectionSettings[connectionId].lingerTime;
+}
+
+/*!
+ * Set inter-frame delay of serial connection
+ * \param connectionId        Connection id
+ * \param interFrameDelay     Silent interval between frames (in µs), 0 for the default of the standard (3.5 characters)
+ */
+void SettingsModel::setInterFrameDelay(quint8 connectionId, quint32 interFrameDelay)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    if (_connectionSettings[connectionId].interFrameDelay != interFrameDelay)
+    {
+        _connectionSettings[connectionId].interFrameDelay = interFrameDelay;
+        emit interFrameDelayChanged(connectionId);
+    }
+}
+
+quint32 SettingsModel::interFrameDelay(quint8 connectionId)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    return _connectionSettings[connectionId].interFrameDelay;
+}
+
+/*!
+ * Set turnaround delay of serial connection
+ * When connections share a serial port, the bus is kept silent for the turnaround delay before a request to another slave
+ * \param connectionId        Connection id
+ * \param turnaroundDelay     Turnaround delay (in ms), 0 to disable
+ */
+void SettingsModel::setTurnaroundDelay(quint8 connectionId, quint32 turnaroundDelay)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    if (_connectionSettings[connectionId].turnaroundDelay != turnaroundDelay)
+    {
+        _connectionSettings[connectionId].turnaroundDelay = turnaroundDelay;
+        emit turnaroundDelayChanged(connectionId);
+    }
+}
+
+quint32 SettingsModel::turnaroundDelay(quint8 connectionId)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    return _connectionSettings[connectionId].turnaroundDelay;
+}
+
+/*!
+ * Set whether request timeout adapts to the measured round-trip time
+ * The timeout setting is then the maximum request timeout
+ * \param connectionId        Connection id
+ * \param bAdaptiveTimeout    True to enable adaptive request timeout
+ */
+void SettingsModel::setAdaptiveTimeout(quint8 connectionId, bool bAdaptiveTimeout)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    if (_connectionSettings[connectionId].bAdaptiveTimeout != bAdaptiveTimeout)
+    {
+        _connectionSettings[connectionId].bAdaptiveTimeout = bAdaptiveTimeout;
+        emit adaptiveTimeoutChanged(connectionId);
+    }
+}
+
+bool SettingsModel::adaptiveTimeout(quint8 connectionId)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    return _connectionSettings[connectionId].bAdaptiveTimeout;
+}
+
+/*!
+ * Set number of times a request is repeated after a timeout
+ * \param connectionId        Connection id
+ * \param retries             Number of retries, 0 to fail immediately on a timeout
+ */
+void SettingsModel::setRetries(quint8 connectionId, quint8 retries)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    if (_connectionSettings[connectionId].retries != retries)
+    {
+        _connectionSettings[connectionId].retries = retries;
+        emit retriesChanged(connectionId);
+    }
+}
+
+quint8 SettingsModel::retries(quint8 connectionId)
+{
+    connectionId = clipConnectionId(connectionId);
+
+    return _connectionSettings[connectionId].retries;
+}
+
 void SettingsModel::setWriteDuringLog(bool bState)
 {
     if (_bWriteDuringLog != bState)
@@ -215,7 +446,7 @@ QString SettingsModel::writeDuringLogFile()
 
 void SettingsModel::setConnectionType(quint8 connectionId, Connection::type_t connectionType)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].connectionType != connectionType)
     {
@@ -226,14 +457,14 @@ void SettingsModel::setConnectionType(quint8 connectionId, Connection::type_t co
 
 Connection::type_t SettingsModel::connectionType(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].connectionType;
 }
 
 void SettingsModel::setPortName(quint8 connectionId, QString portName)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].portName != portName)
     {
@@ -244,14 +475,14 @@ void SettingsModel::setPortName(quint8 connectionId, QString portName)
 
 QString SettingsModel::portName(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].portName;
 }
 
 void SettingsModel::setParity(quint8 connectionId, QSerialPort::Parity parity)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].parity != parity)
     {
@@ -262,14 +493,14 @@ void SettingsModel::setParity(quint8 connectionId, QSerialPort::Parity parity)
 
 QSerialPort::Parity SettingsModel::parity(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].parity;
 }
 
 void SettingsModel::setBaudrate(quint8 connectionId, QSerialPort::BaudRate baudrate)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].baudrate != baudrate)
     {
@@ -280,14 +511,14 @@ void SettingsModel::setBaudrate(quint8 connectionId, QSerialPort::BaudRate baudr
 
 QSerialPort::BaudRate SettingsModel::baudrate(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].baudrate;
 }
 
 void SettingsModel::setDatabits(quint8 connectionId, QSerialPort::DataBits databits)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].databits != databits)
     {
@@ -298,14 +529,14 @@ void SettingsModel::setDatabits(quint8 connectionId, QSerialPort::DataBits datab
 
 QSerialPort::DataBits SettingsModel::databits(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].databits;
 }
 
 void SettingsModel::setStopbits(quint8 connectionId, QSerialPort::StopBits stopbits)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].stopbits != stopbits)
     {
@@ -316,14 +547,14 @@ void SettingsModel::setStopbits(quint8 connectionId, QSerialPort::StopBits stopb
 
 QSerialPort::StopBits SettingsModel::stopbits(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].stopbits;
 }
 
 void SettingsModel::setIpAddress(quint8 connectionId, QString ip)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].ipAddress != ip)
     {
@@ -334,14 +565,14 @@ void SettingsModel::setIpAddress(quint8 connectionId, QString ip)
 
 QString SettingsModel::ipAddress(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].ipAddress;
 }
 
 void SettingsModel::setPort(quint8 connectionId, quint16 port)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].port != port)
     {
@@ -352,21 +583,21 @@ void SettingsModel::setPort(quint8 connectionId, quint16 port)
 
 quint16 SettingsModel::port(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].port;
 }
 
 quint8 SettingsModel::slaveId(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].slaveId;
 }
 
 void SettingsModel::setSlaveId(quint8 connectionId, quint8 id)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].slaveId != id)
     {
@@ -377,14 +608,14 @@ void SettingsModel::setSlaveId(quint8 connectionId, quint8 id)
 
 quint32 SettingsModel::timeout(quint8 connectionId)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     return _connectionSettings[connectionId].timeout;
 }
 
 void SettingsModel::setTimeout(quint8 connectionId, quint32 timeout)
 {
-    clipConnectionId(connectionId);
+    connectionId = clipConnectionId(connectionId);
 
     if (_connectionSettings[connectionId].timeout != timeout)
     {
@@ -427,5 +658,36 @@ void SettingsModel::serialConnectionStrings(quint8 connectionId, QString &strPar
 quint8 SettingsModel::clipConnectionId(quint8 connectionId)
 {
     /* Default to first connection on id is not supported */
-    return connectionId < static_cast<quint8>(Connection::ID_CNT) ? connectionId : static_cast<quint8>(Connection::ID_1);
+    return connectionId < connectionCount() ? connectionId : static_cast<quint8>(Connection::ID_1);
+}
+
+SettingsModel::ConnectionSettings SettingsModel::defaultConnectionSettings()
+{
+    ConnectionSettings connectionSettings;
+
+    connectionSettings.connectionType = Connection::TYPE_TCP;
+
+    connectionSettings.ipAddress = "127.0.0.1";
+    connectionSettings.port = 502;
+
+    connectionSettings.portName = QStringLiteral("COM1");
+    connectionSettings.parity = QSerialPort::NoParity;
+    connectionSettings.baudrate = QSerialPort::Baud115200;
+    connectionSettings.databits = QSerialPort::Data8;
+    connectionSettings.stopbits = QSerialPort::OneStop;
+
+    connectionSettings.slaveId = 1;
+    connectionSettings.timeout = 1000;
+    connectionSettings.consecutiveMax = 125;
+    connectionSettings.requestWindow = 1;
+    connectionSettings.bConnectionState = false;
+    connectionSettings.bInt32LittleEndian = true;
+    connectionSettings.bPersistentConnection = true;
+    connectionSettings.lingerTime = 0;
+    connectionSettings.interFrameDelay = 0;
+    connectionSettings.turnaroundDelay = 0;
+    connectionSettings.bAdaptiveTimeout = false;
+    connectionSettings.retries = 0;
+
+    return connectionSettings;
 }
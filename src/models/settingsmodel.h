@@ -17,7 +17,13 @@ public:
 
     void triggerUpdate(void);
 
+    void copySettings(const SettingsModel& other);
+
     void setPollTime(quint32 pollTime);
+    void setConnectionCount(quint8 count);
+    void setMaxConcurrentConnections(quint8 max);
+    void setNativeEngine(bool bNative);
+    void setOnDemandPolling(bool bOnDemand);
     void setWriteDuringLogFile(QString filename);
     void setWriteDuringLogFileToDefault(void);
 
@@ -35,9 +41,15 @@ public:
     void setSlaveId(quint8 connectionId, quint8 id);
     void setTimeout(quint8 connectionId, quint32 timeout);
     void setConsecutiveMax(quint8 connectionId, quint8 max);
+    void setRequestWindow(quint8 connectionId, quint8 window);
     void setConnectionState(quint8 connectionId, bool bState);
     void setInt32LittleEndian(quint8 connectionId, bool int32LittleEndian);
     void setPersistentConnection(quint8 connectionId, bool persistentConnection);
+    void setLingerTime(quint8 connectionId, quint32 lingerTime);
+    void setInterFrameDelay(quint8 connectionId, quint32 interFrameDelay);
+    void setTurnaroundDelay(quint8 connectionId, quint32 turnaroundDelay);
+    void setAdaptiveTimeout(quint8 connectionId, bool bAdaptiveTimeout);
+    void setRetries(quint8 connectionId, quint8 retries);
 
     QString writeDuringLogFile();
     bool writeDuringLog();
@@ -54,11 +66,21 @@ public:
     quint8 slaveId(quint8 connectionId);
     quint32 timeout(quint8 connectionId);
     quint8 consecutiveMax(quint8 connectionId);
+    quint8 requestWindow(quint8 connectionId);
     bool connectionState(quint8 connectionId);
     bool int32LittleEndian(quint8 connectionId);
     bool persistentConnection(quint8 connectionId);
+    quint32 lingerTime(quint8 connectionId);
+    quint32 interFrameDelay(quint8 connectionId);
+    quint32 turnaroundDelay(quint8 connectionId);
+    bool adaptiveTimeout(quint8 connectionId);
+    quint8 retries(quint8 connectionId);
 
     quint32 pollTime();
+    quint8 connectionCount() const;
+    quint8 maxConcurrentConnections() const;
+    bool nativeEngine() const;
+    bool onDemandPolling() const;
     bool absoluteTimes();
 
     void serialConnectionStrings(quint8 connectionId, QString &strParity, QString &strDataBits, QString &strStopBits);
@@ -85,6 +107,10 @@ signals:
     void writeDuringLogChanged();
     void writeDuringLogFileChanged();
     void absoluteTimesChanged();
+    void connectionCountChanged();
+    void maxConcurrentConnectionsChanged();
+    void nativeEngineChanged();
+    void onDemandPollingChanged();
 
     void connectionTypeChanged(quint8 connectionId);
 
@@ -100,9 +126,15 @@ signals:
     void slaveIdChanged(quint8 connectionId);
     void timeoutChanged(quint8 connectionId);
     void consecutiveMaxChanged(quint8 connectionId);
+    void requestWindowChanged(quint8 connectionId);
     void connectionStateChanged(quint8 connectionId);
     void int32LittleEndianChanged(quint8 connectionId);
     void persistentConnectionChanged(quint8 connectionId);
+    void lingerTimeChanged(quint8 connectionId);
+    void interFrameDelayChanged(quint8 connectionId);
+    void turnaroundDelayChanged(quint8 connectionId);
+    void adaptiveTimeoutChanged(quint8 connectionId);
+    void retriesChanged(quint8 connectionId);
 
 private:
 
@@ -124,15 +156,26 @@ private:
         quint8 slaveId;
         quint32 timeout;
         quint8 consecutiveMax;
+        quint8 requestWindow;
         bool bConnectionState;
         bool bInt32LittleEndian;
         bool bPersistentConnection;
+        quint32 lingerTime;
+        quint32 interFrameDelay;
+        quint32 turnaroundDelay;
+        bool bAdaptiveTimeout;
+        quint8 retries;
 
     } ConnectionSettings;
 
+    static ConnectionSettings defaultConnectionSettings();
+
     QList<ConnectionSettings> _connectionSettings;
 
     quint32 _pollTime;
+    quint8 _maxConcurrentConnections;
+    bool _bNativeEngine;
+    bool _bOnDemandPolling;
     bool _bAbsoluteTimes;
 
     bool _bWriteDuringLog;
@@ -0,0 +1,50 @@
+#include "acquisitionclock.h"
+
+#include <QElapsedTimer>
+#include <chrono>
+
+namespace
+{
+    /* Monotonic clock, aligned once with the system clock */
+    struct Clock
+    {
+        Clock()
+        {
+            const auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+            epochOffset = std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch).count();
+            elapsedTimer.start();
+        }
+
+        qint64 epochOffset;
+        QElapsedTimer elapsedTimer;
+    };
+
+    const Clock& clock()
+    {
+        static const Clock clock;
+        return clock;
+    }
+}
+
+namespace AcquisitionClock
+{
+    /*!
+     * Return timestamp of acquired data
+     * The timestamp is taken from a monotonic clock, so it isn't influenced by changes of the system time.
+     * It is expressed as time since epoch, so it can also be shown as absolute time.
+     * \return Timestamp (in µs since epoch)
+     */
+    qint64 timestamp()
+    {
+        return clock().epochOffset + clock().elapsedTimer.nsecsElapsed() / 1000;
+    }
+
+    /*!
+     * Return current time of the acquisition clock
+     * \return Time (in ms since epoch)
+     */
+    qint64 currentMSecsSinceEpoch()
+    {
+        return timestamp() / 1000;
+    }
+}
@@ -0,0 +1,12 @@
+#ifndef ACQUISITIONCLOCK_H
+#define ACQUISITIONCLOCK_H
+
+#include <QtGlobal>
+
+namespace AcquisitionClock
+{
+    qint64 timestamp();
+    qint64 currentMSecsSinceEpoch();
+}
+
+#endif // ACQUISITIONCLOCK_H
@@ -1,5 +1,6 @@
 
 #include "expressionchecker.h"
+#include "acquisitionclock.h"
 
 ExpressionChecker::ExpressionChecker(QObject *parent) : QObject(parent)
 {
@@ -48,7 +49,7 @@ qsizetype ExpressionChecker::requiredValueCount()
 
 void ExpressionChecker::setValues(ResultDoubleList results)
 {
-    _graphDataHandler.handleRegisterData(results);
+    _graphDataHandler.handleRegisterData(SampleFrame(results, AcquisitionClock::timestamp()));
 }
 
 bool ExpressionChecker::isValid()
@@ -76,13 +77,13 @@ bool ExpressionChecker::syntaxError()
     return _bSyntaxError;
 }
 
-void ExpressionChecker::handleDataReady(ResultDoubleList resultList)
+void ExpressionChecker::handleDataReady(SampleFrame resultList)
 {
-    _bValid = !resultList.isEmpty() && resultList.first().isValid();
+    _bValid = !resultList.isEmpty() && resultList.at(0).isValid();
 
     if (_bValid)
     {
-        _result = resultList.first().value();
+        _result = resultList.at(0).value();
         _strError = QString();
     }
     else
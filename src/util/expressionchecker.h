@@ -29,7 +29,7 @@ signals:
     void resultsReady(bool valid);
 
 private slots:
-    void handleDataReady(ResultDoubleList resultList);
+    void handleDataReady(SampleFrame resultList);
 
 private:
 
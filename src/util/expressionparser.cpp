@@ -26,9 +26,16 @@ void ExpressionParser::processedExpressions(QStringList& expressionList)
     expressionList = _processedExpressions;
 }
 
+// Get indexes in register list of registers that are used in every expression
+void ExpressionParser::expressionRegisterIndexes(QList<QList<qint32> >& indexLists)
+{
+    indexLists = _expressionRegisterIndexes;
+}
+
 void ExpressionParser::parseExpressions(QStringList& expressions)
 {
     _processedExpressions.clear();
+    _expressionRegisterIndexes.clear();
     _modbusRegisters.clear();
 
     for(const QString &expression: std::as_const(expressions))
@@ -40,6 +47,7 @@ void ExpressionParser::parseExpressions(QStringList& expressions)
 QString ExpressionParser::processExpression(QString const & graphExpr)
 {
     QString resultExpr = graphExpr;
+    QList<qint32> indexList;
     QRegularExpressionMatchIterator i = _findRegRegex.globalMatch(resultExpr);
 
     if (!i.hasNext() && resultExpr.contains("$"))
@@ -58,12 +66,14 @@ QString ExpressionParser::processExpression(QString const & graphExpr)
             ModbusRegister modbusReg;
             if (processRegisterExpression(regDef, modbusReg))
             {
-                QString regFunc = constructInternalRegisterFunction(modbusReg, regDef.size());
+                QString regFunc = constructInternalRegisterFunction(modbusReg, regDef.size(), indexList);
                 resultExpr.replace(regDef, regFunc);
             }
         }
     }
 
+    _expressionRegisterIndexes.append(indexList);
+
     return resultExpr;
 }
 
@@ -98,7 +108,7 @@ bool ExpressionParser::processRegisterExpression(QString regExpr, ModbusRegister
     return bRet;
 }
 
-QString ExpressionParser::constructInternalRegisterFunction(ModbusRegister const & modbusReg, int size)
+QString ExpressionParser::constructInternalRegisterFunction(ModbusRegister const & modbusReg, int size, QList<qint32>& indexList)
 {
     quint32 idx;
     if (_modbusRegisters.contains(modbusReg))
@@ -111,6 +121,11 @@ QString ExpressionParser::constructInternalRegisterFunction(ModbusRegister const
         idx = _modbusRegisters.size() - 1;
     }
 
+    if (!indexList.contains(static_cast<qint32>(idx)))
+    {
+        indexList.append(static_cast<qint32>(idx));
+    }
+
     /* Add dummy whitespaces to make sure positions in internal representations match visible expressions */
     QString regIdx = QString("%1").arg(idx);
     const int spacesCount = size - 3 - regIdx.size(); /* ignore ${} and idx string length */
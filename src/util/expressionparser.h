@@ -13,6 +13,7 @@ public:
 
     void modbusRegisters(QList<ModbusRegister>& registerList);
     void processedExpressions(QStringList& expressionList);
+    void expressionRegisterIndexes(QList<QList<qint32> >& indexLists);
 
 private:
 
@@ -24,9 +25,10 @@ private:
 
     QString processExpression(QString const & expr);
     bool processRegisterExpression(QString regExpr, ModbusRegister &modbusReg);
-    QString constructInternalRegisterFunction(ModbusRegister const & modbusReg, int size);
+    QString constructInternalRegisterFunction(ModbusRegister const & modbusReg, int size, QList<qint32>& indexList);
 
     QStringList _processedExpressions;
+    QList<QList<qint32> > _expressionRegisterIndexes;
     QList<ModbusRegister> _modbusRegisters;
 
     QRegularExpression _findRegRegex;
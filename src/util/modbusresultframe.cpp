@@ -0,0 +1,142 @@
+#include "modbusresultframe.h"
+
+#include <algorithm>
+
+using State = ResultState::State;
+
+ModbusResultFrame::ModbusResultFrame()
+{
+
+}
+
+/*!
+ * Constructor for ModbusResultFrame
+ * Flat result buffer of a read: every requested register has a fixed slot (its index in the address list)
+ * with a value and a validity bit. All slots are invalid until a value is set.
+ * \param addressList   List of requested registers (a sorted list is implicitly shared, so not copied)
+ */
+ModbusResultFrame::ModbusResultFrame(QList<ModbusAddress> addressList)
+    : _addressList(addressList), _values(addressList.size(), 0), _validBits(addressList.size(), false)
+{
+    if (!std::is_sorted(_addressList.cbegin(), _addressList.cend()))
+    {
+        std::sort(_addressList.begin(), _addressList.end());
+    }
+}
+
+/*!
+ * Create frame with the results of a result map
+ * \param resultMap     Result map
+ * \return Frame with a slot for every register of the map
+ */
+ModbusResultFrame ModbusResultFrame::fromResultMap(const ModbusResultMap& resultMap)
+{
+    ModbusResultFrame frame(resultMap.keys());
+
+    qint32 slot = 0;
+    for (auto it = resultMap.cbegin(); it != resultMap.cend(); ++it)
+    {
+        if (it.value().isValid())
+        {
+            frame.setValue(slot, it.value().value());
+        }
+        slot++;
+    }
+
+    return frame;
+}
+
+qint32 ModbusResultFrame::size() const
+{
+    return static_cast<qint32>(_addressList.size());
+}
+
+const QList<ModbusAddress>& ModbusResultFrame::addressList() const
+{
+    return _addressList;
+}
+
+ModbusAddress ModbusResultFrame::address(qint32 slot) const
+{
+    return _addressList[slot];
+}
+
+/*!
+ * Find slot of a register
+ * \param address   Register address
+ * \return Slot of the register, \ref cNoSlot when the register isn't part of the frame
+ */
+qint32 ModbusResultFrame::slot(ModbusAddress address) const
+{
+    const auto it = std::lower_bound(_addressList.cbegin(), _addressList.cend(), address);
+
+    if ((it != _addressList.cend()) && (*it == address))
+    {
+        return static_cast<qint32>(it - _addressList.cbegin());
+    }
+
+    return cNoSlot;
+}
+
+void ModbusResultFrame::setValue(qint32 slot, quint16 value)
+{
+    _values[slot] = value;
+    _validBits.setBit(slot);
+}
+
+void ModbusResultFrame::setError(qint32 slot)
+{
+    _values[slot] = 0;
+    _validBits.clearBit(slot);
+}
+
+/*!
+ * Invalidate all slots, the address list is kept
+ * Allows reusing the frame for the next read of the same registers without reallocating.
+ */
+void ModbusResultFrame::reset()
+{
+    _values.fill(0);
+    _validBits.fill(false);
+}
+
+bool ModbusResultFrame::isValid(qint32 slot) const
+{
+    return _validBits.testBit(slot);
+}
+
+quint16 ModbusResultFrame::value(qint32 slot) const
+{
+    return _values[slot];
+}
+
+/*!
+ * Return raw value of every slot, for decoding all slots in a single pass
+ * Values of invalid slots are zero, check \ref isValid before using them.
+ */
+const QList<quint16>& ModbusResultFrame::valueList() const
+{
+    return _values;
+}
+
+Result<quint16> ModbusResultFrame::result(qint32 slot) const
+{
+    return Result<quint16>(_values[slot], isValid(slot) ? State::SUCCESS : State::INVALID);
+}
+
+/*!
+ * Convert frame to result map
+ * Only intended for logging and diagnostics, not for the poll path
+ * \return Result map with every slot of the frame
+ */
+ModbusResultMap ModbusResultFrame::toResultMap() const
+{
+    ModbusResultMap resultMap;
+
+    for (qint32 slot = 0; slot < size(); slot++)
+    {
+        resultMap.insert(_addressList[slot], result(slot));
+    }
+
+    return resultMap;
+}
@@ -0,0 +1,45 @@
+#ifndef MODBUSRESULTFRAME_H
+#define MODBUSRESULTFRAME_H
+
+#include <QBitArray>
+#include <QList>
+
+#include "modbusresultmap.h"
+
+class ModbusResultFrame
+{
+public:
+    ModbusResultFrame();
+    explicit ModbusResultFrame(QList<ModbusAddress> addressList);
+
+    static ModbusResultFrame fromResultMap(const ModbusResultMap& resultMap);
+
+    qint32 size() const;
+    const QList<ModbusAddress>& addressList() const;
+
+    ModbusAddress address(qint32 slot) const;
+    qint32 slot(ModbusAddress address) const;
+
+    void setValue(qint32 slot, quint16 value);
+    void setError(qint32 slot);
+    void reset();
+
+    bool isValid(qint32 slot) const;
+    quint16 value(qint32 slot) const;
+    const QList<quint16>& valueList() const;
+    Result<quint16> result(qint32 slot) const;
+
+    ModbusResultMap toResultMap() const;
+
+    static constexpr qint32 cNoSlot = -1;
+
+private:
+
+    /* Sorted address of every slot */
+    QList<ModbusAddress> _addressList;
+
+    QList<quint16> _values;
+    QBitArray _validBits;
+};
+
+#endif // MODBUSRESULTFRAME_H
@@ -4,7 +4,7 @@
 
 #include "muParser.h"
 
-ResultDoubleList QMuParser::_registerValues;
+SampleFrame QMuParser::_registerValues;
 
 QMuParser::QMuParser(QString strExpression)
 {
@@ -81,7 +81,11 @@ void QMuParser::setExpression(QString expr)
     reset();
 }
 
-void QMuParser::setRegistersData(ResultDoubleList& regValues)
+/*!
+ * Set register values of all expressions
+ * \param regValues    Register values (shared, not copied)
+ */
+void QMuParser::setRegistersData(const SampleFrame& regValues)
 {
     _registerValues = regValues;
 }
@@ -186,8 +190,8 @@ void QMuParser::registerValue(int index, double* value, bool* success)
 {
     if (index < _registerValues.size())
     {
-        *value = _registerValues[index].value();
-        *success = _registerValues[index].isValid();
+        *value = _registerValues.at(index).value();
+        *success = _registerValues.at(index).isValid();
     }
     else
     {
@@ -4,7 +4,7 @@
 #include <QObject>
 
 #include "muparserregister.h"
-#include "result.h"
+#include "sampleframe.h"
 
 class QMuParser
 {
@@ -25,7 +25,7 @@ public:
     void setExpression(QString expr);
     QString expression();
 
-    static void setRegistersData(ResultDoubleList &regValues);
+    static void setRegistersData(const SampleFrame& regValues);
 
     bool evaluate();
 
@@ -41,7 +41,7 @@ private:
 
     static void registerValue(int index, double *value, bool* success);
 
-    static ResultDoubleList _registerValues;
+    static SampleFrame _registerValues;
 
     mu::ParserRegister* _pExprParser;
 
@@ -0,0 +1,269 @@
+#include "sampleframe.h"
+
+#include <QMutex>
+
+#include <algorithm>
+
+/* Recycles the data of released frames, so steady state acquisition doesn't allocate per sample */
+class SampleFramePool
+{
+public:
+    ~SampleFramePool()
+    {
+        qDeleteAll(_freeList);
+    }
+
+    SampleFrame::Data* acquire()
+    {
+        SampleFrame::Data* pData = nullptr;
+
+        {
+            QMutexLocker locker(&_mutex);
+            if (!_freeList.isEmpty())
+            {
+                pData = _freeList.takeLast();
+            }
+            else
+            {
+                _allocatedCount++;
+            }
+        }
+
+        if (pData == nullptr)
+        {
+            pData = new SampleFrame::Data();
+        }
+
+        pData->ref.storeRelaxed(1);
+
+        return pData;
+    }
+
+    void recycle(SampleFrame::Data* pData)
+    {
+        {
+            QMutexLocker locker(&_mutex);
+            if (_freeList.size() < _cMaxFreeCount)
+            {
+                _freeList.append(pData);
+                return;
+            }
+
+            _allocatedCount--;
+        }
+
+        delete pData;
+    }
+
+    quint32 allocatedCount()
+    {
+        QMutexLocker locker(&_mutex);
+        return _allocatedCount;
+    }
+
+private:
+
+    /* Plenty for the frames in flight between the acquisition and the export */
+    static const qsizetype _cMaxFreeCount = 64;
+
+    QMutex _mutex;
+    QList<SampleFrame::Data*> _freeList;
+    quint32 _allocatedCount{};
+};
+
+Q_GLOBAL_STATIC(SampleFramePool, framePool)
+
+SampleFrame::SampleFrame()
+    : _pData(nullptr)
+{
+
+}
+
+/*!
+ * Constructor for SampleFrame
+ * A sample frame holds the results of a single sample and its timestamp. Copies of a frame share its data, so a
+ * frame is passed through signals and slots without copying the results. The data is taken from a pool and
+ * returns to it when the last copy is released.
+ * \param results       Results of the sample (copied into the frame)
+ * \param timestamp     Moment of acquisition (in µs, see \ref AcquisitionClock::timestamp)
+ */
+SampleFrame::SampleFrame(const ResultDoubleList& results, qint64 timestamp)
+    : SampleFrame(create(results.size(), timestamp))
+{
+    std::copy(results.cbegin(), results.cend(), _pData->results.begin());
+}
+
+SampleFrame::SampleFrame(const SampleFrame& other)
+    : _pData(other._pData)
+{
+    if (_pData != nullptr)
+    {
+        _pData->ref.ref();
+    }
+}
+
+SampleFrame::SampleFrame(SampleFrame&& other) noexcept
+    : _pData(other._pData)
+{
+    other._pData = nullptr;
+}
+
+SampleFrame::SampleFrame(Data* pData)
+    : _pData(pData)
+{
+
+}
+
+SampleFrame::~SampleFrame()
+{
+    release();
+}
+
+SampleFrame& SampleFrame::operator=(const SampleFrame& other)
+{
+    if (_pData != other._pData)
+    {
+        if (other._pData != nullptr)
+        {
+            other._pData->ref.ref();
+        }
+
+        release();
+        _pData = other._pData;
+    }
+
+    return *this;
+}
+
+SampleFrame& SampleFrame::operator=(SampleFrame&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        _pData = other._pData;
+        other._pData = nullptr;
+    }
+
+    return *this;
+}
+
+/*!
+ * Create frame from the pool
+ * The result list of recycled data is reused, so it is only allocated when it is too small
+ * \param size          Number of results, all without value
+ * \param timestamp     Moment of acquisition (in µs, see \ref AcquisitionClock::timestamp)
+ * \return New frame, not shared yet
+ */
+SampleFrame SampleFrame::create(qsizetype size, qint64 timestamp)
+{
+    Data* pData = framePool()->acquire();
+
+    pData->timestamp = timestamp;
+    pData->results.fill(ResultDouble(0, ResultState::State::NO_VALUE), size);
+
+    return SampleFrame(pData);
+}
+
+qint64 SampleFrame::timestamp() const
+{
+    return _pData != nullptr ? _pData->timestamp : 0;
+}
+
+qsizetype SampleFrame::size() const
+{
+    return _pData != nullptr ? _pData->results.size() : 0;
+}
+
+bool SampleFrame::isEmpty() const
+{
+    return size() == 0;
+}
+
+bool SampleFrame::isShared() const
+{
+    return (_pData != nullptr) && (_pData->ref.loadAcquire() > 1);
+}
+
+const ResultDouble& SampleFrame::at(qsizetype idx) const
+{
+    Q_ASSERT(idx < size());
+    return _pData->results.at(idx);
+}
+
+const ResultDouble& SampleFrame::operator[](qsizetype idx) const
+{
+    return at(idx);
+}
+
+ResultDoubleList::const_iterator SampleFrame::begin() const
+{
+    return _pData != nullptr ? _pData->results.cbegin() : ResultDoubleList::const_iterator();
+}
+
+ResultDoubleList::const_iterator SampleFrame::end() const
+{
+    return _pData != nullptr ? _pData->results.cend() : ResultDoubleList::const_iterator();
+}
+
+/*!
+ * Set result of the frame
+ * A shared frame is immutable, so a shared frame is first copied into new data of the pool
+ * \param idx       Index of result
+ * \param result    Result
+ */
+void SampleFrame::setResult(qsizetype idx, const ResultDouble& result)
+{
+    Q_ASSERT(idx < size());
+
+    detach();
+    _pData->results[idx] = result;
+}
+
+/*!
+ * Copy results into a new list
+ * \return List with all results of the frame
+ */
+ResultDoubleList SampleFrame::toResultList() const
+{
+    return ResultDoubleList(begin(), end());
+}
+
+/*!
+ * Return number of frame data that is currently allocated by the pool (in use or free)
+ * \return Allocated count, stays constant when frames are recycled
+ */
+quint32 SampleFrame::allocatedCount()
+{
+    return framePool()->allocatedCount();
+}
+
+void SampleFrame::detach()
+{
+    if (!isShared())
+    {
+        return;
+    }
+
+    SampleFrame copy = create(size(), timestamp());
+    std::copy(begin(), end(), copy._pData->results.begin());
+
+    *this = std::move(copy);
+}
+
+void SampleFrame::release()
+{
+    if ((_pData != nullptr) && !_pData->ref.deref())
+    {
+        if (framePool.isDestroyed())
+        {
+            /* Released during static destruction */
+            delete _pData;
+        }
+        else
+        {
+            framePool()->recycle(_pData);
+        }
+    }
+
+    _pData = nullptr;
+}
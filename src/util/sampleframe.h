@@ -0,0 +1,62 @@
+#ifndef SAMPLEFRAME_H
+#define SAMPLEFRAME_H
+
+#include <QAtomicInt>
+#include <QMetaType>
+
+#include "result.h"
+
+class SampleFramePool;
+
+class SampleFrame
+{
+public:
+    SampleFrame();
+    SampleFrame(const ResultDoubleList& results, qint64 timestamp);
+    SampleFrame(const SampleFrame& other);
+    SampleFrame(SampleFrame&& other) noexcept;
+    ~SampleFrame();
+
+    SampleFrame& operator=(const SampleFrame& other);
+    SampleFrame& operator=(SampleFrame&& other) noexcept;
+
+    static SampleFrame create(qsizetype size, qint64 timestamp);
+
+    qint64 timestamp() const;
+    qsizetype size() const;
+    bool isEmpty() const;
+    bool isShared() const;
+
+    const ResultDouble& at(qsizetype idx) const;
+    const ResultDouble& operator[](qsizetype idx) const;
+
+    ResultDoubleList::const_iterator begin() const;
+    ResultDoubleList::const_iterator end() const;
+
+    void setResult(qsizetype idx, const ResultDouble& result);
+
+    ResultDoubleList toResultList() const;
+
+    static quint32 allocatedCount();
+
+private:
+    friend class SampleFramePool;
+
+    struct Data
+    {
+        QAtomicInt ref;
+        qint64 timestamp{};
+        ResultDoubleList results;
+    };
+
+    explicit SampleFrame(Data* pData);
+
+    void detach();
+    void release();
+
+    Data* _pData;
+};
+
+Q_DECLARE_METATYPE(SampleFrame)
+
+#endif // SAMPLEFRAME_H
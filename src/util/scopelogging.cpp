@@ -1,5 +1,6 @@
 
 #include <QDateTime>
+#include <QThread>
 
 #include "diagnosticmodel.h"
 #include "scopelogging.h"
@@ -68,7 +69,18 @@ void ScopeLogging::handleLog(QtMsgType type, const QMessageLogContext &context,
 
     if (_pDiagnosticModel != nullptr)
     {
-        _pDiagnosticModel->addLog(context.category, logSeverity, offset, msg);
+        if (QThread::currentThread() == _pDiagnosticModel->thread())
+        {
+            _pDiagnosticModel->addLog(context.category, logSeverity, offset, msg);
+        }
+        else
+        {
+            /* Logs of the communication thread are added in the thread of the model */
+            const QString category(context.category);
+            QMetaObject::invokeMethod(_pDiagnosticModel, [=, pModel = _pDiagnosticModel]() {
+                    pModel->addLog(category, logSeverity, offset, msg);
+                }, Qt::QueuedConnection);
+        }
     }
 
 #if 0
@@ -3,8 +3,9 @@
 
 #include <QObject>
 #include "graphdatamodel.h"
+#include "modbusreaditem.h"
 #include "qtestcase.h"
-#include "result.h"
+#include "sampleframe.h"
 
 class CommunicationHelpers : public QObject
 {
@@ -24,11 +25,26 @@ public:
     static void verifyReceivedDataSignal(QList<QVariant> arguments, ResultDoubleList resultList)
     {
         /* Verify success */
-        QVERIFY(arguments[0].canConvert<ResultDoubleList>());
-        auto actResultList = arguments[0].value<ResultDoubleList>();
+        QVERIFY(arguments[0].canConvert<SampleFrame>());
+        auto actResultList = arguments[0].value<SampleFrame>().toResultList();
         QCOMPARE(resultList, actResultList);
     }
 
+    /* Pack a value per bit in 16-bit words, the layout of the native engine (see ModbusReadItem::packedBit) */
+    static QList<quint16> packBits(const QList<quint16>& bitList)
+    {
+        QList<quint16> packedList(ModbusReadItem::packedSize(bitList.size()), 0);
+        for (qsizetype idx = 0; idx < bitList.size(); idx++)
+        {
+            if (bitList[idx] != 0)
+            {
+                packedList[idx / 16] |= static_cast<quint16>(1u << (idx % 16));
+            }
+        }
+
+        return packedList;
+    }
+
 
 private:
 
@@ -0,0 +1,361 @@
+
+#include <QtTest/QtTest>
+
+#include "tst_busarbiter.h"
+
+#include "testslaveudp.h"
+
+Q_DECLARE_METATYPE(ModbusAddress);
+
+void TestBusArbiter::init()
+{
+    qRegisterMetaType<QModbusDevice::Error>("QModbusDevice::Error");
+
+    _slaveId = 1;
+    _serverConnectionData.setPort(5020);
+    _serverConnectionData.setHost("127.0.0.1");
+
+    if (!_testSlaveData.isEmpty())
+    {
+        qDeleteAll(_testSlaveData);
+        _testSlaveData.clear();
+    }
+    if (!_pTestSlaveModbus.isNull())
+    {
+        delete _pTestSlaveModbus;
+    }
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters] = new TestSlaveData();
+    _pTestSlaveModbus = new TestSlaveModbus(_testSlaveData);
+
+    for (int idx = 0; idx < 4; idx++)
+    {
+        _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(idx, true);
+        _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(idx, idx);
+    }
+}
+
+void TestBusArbiter::cleanup()
+{
+    _pTestSlaveModbus->disconnectDevice();
+
+    if (!_testSlaveData.isEmpty())
+    {
+        qDeleteAll(_testSlaveData);
+        _testSlaveData.clear();
+    }
+    delete _pTestSlaveModbus;
+}
+
+void TestBusArbiter::sharedConnection()
+{
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    BusArbiter arbiter;
+    BusChannel* pChannel1 = arbiter.createChannel(this);
+    BusChannel* pChannel2 = arbiter.createChannel(this);
+
+    QSignalSpy spySuccess1(pChannel1, &ModbusConnection::connectionSuccess);
+    QSignalSpy spySuccess2(pChannel2, &ModbusConnection::connectionSuccess);
+
+    /* Second channel waits for the connection that is being opened by the first channel */
+    pChannel1->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess1.wait(100));
+    QCOMPARE(spySuccess1.count(), 1);
+    QCOMPARE(spySuccess2.count(), 1);
+
+    QVERIFY(pChannel1->isConnected());
+    QVERIFY(pChannel2->isConnected());
+
+    /* Open of an open channel succeeds immediately */
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QCOMPARE(spySuccess2.count(), 2);
+
+    delete pChannel1;
+    delete pChannel2;
+}
+
+void TestBusArbiter::routeReplies()
+{
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    BusArbiter arbiter;
+    BusChannel* pChannel1 = arbiter.createChannel(this);
+    BusChannel* pChannel2 = arbiter.createChannel(this);
+
+    QSignalSpy spySuccess(pChannel1, &ModbusConnection::connectionSuccess);
+    QSignalSpy spyResult1(pChannel1, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResult2(pChannel2, &ModbusConnection::readRequestSuccess);
+
+    pChannel1->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    /* Requests of both channels are interleaved on the bus */
+    pChannel1->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pChannel2->sendReadRequest(ModbusAddress(40002), 2, _slaveId);
+    pChannel1->sendReadRequest(ModbusAddress(40004), 1, _slaveId);
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResult1.count(), 2, 500);
+    QCOMPARE(spyResult2.count(), 1);
+
+    QCOMPARE(spyResult1.at(0).at(0).value<ModbusAddress>(), ModbusAddress(40001));
+    QCOMPARE(spyResult1.at(1).at(0).value<ModbusAddress>(), ModbusAddress(40004));
+
+    QCOMPARE(spyResult2.at(0).at(0).value<ModbusAddress>(), ModbusAddress(40002));
+    QCOMPARE(spyResult2.at(0).at(1).value<QList<quint16> >(), QList<quint16>({1, 2}));
+
+    delete pChannel1;
+    delete pChannel2;
+}
+
+void TestBusArbiter::routeRepliesSameAddress()
+{
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    BusArbiter arbiter;
+    arbiter.setMaxSentCount(2);
+
+    BusChannel* pChannel1 = arbiter.createChannel(this);
+    BusChannel* pChannel2 = arbiter.createChannel(this);
+
+    QSignalSpy spySuccess(pChannel1, &ModbusConnection::connectionSuccess);
+    QSignalSpy spyResult1(pChannel1, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResult2(pChannel2, &ModbusConnection::readRequestSuccess);
+
+    pChannel1->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    /* Same slave and start register, only the request identity tells the replies apart */
+    pChannel1->sendReadRequest(ModbusAddress(40001), 1, _slaveId, 11);
+    pChannel2->sendReadRequest(ModbusAddress(40001), 3, _slaveId, 22);
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResult1.count(), 1, 500);
+    QTRY_COMPARE_WITH_TIMEOUT(spyResult2.count(), 1, 500);
+
+    QCOMPARE(spyResult1.at(0).at(1).value<QList<quint16> >(), QList<quint16>({0}));
+    QCOMPARE(spyResult1.at(0).at(4).toUInt(), static_cast<quint32>(11));
+
+    QCOMPARE(spyResult2.at(0).at(1).value<QList<quint16> >(), QList<quint16>({0, 1, 2}));
+    QCOMPARE(spyResult2.at(0).at(4).toUInt(), static_cast<quint32>(22));
+
+    delete pChannel1;
+    delete pChannel2;
+}
+
+void TestBusArbiter::abortRequests()
+{
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    BusArbiter arbiter;
+    BusChannel* pChannel1 = arbiter.createChannel(this);
+    BusChannel* pChannel2 = arbiter.createChannel(this);
+
+    QSignalSpy spySuccess(pChannel1, &ModbusConnection::connectionSuccess);
+    QSignalSpy spyResult1(pChannel1, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResult2(pChannel2, &ModbusConnection::readRequestSuccess);
+
+    pChannel1->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    pChannel1->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pChannel2->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+
+    /* Reply of aborted request is dropped, the reply of the other channel is still received */
+    pChannel1->abortPendingRequests();
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResult2.count(), 1, 500);
+    QTest::qWait(50);
+    QCOMPARE(spyResult1.count(), 0);
+
+    delete pChannel1;
+    delete pChannel2;
+}
+
+void TestBusArbiter::releaseChannel()
+{
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    BusArbiter arbiter;
+    BusChannel* pChannel1 = arbiter.createChannel(this);
+    BusChannel* pChannel2 = arbiter.createChannel(this);
+
+    QSignalSpy spySuccess(pChannel1, &ModbusConnection::connectionSuccess);
+
+    pChannel1->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    /* Connection stays open for the other channel */
+    pChannel1->closeConnection();
+    QVERIFY(!pChannel1->isConnected());
+    QVERIFY(pChannel2->isConnected());
+
+    /* Last channel releases the connection of the bus */
+    pChannel2->lingerConnection(0);
+    QVERIFY(!pChannel2->isConnected());
+
+    delete pChannel1;
+    delete pChannel2;
+}
+
+void TestBusArbiter::maxSentCount()
+{
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    BusArbiter arbiter;
+    arbiter.setMaxSentCount(1);
+
+    BusChannel* pChannel1 = arbiter.createChannel(this);
+    BusChannel* pChannel2 = arbiter.createChannel(this);
+
+    QSignalSpy spySuccess(pChannel1, &ModbusConnection::connectionSuccess);
+    QSignalSpy spyResult1(pChannel1, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResult2(pChannel2, &ModbusConnection::readRequestSuccess);
+
+    pChannel1->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    pChannel1->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pChannel2->sendReadRequest(ModbusAddress(40002), 1, _slaveId);
+    pChannel1->sendReadRequest(ModbusAddress(40003), 1, _slaveId);
+
+    /* Only one request is outstanding on the shared socket */
+    QCOMPARE(arbiter.queuedRequestCount(), 2);
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResult1.count(), 2, 500);
+    QCOMPARE(spyResult2.count(), 1);
+    QCOMPARE(arbiter.queuedRequestCount(), 0);
+
+    delete pChannel1;
+    delete pChannel2;
+}
+
+void TestBusArbiter::maxBurstCount()
+{
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    BusArbiter arbiter;
+    arbiter.setMaxSentCount(1);
+    arbiter.setTurnaroundDelay(5);
+
+    /* At least one request in a row is allowed */
+    arbiter.setMaxBurstCount(0);
+    QCOMPARE(arbiter.maxBurstCount(), static_cast<quint32>(1));
+
+    arbiter.setMaxBurstCount(2);
+    QCOMPARE(arbiter.maxBurstCount(), static_cast<quint32>(2));
+
+    BusChannel* pChannel1 = arbiter.createChannel(this);
+    BusChannel* pChannel2 = arbiter.createChannel(this);
+
+    QSignalSpy spySuccess(pChannel1, &ModbusConnection::connectionSuccess);
+    QSignalSpy spyResult1(pChannel1, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResult2(pChannel2, &ModbusConnection::readRequestSuccess);
+
+    pChannel1->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    pChannel1->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pChannel1->sendReadRequest(ModbusAddress(40002), 1, _slaveId);
+    pChannel1->sendReadRequest(ModbusAddress(40003), 1, _slaveId);
+    pChannel2->sendReadRequest(ModbusAddress(40004), 1, _slaveId);
+
+    /* A burst to the only slave id on the bus doesn't stall the queue */
+    QTRY_COMPARE_WITH_TIMEOUT(spyResult1.count(), 3, 500);
+    QTRY_COMPARE_WITH_TIMEOUT(spyResult2.count(), 1, 500);
+    QCOMPARE(arbiter.queuedRequestCount(), 0);
+    QCOMPARE(arbiter.sentRequestCount(), 0);
+
+    delete pChannel1;
+    delete pChannel2;
+}
+
+void TestBusArbiter::connectionError()
+{
+    /* Server not started */
+
+    BusArbiter arbiter;
+    BusChannel* pChannel1 = arbiter.createChannel(this);
+    BusChannel* pChannel2 = arbiter.createChannel(this);
+
+    QSignalSpy spyError1(pChannel1, &ModbusConnection::connectionError);
+    QSignalSpy spyError2(pChannel2, &ModbusConnection::connectionError);
+
+    pChannel1->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    pChannel2->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    /* Error of the shared connection is reported to every channel */
+    QTRY_COMPARE_WITH_TIMEOUT(spyError1.count(), 1, 1500);
+    QCOMPARE(spyError2.count(), 1);
+
+    delete pChannel1;
+    delete pChannel2;
+}
+
+void TestBusArbiter::releaseWithSentRequests()
+{
+    TestSlaveUdp testSlaveUdp(_pTestSlaveModbus);
+    QVERIFY(testSlaveUdp.connect(_serverConnectionData, _slaveId));
+
+    /* Native engine with a window of 2 outstanding requests */
+    BusArbiter arbiter(true);
+    arbiter.setMaxSentCount(2);
+
+    BusChannel* pChannel = arbiter.createChannel(this);
+    pChannel->setRequestPolicy(false, 0);
+
+    QSignalSpy spySuccess(pChannel, &ModbusConnection::connectionSuccess);
+    QSignalSpy spyResult(pChannel, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyError(pChannel, &ModbusConnection::readRequestError);
+
+    pChannel->openUdpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 100);
+    QVERIFY(spySuccess.wait(100));
+
+    /* Requests aren't answered. After the first timeout the channel is closed (as a master does after a failed
+     * read), while the second request is still outstanding */
+    testSlaveUdp.setDropCount(2);
+    connect(pChannel, &ModbusConnection::readRequestError, pChannel, [pChannel]() { pChannel->lingerConnection(0); },
+            Qt::SingleShotConnection);
+
+    pChannel->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pChannel->sendReadRequest(ModbusAddress(40002), 1, _slaveId);
+    QCOMPARE(arbiter.sentRequestCount(), 2);
+
+    QVERIFY(spyError.wait(500));
+    QVERIFY(!pChannel->isConnected());
+    QCOMPARE(arbiter.sentRequestCount(), 0);
+    QCOMPARE(arbiter.queuedRequestCount(), 0);
+
+    /* Next connection has the full window */
+    pChannel->openUdpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 100);
+    QTRY_COMPARE_WITH_TIMEOUT(spySuccess.count(), 2, 100);
+
+    pChannel->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pChannel->sendReadRequest(ModbusAddress(40002), 1, _slaveId);
+    QCOMPARE(arbiter.sentRequestCount(), 2);
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResult.count(), 2, 500);
+    QCOMPARE(spyError.count(), 1);
+
+    delete pChannel;
+}
+
+ModbusConnection::TcpSettings TestBusArbiter::constructTcpSettings(QString ip, qint32 port)
+{
+    struct ModbusConnection::TcpSettings tcpSettings =
+    {
+        .ip = ip,
+        .port = port,
+    };
+
+    return tcpSettings;
+}
+
+QTEST_GUILESS_MAIN(TestBusArbiter)
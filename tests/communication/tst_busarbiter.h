@@ -0,0 +1,37 @@
+
+#include <QObject>
+#include <QPointer>
+#include <QUrl>
+
+#include "busarbiter.h"
+
+#include "testslavemodbus.h"
+
+class TestBusArbiter: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void sharedConnection();
+    void routeReplies();
+    void routeRepliesSameAddress();
+    void abortRequests();
+    void releaseChannel();
+    void maxSentCount();
+    void maxBurstCount();
+    void connectionError();
+    void releaseWithSentRequests();
+
+private:
+
+    ModbusConnection::TcpSettings constructTcpSettings(QString ip, qint32 port);
+
+    TestSlaveModbus::ModbusDataMap _testSlaveData;
+    QPointer<TestSlaveModbus> _pTestSlaveModbus;
+
+    quint8 _slaveId;
+
+    QUrl _serverConnectionData;
+};
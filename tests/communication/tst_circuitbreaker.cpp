@@ -0,0 +1,166 @@
+
+#include <QtTest/QtTest>
+
+#include "tst_circuitbreaker.h"
+
+#include "circuitbreaker.h"
+
+using State = CircuitBreaker::State;
+
+void TestCircuitBreaker::init()
+{
+
+}
+
+void TestCircuitBreaker::cleanup()
+{
+
+}
+
+void TestCircuitBreaker::closedByDefault()
+{
+    CircuitBreaker breaker;
+
+    QCOMPARE(breaker.state(), State::CLOSED);
+    QVERIFY(!breaker.isTripped());
+    QVERIFY(breaker.allowRead(0));
+}
+
+void TestCircuitBreaker::tripAfterThreshold()
+{
+    CircuitBreaker breaker;
+
+    for (quint32 idx = 0; idx < CircuitBreaker::cFailureThreshold - 1; idx++)
+    {
+        breaker.recordFailure(1000);
+        QCOMPARE(breaker.state(), State::CLOSED);
+        QVERIFY(breaker.allowRead(1000));
+    }
+
+    breaker.recordFailure(1000);
+
+    QCOMPARE(breaker.state(), State::OPEN);
+    QVERIFY(breaker.isTripped());
+    QCOMPARE(breaker.retryTime(), 1000 + CircuitBreaker::cMinBackOff);
+
+    /* Reads are skipped during back-off */
+    QVERIFY(!breaker.allowRead(1000));
+    QVERIFY(!breaker.allowRead(CircuitBreaker::cMinBackOff));
+    QCOMPARE(breaker.state(), State::OPEN);
+}
+
+void TestCircuitBreaker::successResetsFailures()
+{
+    CircuitBreaker breaker;
+
+    for (quint32 idx = 0; idx < CircuitBreaker::cFailureThreshold - 1; idx++)
+    {
+        breaker.recordFailure(0);
+    }
+
+    /* Only consecutive failures trip the breaker */
+    breaker.recordSuccess();
+    QCOMPARE(breaker.consecutiveFailures(), static_cast<quint32>(0));
+
+    breaker.recordFailure(0);
+    QCOMPARE(breaker.state(), State::CLOSED);
+}
+
+void TestCircuitBreaker::halfOpenProbe()
+{
+    CircuitBreaker breaker;
+
+    for (quint32 idx = 0; idx < CircuitBreaker::cFailureThreshold; idx++)
+    {
+        breaker.recordFailure(0);
+    }
+
+    /* Single probe after back-off */
+    QVERIFY(breaker.allowRead(CircuitBreaker::cMinBackOff));
+    QCOMPARE(breaker.state(), State::HALF_OPEN);
+    QVERIFY(breaker.isTripped());
+
+    /* No other read while probe is in progress */
+    QVERIFY(!breaker.allowRead(CircuitBreaker::cMinBackOff + 1));
+}
+
+void TestCircuitBreaker::probeSuccess()
+{
+    CircuitBreaker breaker;
+
+    for (quint32 idx = 0; idx < CircuitBreaker::cFailureThreshold; idx++)
+    {
+        breaker.recordFailure(0);
+    }
+
+    QVERIFY(breaker.allowRead(CircuitBreaker::cMinBackOff));
+    breaker.recordSuccess();
+
+    QCOMPARE(breaker.state(), State::CLOSED);
+    QVERIFY(!breaker.isTripped());
+    QCOMPARE(breaker.backOff(), CircuitBreaker::cMinBackOff);
+    QVERIFY(breaker.allowRead(CircuitBreaker::cMinBackOff));
+}
+
+void TestCircuitBreaker::probeFailureBackOff()
+{
+    CircuitBreaker breaker;
+
+    for (quint32 idx = 0; idx < CircuitBreaker::cFailureThreshold; idx++)
+    {
+        breaker.recordFailure(0);
+    }
+
+    const qint64 probeTime = CircuitBreaker::cMinBackOff;
+    QVERIFY(breaker.allowRead(probeTime));
+
+    /* Failed probe trips breaker again with doubled back-off */
+    breaker.recordFailure(probeTime);
+
+    QCOMPARE(breaker.state(), State::OPEN);
+    QCOMPARE(breaker.backOff(), 2 * CircuitBreaker::cMinBackOff);
+    QCOMPARE(breaker.retryTime(), probeTime + 2 * CircuitBreaker::cMinBackOff);
+
+    QVERIFY(!breaker.allowRead(probeTime + CircuitBreaker::cMinBackOff));
+    QVERIFY(breaker.allowRead(probeTime + 2 * CircuitBreaker::cMinBackOff));
+}
+
+void TestCircuitBreaker::maxBackOff()
+{
+    CircuitBreaker breaker;
+
+    qint64 now = 0;
+    for (quint32 idx = 0; idx < CircuitBreaker::cFailureThreshold; idx++)
+    {
+        breaker.recordFailure(now);
+    }
+
+    for (quint32 idx = 0; idx < 20; idx++)
+    {
+        now = breaker.retryTime();
+        QVERIFY(breaker.allowRead(now));
+        breaker.recordFailure(now);
+    }
+
+    QCOMPARE(breaker.backOff(), CircuitBreaker::cMaxBackOff);
+    QCOMPARE(breaker.retryTime(), now + CircuitBreaker::cMaxBackOff);
+}
+
+void TestCircuitBreaker::reset()
+{
+    CircuitBreaker breaker;
+
+    for (quint32 idx = 0; idx < CircuitBreaker::cFailureThreshold; idx++)
+    {
+        breaker.recordFailure(0);
+    }
+
+    breaker.reset();
+
+    QCOMPARE(breaker.state(), State::CLOSED);
+    QCOMPARE(breaker.consecutiveFailures(), static_cast<quint32>(0));
+    QCOMPARE(breaker.backOff(), CircuitBreaker::cMinBackOff);
+    QVERIFY(breaker.allowRead(0));
+}
+
+QTEST_GUILESS_MAIN(TestCircuitBreaker)
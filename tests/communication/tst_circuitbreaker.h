@@ -0,0 +1,22 @@
+
+#include <QObject>
+
+class TestCircuitBreaker: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void closedByDefault();
+    void tripAfterThreshold();
+    void successResetsFailures();
+    void halfOpenProbe();
+    void probeSuccess();
+    void probeFailureBackOff();
+    void maxBackOff();
+    void reset();
+
+private:
+
+};
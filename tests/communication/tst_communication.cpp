@@ -39,7 +39,7 @@ void TestCommunication::init()
 
     _pSettingsModel->setPollTime(100);
 
-    for (quint8 idx = 0; idx < Connection::ID_CNT; idx++)
+    for (quint8 idx = 0; idx < _pSettingsModel->connectionCount(); idx++)
     {
         _serverConnectionDataList.append(QUrl());
         _serverConnectionDataList.last().setPort(_pSettingsModel->port(idx));
@@ -59,7 +59,7 @@ void TestCommunication::cleanup()
     delete _pGraphDataModel;
     delete _pSettingsModel;
 
-    for (int idx = 0; idx < Connection::ID_CNT; idx++)
+    for (qsizetype idx = 0; idx < _testSlaveModbusList.size(); idx++)
     {
         _testSlaveModbusList[idx]->disconnectDevice();
     }
@@ -100,6 +100,42 @@ void TestCommunicationStats::onlyLastXSamples()
     delete _pCommunicationStatsLimited;
 }
 
+void TestCommunicationStats::pollStatistics()
+{
+    _pCommunicationStats->updatePollStatistics(0, 2, 10000000);
+    _pCommunicationStats->updatePollStatistics(1, 3, 20500000);
+
+    QCOMPARE(_pGraphDataModel->missedPollCount(), static_cast<quint32>(5));
+    QCOMPARE(_pGraphDataModel->achievedPollPeriod(), 20.5);
+
+    /* Newer statistics of a connection replace the previous */
+    _pCommunicationStats->updatePollStatistics(1, 4, 5000000);
+
+    QCOMPARE(_pGraphDataModel->missedPollCount(), static_cast<quint32>(6));
+    QCOMPARE(_pGraphDataModel->achievedPollPeriod(), 10.0);
+
+    _pCommunicationStats->resetTiming();
+
+    QCOMPARE(_pGraphDataModel->missedPollCount(), static_cast<quint32>(0));
+    QCOMPARE(_pGraphDataModel->achievedPollPeriod(), 0.0);
+}
+
+void TestCommunicationStats::trippedConnections()
+{
+    _pCommunicationStats->updateConnectionTripped(2, true);
+    _pCommunicationStats->updateConnectionTripped(0, true);
+
+    QCOMPARE(_pGraphDataModel->trippedConnections(), QList<quint8>({0, 2}));
+
+    _pCommunicationStats->updateConnectionTripped(2, false);
+
+    QCOMPARE(_pGraphDataModel->trippedConnections(), QList<quint8>({0}));
+
+    _pCommunicationStats->resetTiming();
+
+    QVERIFY(_pGraphDataModel->trippedConnections().isEmpty());
+}
+
 void TestCommunicationStats::setPollData(QVector<double> times)
 {
     QSharedPointer<QCPGraphDataContainer> dataMap = _pGraphDataModel->dataMap(0);
@@ -22,6 +22,9 @@ private slots:
     void pollTimeDiffIsGettingSmaller();
     void onlyLastXSamples();
 
+    void pollStatistics();
+    void trippedConnections();
+
 private:
     void setPollData(QVector<double> times);
 
@@ -0,0 +1,194 @@
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+#include "tst_deviceprofile.h"
+
+#include "deviceprofile.h"
+
+using ObjectType = ModbusAddress::ObjectType;
+
+void TestDeviceProfile::init()
+{
+
+}
+
+void TestDeviceProfile::cleanup()
+{
+
+}
+
+void TestDeviceProfile::key()
+{
+    QCOMPARE(DeviceProfile::tcpKey("127.0.0.1", 502, 1), QString("tcp:127.0.0.1:502:1"));
+    QCOMPARE(DeviceProfile::udpKey("127.0.0.1", 502, 1), QString("udp:127.0.0.1:502:1"));
+    QCOMPARE(DeviceProfile::serialKey("/dev/ttyUSB0", 2), QString("serial:/dev/ttyUSB0:2"));
+}
+
+void TestDeviceProfile::limitBlockSize()
+{
+    DeviceProfile profile;
+
+    QVERIFY(profile.isEmpty());
+    QCOMPARE(profile.maxBlockSize(), 0);
+
+    profile.limitBlockSize(50);
+    QCOMPARE(profile.maxBlockSize(), 50);
+
+    /* Block size is only lowered */
+    profile.limitBlockSize(100);
+    QCOMPARE(profile.maxBlockSize(), 50);
+
+    profile.limitBlockSize(0);
+    QCOMPARE(profile.maxBlockSize(), 50);
+
+    profile.limitBlockSize(10);
+    QCOMPARE(profile.maxBlockSize(), 10);
+
+    QVERIFY(!profile.isEmpty());
+}
+
+void TestDeviceProfile::limitBitBlockSize()
+{
+    DeviceProfile profile;
+
+    profile.limitBitBlockSize(1000);
+    QCOMPARE(profile.maxBitBlockSize(), 1000);
+
+    /* Block size is only lowered, independent of register block size */
+    profile.limitBitBlockSize(1500);
+    QCOMPARE(profile.maxBitBlockSize(), 1000);
+    QCOMPARE(profile.maxBlockSize(), 0);
+
+    QVERIFY(!profile.isEmpty());
+}
+
+void TestDeviceProfile::probeBlockSize()
+{
+    DeviceProfile profile;
+
+    /* Nothing to probe without learned block size */
+    const quint32 revision = profile.revision();
+    profile.addSuccessfulPoll();
+    QCOMPARE(profile.revision(), revision);
+
+    profile.limitBlockSize(50);
+    profile.limitBitBlockSize(1000);
+
+    for (quint32 idx = 0; idx < DeviceProfile::cBlockSizeProbeInterval - 1; idx++)
+    {
+        profile.addSuccessfulPoll();
+    }
+    QCOMPARE(profile.maxBlockSize(), 50);
+
+    /* Learning a lower block size restarts the interval */
+    profile.limitBlockSize(40);
+    profile.addSuccessfulPoll();
+    QCOMPARE(profile.maxBlockSize(), 40);
+
+    for (quint32 idx = 0; idx < DeviceProfile::cBlockSizeProbeInterval - 1; idx++)
+    {
+        profile.addSuccessfulPoll();
+    }
+
+    /* Full block is probed again */
+    QCOMPARE(profile.maxBlockSize(), 0);
+    QCOMPARE(profile.maxBitBlockSize(), 0);
+    QVERIFY(profile.isEmpty());
+}
+
+void TestDeviceProfile::addUnreadableRange()
+{
+    DeviceProfile profile;
+
+    profile.addUnreadableRange(ModbusReadItem(ModbusAddress(0), 8));
+    QCOMPARE(profile.unreadableList().size(), 1);
+
+    /* Larger range around known range is ignored */
+    profile.addUnreadableRange(ModbusReadItem(ModbusAddress(0), 16));
+    QCOMPARE(profile.unreadableList().size(), 1);
+    QCOMPARE(profile.unreadableList().first().count(), 8);
+
+    /* Smaller range replaces known range */
+    profile.addUnreadableRange(ModbusReadItem(ModbusAddress(4), 2));
+    QCOMPARE(profile.unreadableList().size(), 1);
+    QCOMPARE(profile.unreadableList().first().address(), ModbusAddress(4));
+    QCOMPARE(profile.unreadableList().first().count(), 2);
+
+    /* Same range of other object type is a different range */
+    profile.addUnreadableRange(ModbusReadItem(ModbusAddress(4, ObjectType::INPUT_REGISTER), 2));
+    QCOMPARE(profile.unreadableList().size(), 2);
+
+    QVERIFY(profile.containsUnreadableRange(ModbusReadItem(ModbusAddress(0), 10)));
+    QVERIFY(!profile.containsUnreadableRange(ModbusReadItem(ModbusAddress(0), 5)));
+    QVERIFY(!profile.containsUnreadableRange(ModbusReadItem(ModbusAddress(0, ObjectType::COIL), 10)));
+}
+
+void TestDeviceProfile::removeReadableRanges()
+{
+    DeviceProfile profile;
+
+    profile.addUnreadableRange(ModbusReadItem(ModbusAddress(4), 2));
+    profile.addUnreadableRange(ModbusReadItem(ModbusAddress(20), 1));
+
+    const quint32 revision = profile.revision();
+
+    profile.removeReadableRanges(ModbusReadItem(ModbusAddress(0), 10));
+
+    QCOMPARE(profile.unreadableList().size(), 1);
+    QCOMPARE(profile.unreadableList().first().address(), ModbusAddress(20));
+    QVERIFY(profile.revision() != revision);
+
+    profile.removeUnreadableRange(ModbusReadItem(ModbusAddress(20), 1));
+    QVERIFY(profile.isEmpty());
+}
+
+void TestDeviceProfile::supported()
+{
+    DeviceProfile profile;
+
+    QVERIFY(profile.isSupported(ObjectType::COIL));
+
+    profile.setSupported(ObjectType::COIL, false);
+    QVERIFY(!profile.isSupported(ObjectType::COIL));
+    QVERIFY(profile.isSupported(ObjectType::HOLDING_REGISTER));
+
+    const quint32 revision = profile.revision();
+
+    /* No change, no new revision */
+    profile.setSupported(ObjectType::COIL, false);
+    QCOMPARE(profile.revision(), revision);
+
+    profile.setSupported(ObjectType::COIL, true);
+    QVERIFY(profile.isSupported(ObjectType::COIL));
+    QVERIFY(profile.isEmpty());
+}
+
+void TestDeviceProfile::saveLoad()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QSettings settings(dir.filePath("profile.ini"), QSettings::IniFormat);
+
+    DeviceProfile profile;
+    profile.limitBlockSize(32);
+    profile.limitBitBlockSize(800);
+    profile.addUnreadableRange(ModbusReadItem(ModbusAddress(4, ObjectType::INPUT_REGISTER), 2));
+    profile.setSupported(ObjectType::COIL, false);
+
+    profile.save(settings);
+
+    DeviceProfile loadedProfile;
+    loadedProfile.load(settings);
+
+    QCOMPARE(loadedProfile.maxBlockSize(), 32);
+    QCOMPARE(loadedProfile.maxBitBlockSize(), 800);
+    QCOMPARE(loadedProfile.unreadableList().size(), 1);
+    QCOMPARE(loadedProfile.unreadableList().first().address(), ModbusAddress(4, ObjectType::INPUT_REGISTER));
+    QCOMPARE(loadedProfile.unreadableList().first().count(), 2);
+    QVERIFY(!loadedProfile.isSupported(ObjectType::COIL));
+    QVERIFY(loadedProfile.isSupported(ObjectType::INPUT_REGISTER));
+}
+
+QTEST_GUILESS_MAIN(TestDeviceProfile)
@@ -0,0 +1,22 @@
+
+#include <QObject>
+
+class TestDeviceProfile: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void key();
+    void limitBlockSize();
+    void limitBitBlockSize();
+    void probeBlockSize();
+    void addUnreadableRange();
+    void removeReadableRanges();
+    void supported();
+    void saveLoad();
+
+private:
+
+};
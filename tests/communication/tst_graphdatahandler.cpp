@@ -84,7 +84,7 @@ void TestGraphDataHandler::error()
     dataHandler.modbusRegisterList(registerList);
 
     auto regResults = ResultDoubleList() << ResultDouble(1, State::SUCCESS);
-    dataHandler.handleRegisterData(regResults);
+    dataHandler.handleRegisterData(SampleFrame(regResults, 0));
 
     QCOMPARE(dataHandler.expressionErrorPos(0), errorPos);
     QCOMPARE(dataHandler.expressionErrorType(0), errorType);
@@ -104,7 +104,7 @@ void TestGraphDataHandler::sameRegisterDifferentType()
     dataHandler.modbusRegisterList(registerList);
 
     auto regResults = ResultDoubleList() << ResultDouble(1, State::SUCCESS) << ResultDouble(1, State::SUCCESS);
-    dataHandler.handleRegisterData(regResults);
+    dataHandler.handleRegisterData(SampleFrame(regResults, 0));
 
     QCOMPARE(dataHandler.expressionErrorPos(0), -1);
     QCOMPARE(dataHandler.expressionErrorType(0), QMuParser::ErrorType::NONE);
@@ -177,8 +177,8 @@ void TestGraphDataHandler::graphDataTwice()
 
     QSignalSpy spyDataReady(&dataHandler, &GraphDataHandler::graphDataReady);
 
-    dataHandler.handleRegisterData(regResults_1);
-    dataHandler.handleRegisterData(regResults_2);
+    dataHandler.handleRegisterData(SampleFrame(regResults_1, 0));
+    dataHandler.handleRegisterData(SampleFrame(regResults_2, 0));
 
     QCOMPARE(spyDataReady.count(), 2);
 
@@ -209,6 +209,105 @@ void TestGraphDataHandler::graphData_fail()
     CommunicationHelpers::verifyReceivedDataSignal(rawRegData, resultList);
 }
 
+void TestGraphDataHandler::graphDataNotDue()
+{
+    auto exprList = QStringList() << "${40001} + ${40002}"
+                                  << "${40003}"
+                                  << "5";
+
+    CommunicationHelpers::addExpressionsToModel(_pGraphDataModel, exprList);
+
+    auto regResults = ResultDoubleList() << ResultDouble(1, State::SUCCESS)
+                                         << ResultDouble(2, State::SUCCESS)
+                                         << ResultDouble(0, State::NO_VALUE);
+
+    auto resultList = ResultDoubleList() << ResultDouble(3, State::SUCCESS)
+                                         << ResultDouble(0, State::NO_VALUE)
+                                         << ResultDouble(5, State::SUCCESS);
+
+    QList<QVariant> rawRegData;
+    doHandleRegisterData(regResults, rawRegData);
+    CommunicationHelpers::verifyReceivedDataSignal(rawRegData, resultList);
+}
+
+void TestGraphDataHandler::graphDataHold()
+{
+    auto exprList = QStringList() << "${40001} + ${40002}"
+                                  << "${40002}";
+
+    CommunicationHelpers::addExpressionsToModel(_pGraphDataModel, exprList);
+
+    GraphDataHandler dataHandler;
+    dataHandler.processActiveRegisters(_pGraphDataModel);
+
+    QSignalSpy spyDataReady(&dataHandler, &GraphDataHandler::graphDataReady);
+
+    /* Only first register has been read */
+    dataHandler.handleRegisterData(SampleFrame(ResultDoubleList() << ResultDouble(1, State::SUCCESS)
+                                                      << ResultDouble(0, State::NO_VALUE), 0));
+
+    /* Only second register is read, first register is held */
+    dataHandler.handleRegisterData(SampleFrame(ResultDoubleList() << ResultDouble(0, State::NO_VALUE)
+                                                      << ResultDouble(2, State::SUCCESS), 0));
+
+    /* Only first register is read again, second register is held */
+    dataHandler.handleRegisterData(SampleFrame(ResultDoubleList() << ResultDouble(5, State::SUCCESS)
+                                                      << ResultDouble(0, State::NO_VALUE), 0));
+
+    QCOMPARE(spyDataReady.count(), 3);
+
+    CommunicationHelpers::verifyReceivedDataSignal(spyDataReady.takeFirst(),
+                                                   ResultDoubleList() << ResultDouble(0, State::NO_VALUE)
+                                                                      << ResultDouble(0, State::NO_VALUE));
+
+    CommunicationHelpers::verifyReceivedDataSignal(spyDataReady.takeFirst(),
+                                                   ResultDoubleList() << ResultDouble(3, State::SUCCESS)
+                                                                      << ResultDouble(2, State::SUCCESS));
+
+    CommunicationHelpers::verifyReceivedDataSignal(spyDataReady.takeFirst(),
+                                                   ResultDoubleList() << ResultDouble(7, State::SUCCESS)
+                                                                      << ResultDouble(0, State::NO_VALUE));
+}
+
+void TestGraphDataHandler::pollIntervals()
+{
+    auto exprList = QStringList() << "${40001}"
+                                  << "${40001} + ${40002}"
+                                  << "${40003}";
+
+    CommunicationHelpers::addExpressionsToModel(_pGraphDataModel, exprList);
+    _pGraphDataModel->setPollInterval(0, 10);
+    _pGraphDataModel->setPollInterval(2, 1000);
+
+    GraphDataHandler dataHandler;
+    dataHandler.processActiveRegisters(_pGraphDataModel);
+
+    QList<quint32> pollIntervalList;
+    dataHandler.registerPollIntervals(pollIntervalList, 100);
+
+    QCOMPARE(pollIntervalList, QList<quint32>() << 10 << 100 << 1000);
+}
+
+void TestGraphDataHandler::registerDemand()
+{
+    auto exprList = QStringList() << "${40001}"
+                                  << "${40001} + ${40002}"
+                                  << "${40003}";
+
+    CommunicationHelpers::addExpressionsToModel(_pGraphDataModel, exprList);
+    _pGraphDataModel->setVisible(1, false);
+    _pGraphDataModel->setVisible(2, false);
+
+    GraphDataHandler dataHandler;
+    dataHandler.processActiveRegisters(_pGraphDataModel);
+
+    /* 40001 is also used in a visible graph */
+    QList<bool> demandList;
+    dataHandler.registerDemand(demandList);
+
+    QCOMPARE(demandList, QList<bool>() << true << false << false);
+}
+
 void TestGraphDataHandler::doHandleRegisterData(ResultDoubleList& modbusResults, QList<QVariant>& actRawData)
 {
     GraphDataHandler dataHandler;
@@ -217,7 +316,7 @@ void TestGraphDataHandler::doHandleRegisterData(ResultDoubleList& modbusResults,
     dataHandler.modbusRegisterList(registerList);
 
     QSignalSpy spyDataReady(&dataHandler, &GraphDataHandler::graphDataReady);
-    dataHandler.handleRegisterData(modbusResults);
+    dataHandler.handleRegisterData(SampleFrame(modbusResults, 0));
 
     QCOMPARE(spyDataReady.count(), 1);
     actRawData = spyDataReady.takeFirst();
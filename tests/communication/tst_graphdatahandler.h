@@ -29,6 +29,11 @@ private slots:
     void graphData();
     void graphDataTwice();
     void graphData_fail();
+    void graphDataNotDue();
+    void graphDataHold();
+
+    void pollIntervals();
+    void registerDemand();
 
 private:
 
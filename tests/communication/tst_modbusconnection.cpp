@@ -114,6 +114,49 @@ void TestModbusConnection::connectionSuccesAfterFail()
     pConnection->closeConnection();
 }
 
+void TestModbusConnection::lingerConnectionClose()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    ModbusConnection * pConnection = new ModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    /* Idle connection is kept open during linger time */
+    pConnection->lingerConnection(100);
+    QVERIFY(pConnection->isConnected());
+
+    /* And closed afterwards */
+    QTRY_VERIFY_WITH_TIMEOUT(!pConnection->isConnected(), 500);
+}
+
+void TestModbusConnection::lingerConnectionReuse()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    ModbusConnection * pConnection = new ModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    pConnection->lingerConnection(100);
+
+    /* Open during linger time reuses connection immediately */
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QCOMPARE(spySuccess.count(), 2);
+
+    /* Reused connection isn't closed by linger time */
+    QTest::qWait(200);
+    QVERIFY(pConnection->isConnected());
+
+    pConnection->closeConnection();
+}
+
 void TestModbusConnection::readRequestSuccess()
 {
     /* Start server */
@@ -140,7 +183,7 @@ void TestModbusConnection::readRequestSuccess()
     QSignalSpy spyResultProtocolError(pConnection, &ModbusConnection::readRequestProtocolError);
     QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
 
-    pConnection->sendReadRequest(ModbusAddress(40001), 2, _slaveId);
+    pConnection->sendReadRequest(ModbusAddress(40001), 2, _slaveId, 7);
 
     QVERIFY(spyResultSuccess.wait(100));
     QCOMPARE(spyResultSuccess.count(), 1);
@@ -148,8 +191,10 @@ void TestModbusConnection::readRequestSuccess()
     QCOMPARE(spyResultError.count(), 0);
 
     QList<QVariant> arguments = spyResultSuccess.takeFirst();
-    QCOMPARE(arguments.count(), 2);
+    QCOMPARE(arguments.count(), 5);
 
+    /* Check request identity */
+    QCOMPARE(arguments[4].toUInt(), static_cast<quint32>(7));
 
     /* Check start address */
     QVERIFY((arguments[0].canConvert<ModbusAddress>()));
@@ -199,11 +244,102 @@ void TestModbusConnection::readRequestProtocolError()
     QCOMPARE(spyResultError.count(), 0);
 
     QList<QVariant> arguments = spyResultProtocolError.takeFirst();
-    QCOMPARE(arguments.count(), 1);
+    QCOMPARE(arguments.count(), 5);
+
+    /* Check start address */
+    QVERIFY((arguments[0].canConvert<ModbusAddress>()));
+    QCOMPARE(arguments[0].value<ModbusAddress>().fullAddress(), "40001");
 
     /* Check modbus exception */
-    QCOMPARE(static_cast<QModbusPdu::ExceptionCode>(arguments.first().toInt()), QModbusPdu::IllegalDataAddress);
+    QCOMPARE(static_cast<QModbusPdu::ExceptionCode>(arguments[1].toInt()), QModbusPdu::IllegalDataAddress);
+
+}
+
+void TestModbusConnection::readRequestPipelined()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(5, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(10, true);
 
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 100);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(5, 105);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(10, 110);
+
+    /* Open connection */
+    ModbusConnection * pConnection = new ModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultProtocolError(pConnection, &ModbusConnection::readRequestProtocolError);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    /* Send all requests without waiting for a response */
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pConnection->sendReadRequest(ModbusAddress(40006), 1, _slaveId);
+    pConnection->sendReadRequest(ModbusAddress(40011), 1, _slaveId);
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResultSuccess.count(), 3, 500);
+    QCOMPARE(spyResultProtocolError.count(), 0);
+    QCOMPARE(spyResultError.count(), 0);
+
+    /* Every response is matched with its request */
+    QMap<QString, quint16> resultMap;
+    for (const QList<QVariant> &arguments : std::as_const(spyResultSuccess))
+    {
+        auto resultAddr = arguments[0].value<ModbusAddress>();
+        QList<quint16> resultList = arguments[1].value<QList<quint16> >();
+        QCOMPARE(resultList.count(), 1);
+
+        resultMap.insert(resultAddr.fullAddress(), resultList[0]);
+    }
+
+    QCOMPARE(resultMap.size(), 3);
+    QCOMPARE(resultMap["40001"], static_cast<quint16>(100));
+    QCOMPARE(resultMap["40006"], static_cast<quint16>(105));
+    QCOMPARE(resultMap["40011"], static_cast<quint16>(110));
+}
+
+void TestModbusConnection::readRequestAfterAbort()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 100);
+
+    /* Open connection */
+    ModbusConnection * pConnection = new ModbusConnection(this);
+    pConnection->setRequestPolicy(true, 0);
+
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+
+    /* Aborted request is still handled by the client */
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pConnection->abortPendingRequests();
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResultSuccess.count(), 1, 500);
+
+    /* Request was queued behind the aborted request, so it isn't a round-trip time sample */
+    QCOMPARE(pConnection->rttEstimator().sampleCount(), static_cast<quint32>(0));
+
+    /* Client is idle again */
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    QTRY_COMPARE_WITH_TIMEOUT(spyResultSuccess.count(), 2, 500);
+    QCOMPARE(pConnection->rttEstimator().sampleCount(), static_cast<quint32>(1));
+
+    pConnection->closeConnection();
 }
 
 void TestModbusConnection::readRequestError()
@@ -18,8 +18,13 @@ private slots:
     void connectionFail();
     void connectionSuccesAfterFail();
 
+    void lingerConnectionClose();
+    void lingerConnectionReuse();
+
     void readRequestSuccess();
     void readRequestProtocolError();
+    void readRequestPipelined();
+    void readRequestAfterAbort();
     void readRequestError();
 
 private:
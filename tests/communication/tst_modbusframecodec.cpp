@@ -0,0 +1,165 @@
+
+#include <QtTest/QtTest>
+
+#include "tst_modbusframecodec.h"
+
+#include "modbusframecodec.h"
+#include "modbusreaditem.h"
+#include "communicationhelpers.h"
+
+using ObjectType = ModbusAddress::ObjectType;
+using ParseResult = ModbusFrameCodec::ParseResult;
+
+void TestModbusFrameCodec::init()
+{
+
+}
+
+void TestModbusFrameCodec::cleanup()
+{
+
+}
+
+void TestModbusFrameCodec::functionCode()
+{
+    QCOMPARE(ModbusFrameCodec::functionCode(ObjectType::COIL), static_cast<quint8>(0x01));
+    QCOMPARE(ModbusFrameCodec::functionCode(ObjectType::DISCRETE_INPUT), static_cast<quint8>(0x02));
+    QCOMPARE(ModbusFrameCodec::functionCode(ObjectType::HOLDING_REGISTER), static_cast<quint8>(0x03));
+    QCOMPARE(ModbusFrameCodec::functionCode(ObjectType::INPUT_REGISTER), static_cast<quint8>(0x04));
+    QCOMPARE(ModbusFrameCodec::functionCode(ObjectType::UNKNOWN), static_cast<quint8>(0x03));
+}
+
+void TestModbusFrameCodec::tcpReadRequest()
+{
+    char buffer[ModbusFrameCodec::cTcpReadRequestSize];
+
+    ModbusFrameCodec::buildTcpReadRequest(buffer, 0x1234, 1, 0x03, 0x006B, 3);
+
+    QCOMPARE(QByteArray(buffer, sizeof(buffer)), QByteArray::fromHex("1234000000060103006B0003"));
+}
+
+void TestModbusFrameCodec::rtuReadRequest()
+{
+    char buffer[ModbusFrameCodec::cRtuReadRequestSize];
+
+    ModbusFrameCodec::buildRtuReadRequest(buffer, 1, 0x03, 0, 10);
+
+    /* CRC is sent low byte first */
+    QCOMPARE(QByteArray(buffer, sizeof(buffer)), QByteArray::fromHex("01030000000AC5CD"));
+}
+
+void TestModbusFrameCodec::crc16()
+{
+    const QByteArray data("123456789");
+
+    QCOMPARE(ModbusFrameCodec::crc16(data.constData(), data.size()), static_cast<quint16>(0x4B37));
+}
+
+void TestModbusFrameCodec::tcpFrameSize()
+{
+    const QByteArray frame = QByteArray::fromHex("1234000000070103040000000A");
+
+    /* Header not complete */
+    QCOMPARE(ModbusFrameCodec::tcpFrameSize(frame.constData(), 6), static_cast<qsizetype>(0));
+
+    QCOMPARE(ModbusFrameCodec::tcpFrameSize(frame.constData(), frame.size()), static_cast<qsizetype>(13));
+    QCOMPARE(ModbusFrameCodec::tcpTransactionId(frame.constData()), static_cast<quint16>(0x1234));
+    QCOMPARE(ModbusFrameCodec::tcpUnitId(frame.constData()), static_cast<quint8>(1));
+
+    /* Size is known from the header, before the frame is complete */
+    QCOMPARE(ModbusFrameCodec::tcpFrameSize(frame.constData(), 7), static_cast<qsizetype>(13));
+
+    /* Not the Modbus protocol */
+    const QByteArray invalidFrame = QByteArray::fromHex("12340001000701030400");
+    QCOMPARE(ModbusFrameCodec::tcpFrameSize(invalidFrame.constData(), invalidFrame.size()), static_cast<qsizetype>(-1));
+}
+
+void TestModbusFrameCodec::rtuFrameSize()
+{
+    const QByteArray frame = QByteArray::fromHex("010304000A0102605A");
+
+    QCOMPARE(ModbusFrameCodec::rtuFrameSize(frame.constData(), 2), static_cast<qsizetype>(0));
+    QCOMPARE(ModbusFrameCodec::rtuFrameSize(frame.constData(), 3), static_cast<qsizetype>(9));
+    QCOMPARE(ModbusFrameCodec::rtuFrameSize(frame.constData(), frame.size()), static_cast<qsizetype>(9));
+
+    const QByteArray exceptionFrame = QByteArray::fromHex("018302C0F1");
+    QCOMPARE(ModbusFrameCodec::rtuFrameSize(exceptionFrame.constData(), 2), static_cast<qsizetype>(5));
+}
+
+void TestModbusFrameCodec::rtuCrc()
+{
+    const QByteArray frame = QByteArray::fromHex("010304000A0102605A");
+    QVERIFY(ModbusFrameCodec::isRtuCrcValid(frame.constData(), frame.size()));
+
+    QByteArray corruptedFrame = frame;
+    corruptedFrame[4] = 0x0B;
+    QVERIFY(!ModbusFrameCodec::isRtuCrcValid(corruptedFrame.constData(), corruptedFrame.size()));
+
+    const QByteArray exceptionFrame = QByteArray::fromHex("018302C0F1");
+    QVERIFY(ModbusFrameCodec::isRtuCrcValid(exceptionFrame.constData(), exceptionFrame.size()));
+}
+
+void TestModbusFrameCodec::parseRegisters()
+{
+    const QByteArray pdu = QByteArray::fromHex("0304000A0102");
+
+    QList<quint16> values;
+    quint8 exceptionCode = 0;
+    const auto result = ModbusFrameCodec::parseReadResponse(pdu.constData(), pdu.size(), 0x03, 2, values, exceptionCode);
+
+    QCOMPARE(result, ParseResult::SUCCESS);
+    QCOMPARE(values, QList<quint16>({10, 258}));
+}
+
+void TestModbusFrameCodec::parseBits()
+{
+    /* 10 coils: 1, 0, 1, 1, 0, 0, 1, 1, 1, 0 */
+    const QByteArray pdu = QByteArray::fromHex("0102CD01");
+
+    QList<quint16> values;
+    quint8 exceptionCode = 0;
+    const auto result = ModbusFrameCodec::parseReadResponse(pdu.constData(), pdu.size(), 0x01, 10, values, exceptionCode);
+
+    /* Packed in the same way as the other engine passes bits */
+    QCOMPARE(result, ParseResult::SUCCESS);
+    QCOMPARE(values, CommunicationHelpers::packBits(QList<quint16>({1, 0, 1, 1, 0, 0, 1, 1, 1, 0})));
+
+    /* More than 16 bits, padding bits are cleared */
+    const QByteArray largePdu = QByteArray::fromHex("0203FF01FF");
+    const auto largeResult = ModbusFrameCodec::parseReadResponse(largePdu.constData(), largePdu.size(), 0x02, 20, values, exceptionCode);
+
+    QCOMPARE(largeResult, ParseResult::SUCCESS);
+    QCOMPARE(values, QList<quint16>({0x01FF, 0x000F}));
+}
+
+void TestModbusFrameCodec::parseException()
+{
+    const QByteArray pdu = QByteArray::fromHex("8302");
+
+    QList<quint16> values;
+    quint8 exceptionCode = 0;
+    const auto result = ModbusFrameCodec::parseReadResponse(pdu.constData(), pdu.size(), 0x03, 2, values, exceptionCode);
+
+    QCOMPARE(result, ParseResult::EXCEPTION);
+    QCOMPARE(exceptionCode, static_cast<quint8>(0x02));
+}
+
+void TestModbusFrameCodec::parseInvalid()
+{
+    QList<quint16> values;
+    quint8 exceptionCode = 0;
+
+    /* Other function code */
+    const QByteArray otherFunctionPdu = QByteArray::fromHex("0404000A0102");
+    QCOMPARE(ModbusFrameCodec::parseReadResponse(otherFunctionPdu.constData(), otherFunctionPdu.size(), 0x03, 2, values, exceptionCode), ParseResult::INVALID);
+
+    /* Byte count doesn't match request */
+    const QByteArray byteCountPdu = QByteArray::fromHex("0302000A");
+    QCOMPARE(ModbusFrameCodec::parseReadResponse(byteCountPdu.constData(), byteCountPdu.size(), 0x03, 2, values, exceptionCode), ParseResult::INVALID);
+
+    /* Truncated */
+    const QByteArray truncatedPdu = QByteArray::fromHex("0304000A");
+    QCOMPARE(ModbusFrameCodec::parseReadResponse(truncatedPdu.constData(), truncatedPdu.size(), 0x03, 2, values, exceptionCode), ParseResult::INVALID);
+}
+
+QTEST_GUILESS_MAIN(TestModbusFrameCodec)
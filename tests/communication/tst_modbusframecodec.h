@@ -0,0 +1,25 @@
+
+#include <QObject>
+
+class TestModbusFrameCodec: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void functionCode();
+    void tcpReadRequest();
+    void rtuReadRequest();
+    void crc16();
+    void tcpFrameSize();
+    void rtuFrameSize();
+    void rtuCrc();
+    void parseRegisters();
+    void parseBits();
+    void parseException();
+    void parseInvalid();
+
+private:
+
+};
@@ -20,6 +20,7 @@ void TestModbusMaster::init()
     _settingsModel.setPort(Connection::ID_1, 5020);
     _settingsModel.setTimeout(Connection::ID_1, 500);
     _settingsModel.setSlaveId(Connection::ID_1, 1);
+    _settingsModel.setRequestWindow(Connection::ID_1, 1);
 
     _serverConnectionData.setPort(_settingsModel.port(Connection::ID_1));
     _serverConnectionData.setHost(_settingsModel.ipAddress(Connection::ID_1));
@@ -73,8 +74,8 @@ void TestModbusMaster::singleRequestSuccess()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 1);
 
         QVERIFY(result[ModbusAddress(40001)].isValid());
@@ -99,8 +100,8 @@ void TestModbusMaster::singleRequestEmpty()
     QVERIFY(arguments.count() > 0);
 
     QVariant varResultList = arguments.first();
-    QVERIFY(varResultList.canConvert<ModbusResultMap>());
-    ModbusResultMap result = varResultList.value<ModbusResultMap >();
+    QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+    ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
     QCOMPARE(result.size(), 0);
 }
 
@@ -123,8 +124,8 @@ void TestModbusMaster::singleRequestGatewayNotAvailable()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 1);
 
         QVERIFY(result[ModbusAddress(40001)].isValid() == false);
@@ -151,8 +152,8 @@ void TestModbusMaster::singleRequestNoResponse()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 1);
 
         QVERIFY(result[ModbusAddress(40001)].isValid() == false);
@@ -184,8 +185,8 @@ void TestModbusMaster::singleRequestInvalidAddressOnce()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 3);
 
         QVERIFY(result[ModbusAddress(40001)].isValid() == false);
@@ -219,8 +220,8 @@ void TestModbusMaster::singleRequestInvalidAddressPersistent()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 1);
 
         QVERIFY(result[ModbusAddress(40001)].isValid() == false);
@@ -253,8 +254,8 @@ void TestModbusMaster::multiRequestSuccess()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 3);
 
         QVERIFY(result[ModbusAddress(40001)].isValid());
@@ -296,8 +297,8 @@ void TestModbusMaster::multiRequestGatewayNotAvailable()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 3);
 
         QVERIFY(result[ModbusAddress(40001)].isValid() == false);
@@ -335,8 +336,8 @@ void TestModbusMaster::multiRequestNoResponse()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 3);
 
         QVERIFY(result[ModbusAddress(40001)].isValid() == false);
@@ -373,8 +374,8 @@ void TestModbusMaster::multiRequestInvalidAddress()
         QVERIFY(arguments.count() > 0);
 
         QVariant varResultList = arguments.first();
-        QVERIFY(varResultList.canConvert<ModbusResultMap>());
-        ModbusResultMap result = varResultList.value<ModbusResultMap >();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
         QCOMPARE(result.size(), 3);
 
         QVERIFY(result[ModbusAddress(40001)].isValid() == false);
@@ -383,6 +384,155 @@ void TestModbusMaster::multiRequestInvalidAddress()
     }
 }
 
+void TestModbusMaster::multiRequestPipelinedSuccess()
+{
+    _settingsModel.setRequestWindow(Connection::ID_1, 3);
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(1, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(3, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(5, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(7, true);
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 0);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(1, 1);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(3, 3);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(5, 5);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(7, 7);
+
+    ModbusMaster modbusMaster(&_settingsModel, Connection::ID_1);
+
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002) << ModbusAddress(40004)
+                                               << ModbusAddress(40006) << ModbusAddress(40008);
+    QSignalSpy spyModbusPollDone(&modbusMaster, &ModbusMaster::modbusPollDone);
+
+    for (uint i = 0; i < _cReadCount; i++)
+    {
+        modbusMaster.readRegisterList(registerList);
+
+        QVERIFY(spyModbusPollDone.wait(static_cast<int>(_settingsModel.timeout(Connection::ID_1))));
+        QCOMPARE(spyModbusPollDone.count(), 1);
+
+        QList<QVariant> arguments = spyModbusPollDone.takeFirst();
+        QVERIFY(arguments.count() > 0);
+
+        QVariant varResultList = arguments.first();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
+        QCOMPARE(result.size(), 5);
+
+        QVERIFY(result[ModbusAddress(40001)].isValid());
+        QCOMPARE(result[ModbusAddress(40001)].value(), static_cast<quint16>(0));
+
+        QVERIFY(result[ModbusAddress(40002)].isValid());
+        QCOMPARE(result[ModbusAddress(40002)].value(), static_cast<quint16>(1));
+
+        QVERIFY(result[ModbusAddress(40004)].isValid());
+        QCOMPARE(result[ModbusAddress(40004)].value(), static_cast<quint16>(3));
+
+        QVERIFY(result[ModbusAddress(40006)].isValid());
+        QCOMPARE(result[ModbusAddress(40006)].value(), static_cast<quint16>(5));
+
+        QVERIFY(result[ModbusAddress(40008)].isValid());
+        QCOMPARE(result[ModbusAddress(40008)].value(), static_cast<quint16>(7));
+
+        /* Make sure no late results are reported */
+        QVERIFY(!spyModbusPollDone.wait(50));
+    }
+}
+
+void TestModbusMaster::multiRequestPipelinedInvalidAddress()
+{
+    _settingsModel.setRequestWindow(Connection::ID_1, 3);
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(1, false);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(3, true);
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 0);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(3, 3);
+
+    ModbusMaster modbusMaster(&_settingsModel, Connection::ID_1);
+
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002) << ModbusAddress(40004);
+    QSignalSpy spyModbusPollDone(&modbusMaster, &ModbusMaster::modbusPollDone);
+
+    for (uint i = 0; i < _cReadCount; i++)
+    {
+        modbusMaster.readRegisterList(registerList);
+
+        QVERIFY(spyModbusPollDone.wait(static_cast<int>(_settingsModel.timeout(Connection::ID_1))));
+        QCOMPARE(spyModbusPollDone.count(), 1);
+
+        QList<QVariant> arguments = spyModbusPollDone.takeFirst();
+        QVERIFY(arguments.count() > 0);
+
+        QVariant varResultList = arguments.first();
+        QVERIFY(varResultList.canConvert<ModbusResultFrame>());
+        ModbusResultMap result = varResultList.value<ModbusResultFrame>().toResultMap();
+        QCOMPARE(result.size(), 3);
+
+        QVERIFY(result[ModbusAddress(40001)].isValid());
+        QCOMPARE(result[ModbusAddress(40001)].value(), static_cast<quint16>(0));
+
+        QVERIFY(result[ModbusAddress(40002)].isValid() == false);
+
+        QVERIFY(result[ModbusAddress(40004)].isValid());
+        QCOMPARE(result[ModbusAddress(40004)].value(), static_cast<quint16>(3));
+    }
+}
+
+void TestModbusMaster::warmUpAfterCleanUp()
+{
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+
+    ModbusMaster modbusMaster(&_settingsModel, Connection::ID_1);
+
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(40001);
+    QSignalSpy spyModbusPollDone(&modbusMaster, &ModbusMaster::modbusPollDone);
+    QSignalSpy spyConnectionReady(&modbusMaster, &ModbusMaster::connectionReady);
+
+    /* Session is stopped before its read is done */
+    modbusMaster.readRegisterList(registerList);
+    modbusMaster.cleanUp();
+
+    /* Next session */
+    modbusMaster.warmUp();
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyConnectionReady.count(), 1, 100);
+    QCOMPARE(spyConnectionReady.first()[1].toBool(), true);
+
+    /* Read of the stopped session isn't published */
+    QVERIFY(!spyModbusPollDone.wait(100));
+}
+
+void TestModbusMaster::connectionErrorWhileRunning()
+{
+    /* UDP isn't supported by Qt's client: the error is emitted from within the running read sequence */
+    _settingsModel.setNativeEngine(false);
+    _settingsModel.setConnectionType(Connection::ID_1, Connection::TYPE_UDP);
+
+    ModbusMaster modbusMaster(&_settingsModel, Connection::ID_1);
+
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(40001);
+    QSignalSpy spyModbusPollDone(&modbusMaster, &ModbusMaster::modbusPollDone);
+
+    for (uint i = 0; i < _cReadCount; i++)
+    {
+        modbusMaster.readRegisterList(registerList);
+
+        QVERIFY(spyModbusPollDone.wait(100));
+        QCOMPARE(spyModbusPollDone.count(), 1);
+
+        ModbusResultMap result = spyModbusPollDone.takeFirst().first().value<ModbusResultFrame>().toResultMap();
+        QCOMPARE(result.size(), 1);
+        QVERIFY(result[ModbusAddress(40001)].isValid() == false);
+    }
+
+    QVERIFY(modbusMaster.readFailed());
+
+    _settingsModel.setConnectionType(Connection::ID_1, Connection::TYPE_TCP);
+}
 
 /* TODO:
  * Add extra test with actual timeout of no response
@@ -25,6 +25,11 @@ private slots:
     void multiRequestGatewayNotAvailable();
     void multiRequestNoResponse();
     void multiRequestInvalidAddress();
+    void multiRequestPipelinedSuccess();
+    void multiRequestPipelinedInvalidAddress();
+
+    void warmUpAfterCleanUp();
+    void connectionErrorWhileRunning();
 
 private:
 
@@ -1,6 +1,8 @@
 
 #include <QtTest/QtTest>
 #include <QMap>
+#include <QDeadlineTimer>
+#include <algorithm>
 
 #include "modbuspoll.h"
 #include "testslavedata.h"
@@ -41,7 +43,7 @@ void TestModbusPoll::init()
 
     _pSettingsModel->setPollTime(100);
 
-    for (quint8 idx = 0; idx < Connection::ID_CNT; idx++)
+    for (quint8 idx = 0; idx < _pSettingsModel->connectionCount(); idx++)
     {
         _serverConnectionDataList.append(QUrl());
         _serverConnectionDataList.last().setPort(_pSettingsModel->port(idx));
@@ -63,7 +65,7 @@ void TestModbusPoll::cleanup()
 {
     delete _pSettingsModel;
 
-    for (int idx = 0; idx < Connection::ID_CNT; idx++)
+    for (qsizetype idx = 0; idx < _testSlaveModbusList.size(); idx++)
     {
         _testSlaveModbusList[idx]->disconnectDevice();
     }
@@ -115,7 +117,7 @@ void TestModbusPoll::singleSlaveSuccess()
 
 void TestModbusPoll::singleSlaveFail()
 {
-    for (quint8 idx = 0; idx < Connection::ID_CNT; idx++)
+    for (qsizetype idx = 0; idx < _testSlaveModbusList.size(); idx++)
     {
         _testSlaveModbusList[idx]->disconnectDevice();
     }
@@ -274,6 +276,44 @@ void TestModbusPoll::verifyRestartAfterStop()
     CommunicationHelpers::verifyReceivedDataSignal(arguments, expResults);
 }
 
+void TestModbusPoll::communicationThread()
+{
+    dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
+    dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterValue(0, 5);
+
+    QThread communicationThread;
+    auto pModbusPoll = new ModbusPoll(_pSettingsModel);
+    pModbusPoll->moveToThread(&communicationThread);
+    connect(&communicationThread, &QThread::finished, pModbusPoll, &QObject::deleteLater);
+    communicationThread.start();
+
+    QSignalSpy spyDataReady(pModbusPoll, &ModbusPoll::registerDataReady);
+
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16);
+
+    /*-- Start communication --*/
+    pModbusPoll->startCommunication(modbusRegisters);
+    QVERIFY(pModbusPoll->isActive());
+
+    /* Running session uses snapshot of settings */
+    _pSettingsModel->setPort(Connection::ID_1, 5099);
+
+    QVERIFY(spyDataReady.wait(100));
+
+    QList<QVariant> arguments = spyDataReady.takeFirst();
+    auto expResults = ResultDoubleList() << ResultDouble(5, State::SUCCESS);
+
+    /* Verify arguments of signal */
+    CommunicationHelpers::verifyReceivedDataSignal(arguments, expResults);
+
+    /*-- Stop communication --*/
+    pModbusPoll->stopCommunication();
+    QVERIFY(!pModbusPoll->isActive());
+
+    communicationThread.quit();
+    QVERIFY(communicationThread.wait());
+}
+
 void TestModbusPoll::multiSlaveSuccess()
 {
     dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
@@ -291,15 +331,13 @@ void TestModbusPoll::multiSlaveSuccess()
     /*-- Start communication --*/
     modbusPoll.startCommunication(modbusRegisters);
 
-    QVERIFY(spyDataReady.wait(50));
-    QCOMPARE(spyDataReady.count(), 1);
-
-    QList<QVariant> arguments = spyDataReady.takeFirst();
+    /* Every connection publishes its own results */
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, 50, actResults));
     auto expResults = ResultDoubleList() << ResultDouble(5020, State::SUCCESS)
                                             << ResultDouble(5021, State::SUCCESS);
 
-    /* Verify arguments of signal */
-    CommunicationHelpers::verifyReceivedDataSignal(arguments, expResults);
+    QCOMPARE(actResults, expResults);
 }
 
 void TestModbusPoll::multiSlaveSuccess_2()
@@ -319,15 +357,13 @@ void TestModbusPoll::multiSlaveSuccess_2()
     /*-- Start communication --*/
     modbusPoll.startCommunication(modbusRegisters);
 
-    QVERIFY(spyDataReady.wait(50));
-    QCOMPARE(spyDataReady.count(), 1);
-
-    QList<QVariant> arguments = spyDataReady.takeFirst();
+    /* Every connection publishes its own results */
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, 50, actResults));
     auto expResults = ResultDoubleList() << ResultDouble(5020, State::SUCCESS)
                                             << ResultDouble(5021, State::SUCCESS);
 
-    /* Verify arguments of signal */
-    CommunicationHelpers::verifyReceivedDataSignal(arguments, expResults);
+    QCOMPARE(actResults, expResults);
 }
 
 void TestModbusPoll::multiSlaveSuccess_3()
@@ -351,16 +387,14 @@ void TestModbusPoll::multiSlaveSuccess_3()
     /*-- Start communication --*/
     modbusPoll.startCommunication(modbusRegisters);
 
-    QVERIFY(spyDataReady.wait(50));
-    QCOMPARE(spyDataReady.count(), 1);
-
-    QList<QVariant> arguments = spyDataReady.takeFirst();
+    /* Every connection publishes its own results */
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, 50, actResults));
     auto expResults = ResultDoubleList() << ResultDouble(5020, State::SUCCESS)
                                             << ResultDouble(5022, State::SUCCESS)
                                             << ResultDouble(5021, State::SUCCESS);
 
-    /* Verify arguments of signal */
-    CommunicationHelpers::verifyReceivedDataSignal(arguments, expResults);
+    QCOMPARE(actResults, expResults);
 }
 
 void TestModbusPoll::multiSlaveSingleFail()
@@ -379,20 +413,18 @@ void TestModbusPoll::multiSlaveSingleFail()
     /*-- Start communication --*/
     modbusPoll.startCommunication(modbusRegisters);
 
-    QVERIFY(spyDataReady.wait(static_cast<int>(_pSettingsModel->timeout(Connection::ID_1)) + 100));
-    QCOMPARE(spyDataReady.count(), 1);
-
-    QList<QVariant> arguments = spyDataReady.takeFirst();
+    /* Every connection publishes its own results */
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, static_cast<int>(_pSettingsModel->timeout(Connection::ID_1)) + 100, actResults));
     auto expResults = ResultDoubleList() << ResultDouble(0, State::INVALID)
                                             << ResultDouble(5021, State::SUCCESS);
 
-    /* Verify arguments of signal */
-    CommunicationHelpers::verifyReceivedDataSignal(arguments, expResults);
+    QCOMPARE(actResults, expResults);
 }
 
 void TestModbusPoll::multiSlaveAllFail()
 {
-    for (quint8 idx = 0; idx < Connection::ID_CNT; idx++)
+    for (qsizetype idx = 0; idx < _testSlaveModbusList.size(); idx++)
     {
         _testSlaveModbusList[idx]->disconnectDevice();
     }
@@ -406,15 +438,13 @@ void TestModbusPoll::multiSlaveAllFail()
     /*-- Start communication --*/
     modbusPoll.startCommunication(modbusRegisters);
 
-    QVERIFY(spyDataReady.wait(static_cast<int>(_pSettingsModel->timeout(Connection::ID_1)) + 100));
-    QCOMPARE(spyDataReady.count(), 1);
-
-    QList<QVariant> arguments = spyDataReady.takeFirst();
+    /* Every connection publishes its own results */
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, static_cast<int>(_pSettingsModel->timeout(Connection::ID_1)) + 100, actResults));
     auto expResults = ResultDoubleList() << ResultDouble(0, State::INVALID)
                                             << ResultDouble(0, State::INVALID);
 
-    /* Verify arguments of signal */
-    CommunicationHelpers::verifyReceivedDataSignal(arguments, expResults);
+    QCOMPARE(actResults, expResults);
 }
 
 void TestModbusPoll::multiSlaveDisabledConnection()
@@ -437,22 +467,197 @@ void TestModbusPoll::multiSlaveDisabledConnection()
     /*-- Start communication --*/
     modbusPoll.startCommunication(modbusRegisters);
 
-    QVERIFY(spyDataReady.wait(50));
-    QCOMPARE(spyDataReady.count(), 1);
-
-    QList<QVariant> arguments = spyDataReady.takeFirst();
+    /* Every connection publishes its own results */
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, 50, actResults));
 
     /* Disabled connections return error and zero */
     auto expResults = ResultDoubleList() << ResultDouble(5020, State::SUCCESS)
                                             << ResultDouble(0, State::INVALID);
 
+    QCOMPARE(actResults, expResults);
+}
+
+void TestModbusPoll::multiSlaveSlowConnection()
+{
+    /* Connection 1 only returns after time-out */
+    _testSlaveModbusList[Connection::ID_1]->disconnectDevice();
+
+    dataMap(Connection::ID_2, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
+    dataMap(Connection::ID_2, QModbusDataUnit::HoldingRegisters)->setRegisterValue(0, 5021);
+
+    ModbusPoll modbusPoll(_pSettingsModel);
+    QSignalSpy spyDataReady(&modbusPoll, &ModbusPoll::registerDataReady);
+
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40001), Connection::ID_2, Type::UNSIGNED_16);
+
+    /*-- Start communication --*/
+    modbusPoll.startCommunication(modbusRegisters);
+
+    /* Results of connection 2 don't wait for time-out of connection 1 */
+    QVERIFY(spyDataReady.wait(50));
+
+    QList<QVariant> arguments = spyDataReady.takeFirst();
+    auto expResults = ResultDoubleList() << ResultDouble(0, State::NO_VALUE)
+                                         << ResultDouble(5021, State::SUCCESS);
+
     /* Verify arguments of signal */
     CommunicationHelpers::verifyReceivedDataSignal(arguments, expResults);
 }
 
+void TestModbusPoll::multiSlaveWarmUp()
+{
+    _testSlaveModbusList[Connection::ID_2]->disconnectDevice();
+
+    dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
+    dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterValue(0, 5020);
+
+    ModbusPoll modbusPoll(_pSettingsModel);
+    QSignalSpy spyConnectionReady(&modbusPoll, &ModbusPoll::connectionReady);
+    QSignalSpy spyDataReady(&modbusPoll, &ModbusPoll::registerDataReady);
+
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40001), Connection::ID_2, Type::UNSIGNED_16);
+
+    /*-- Start communication --*/
+    modbusPoll.startCommunication(modbusRegisters);
+
+    /* Both connections are opened at start, before the first poll */
+    QTRY_COMPARE_WITH_TIMEOUT(spyConnectionReady.count(), 2, static_cast<int>(_pSettingsModel->timeout(Connection::ID_2)) + 100);
+
+    QMap<quint8, bool> readyMap;
+    for (const QList<QVariant>& arguments : std::as_const(spyConnectionReady))
+    {
+        readyMap.insert(arguments[0].value<quint8>(), arguments[1].toBool());
+    }
+
+    QCOMPARE(readyMap.value(Connection::ID_1, false), true);
+    QCOMPARE(readyMap.value(Connection::ID_2, true), false);
+
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, static_cast<int>(_pSettingsModel->timeout(Connection::ID_2)) + 100, actResults));
+    auto expResults = ResultDoubleList() << ResultDouble(5020, State::SUCCESS)
+                                            << ResultDouble(0, State::INVALID);
+
+    QCOMPARE(actResults, expResults);
+}
+
 TestSlaveData* TestModbusPoll::dataMap(uint32_t connId, QModbusDataUnit::RegisterType type)
 {
     return (_testSlaveDataList[connId])->value(type);
 }
 
+/*!
+ * Wait until every register has a result
+ * Connections publish their results independently, so the results of all received signals are merged
+ */
+void TestModbusPoll::multiSlaveConcurrencyLimit()
+{
+    dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
+    dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterValue(0, 5020);
+
+    dataMap(Connection::ID_2, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
+    dataMap(Connection::ID_2, QModbusDataUnit::HoldingRegisters)->setRegisterValue(0, 5021);
+
+    dataMap(Connection::ID_3, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
+    dataMap(Connection::ID_3, QModbusDataUnit::HoldingRegisters)->setRegisterValue(0, 5022);
+
+    /* Connections are polled one by one */
+    _pSettingsModel->setMaxConcurrentConnections(1);
+
+    ModbusPoll modbusPoll(_pSettingsModel);
+    QSignalSpy spyDataReady(&modbusPoll, &ModbusPoll::registerDataReady);
+
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40001), Connection::ID_2, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40001), Connection::ID_3, Type::UNSIGNED_16);
+
+    /*-- Start communication --*/
+    modbusPoll.startCommunication(modbusRegisters);
+
+    /* Waiting connections are polled when a slot is free */
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, 100, actResults));
+    auto expResults = ResultDoubleList() << ResultDouble(5020, State::SUCCESS)
+                                            << ResultDouble(5021, State::SUCCESS)
+                                            << ResultDouble(5022, State::SUCCESS);
+
+    QCOMPARE(actResults, expResults);
+}
+
+void TestModbusPoll::extraConnection()
+{
+    dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
+    dataMap(Connection::ID_1, QModbusDataUnit::HoldingRegisters)->setRegisterValue(0, 5020);
+
+    dataMap(Connection::ID_2, QModbusDataUnit::HoldingRegisters)->setRegisterState(0, true);
+    dataMap(Connection::ID_2, QModbusDataUnit::HoldingRegisters)->setRegisterValue(0, 5021);
+
+    /* Connection beyond the default connections, to the same slave as connection 2 */
+    const quint8 extraId = Connection::cDefaultCount;
+    _pSettingsModel->setConnectionCount(Connection::cDefaultCount + 1);
+    _pSettingsModel->setConnectionState(extraId, true);
+    _pSettingsModel->setIpAddress(extraId, _pSettingsModel->ipAddress(Connection::ID_2));
+    _pSettingsModel->setPort(extraId, _pSettingsModel->port(Connection::ID_2));
+    _pSettingsModel->setTimeout(extraId, 500);
+    _pSettingsModel->setSlaveId(extraId, _pSettingsModel->slaveId(Connection::ID_2));
+
+    ModbusPoll modbusPoll(_pSettingsModel);
+    QSignalSpy spyDataReady(&modbusPoll, &ModbusPoll::registerDataReady);
+
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40001), extraId, Type::UNSIGNED_16);
+
+    /*-- Start communication --*/
+    modbusPoll.startCommunication(modbusRegisters);
+
+    ResultDoubleList actResults;
+    QVERIFY(waitForAllResults(spyDataReady, 50, actResults));
+    auto expResults = ResultDoubleList() << ResultDouble(5020, State::SUCCESS)
+                                            << ResultDouble(5021, State::SUCCESS);
+
+    QCOMPARE(actResults, expResults);
+}
+
+bool TestModbusPoll::waitForAllResults(QSignalSpy& spyDataReady, int timeout, ResultDoubleList& results)
+{
+    QDeadlineTimer deadline(timeout);
+
+    forever
+    {
+        results.clear();
+        for (const QList<QVariant>& arguments : std::as_const(spyDataReady))
+        {
+            const auto resultList = arguments[0].value<SampleFrame>();
+            if (results.isEmpty())
+            {
+                results = ResultDoubleList(resultList.size(), ResultDouble(0, State::NO_VALUE));
+            }
+
+            for (qint32 idx = 0; idx < resultList.size() && idx < results.size(); idx++)
+            {
+                if (resultList[idx].state() != State::NO_VALUE)
+                {
+                    results[idx] = resultList[idx];
+                }
+            }
+        }
+
+        const bool bComplete = !results.isEmpty()
+                               && std::none_of(results.cbegin(), results.cend(), [](const ResultDouble& result) {
+                                      return result.state() == State::NO_VALUE;
+                                  });
+        if (bComplete)
+        {
+            return true;
+        }
+
+        if (deadline.hasExpired() || !spyDataReady.wait(static_cast<int>(deadline.remainingTime())))
+        {
+            return false;
+        }
+    }
+}
+
 QTEST_GUILESS_MAIN(TestModbusPoll)
@@ -1,6 +1,7 @@
 
 #include <QObject>
 #include <QUrl>
+#include <QSignalSpy>
 
 #include "settingsmodel.h"
 
@@ -22,6 +23,7 @@ private slots:
     void singleSlaveMixedObjects();
 
     void verifyRestartAfterStop();
+    void communicationThread();
 
     void multiSlaveSuccess();
     void multiSlaveSuccess_2();
@@ -29,10 +31,15 @@ private slots:
     void multiSlaveSingleFail();
     void multiSlaveAllFail();
     void multiSlaveDisabledConnection();
+    void multiSlaveSlowConnection();
+    void multiSlaveConcurrencyLimit();
+    void multiSlaveWarmUp();
+    void extraConnection();
 
 private:
 
     TestSlaveData* dataMap(uint32_t connId, QModbusDataUnit::RegisterType type);
+    bool waitForAllResults(QSignalSpy& spyDataReady, int timeout, ResultDoubleList& results);
 
     SettingsModel * _pSettingsModel;
 
@@ -0,0 +1,468 @@
+
+#include <QtTest/QtTest>
+
+#include "tst_nativemodbusconnection.h"
+#include "modbusreaditem.h"
+#include "communicationhelpers.h"
+
+Q_DECLARE_METATYPE(ModbusAddress);
+
+void TestNativeModbusConnection::init()
+{
+    qRegisterMetaType<QModbusDevice::Error>("QModbusDevice::Error");
+
+    _slaveId = 1;
+    _serverConnectionData.setPort(5020);
+    _serverConnectionData.setHost("127.0.0.1");
+
+    if (!_testSlaveData.isEmpty())
+    {
+        qDeleteAll(_testSlaveData);
+        _testSlaveData.clear();
+    }
+    if (!_pTestSlaveUdp.isNull())
+    {
+        delete _pTestSlaveUdp;
+    }
+    if (!_pTestSlaveModbus.isNull())
+    {
+        delete _pTestSlaveModbus;
+    }
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters] = new TestSlaveData();
+    _testSlaveData[QModbusDataUnit::Coils] = new TestSlaveData();
+    _pTestSlaveModbus = new TestSlaveModbus(_testSlaveData);
+    _pTestSlaveUdp = new TestSlaveUdp(_pTestSlaveModbus);
+
+    /* Server not started */
+}
+
+void TestNativeModbusConnection::cleanup()
+{
+    _pTestSlaveModbus->disconnectDevice();
+    _pTestSlaveUdp->disconnect();
+
+    if (!_testSlaveData.isEmpty())
+    {
+        qDeleteAll(_testSlaveData);
+        _testSlaveData.clear();
+    }
+    delete _pTestSlaveUdp;
+    delete _pTestSlaveModbus;
+}
+
+void TestNativeModbusConnection::connectionSuccess()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    QSignalSpy spyError(pConnection, &ModbusConnection::connectionError);
+
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QCOMPARE(spySuccess.count(), 1);
+    QCOMPARE(spyError.count(), 0);
+
+    QVERIFY(pConnection->isConnected());
+
+    pConnection->closeConnection();
+
+    QVERIFY(!pConnection->isConnected());
+}
+
+void TestNativeModbusConnection::connectionFail()
+{
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    QSignalSpy spyError(pConnection, &ModbusConnection::connectionError);
+
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spyError.wait(1500));
+
+    QCOMPARE(spySuccess.count(), 0);
+    QCOMPARE(spyError.count(), 1);
+
+    QVERIFY(!pConnection->isConnected());
+}
+
+void TestNativeModbusConnection::lingerConnectionReuse()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QVERIFY(spySuccess.wait(100));
+
+    pConnection->lingerConnection(100);
+
+    /* Open during linger time reuses connection immediately */
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+    QCOMPARE(spySuccess.count(), 2);
+
+    /* Reused connection isn't closed by linger time */
+    QTest::qWait(200);
+    QVERIFY(pConnection->isConnected());
+
+    pConnection->closeConnection();
+}
+
+void TestNativeModbusConnection::readRequestSuccess()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(1, true);
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 0);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(1, 1);
+
+    /* Open connection */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultProtocolError(pConnection, &ModbusConnection::readRequestProtocolError);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    pConnection->sendReadRequest(ModbusAddress(40001), 2, _slaveId, 7);
+
+    QVERIFY(spyResultSuccess.wait(100));
+    QCOMPARE(spyResultSuccess.count(), 1);
+    QCOMPARE(spyResultProtocolError.count(), 0);
+    QCOMPARE(spyResultError.count(), 0);
+
+    QList<QVariant> arguments = spyResultSuccess.takeFirst();
+    QCOMPARE(arguments.count(), 5);
+
+    /* Check request identity */
+    QCOMPARE(arguments[4].toUInt(), static_cast<quint32>(7));
+
+    /* Check start address */
+    QCOMPARE(arguments[0].value<ModbusAddress>().fullAddress(), "40001");
+
+    /* Check result */
+    QList<quint16> resultList = arguments[1].value<QList<quint16> >();
+    QCOMPARE(resultList, QList<quint16>({0, 1}));
+
+    /* Check server address */
+    QCOMPARE(arguments[3].toInt(), static_cast<int>(_slaveId));
+
+    /* Round-trip time is measured */
+    QCOMPARE(pConnection->rttEstimator().sampleCount(), static_cast<quint32>(1));
+}
+
+void TestNativeModbusConnection::readRequestProtocolError()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, false);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(1, true);
+
+    /* Open connection */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultProtocolError(pConnection, &ModbusConnection::readRequestProtocolError);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    pConnection->sendReadRequest(ModbusAddress(40001), 2, _slaveId);
+
+    QVERIFY(spyResultProtocolError.wait(100));
+    QCOMPARE(spyResultSuccess.count(), 0);
+    QCOMPARE(spyResultProtocolError.count(), 1);
+    QCOMPARE(spyResultError.count(), 0);
+
+    QList<QVariant> arguments = spyResultProtocolError.takeFirst();
+    QCOMPARE(arguments.count(), 5);
+
+    QCOMPARE(arguments[0].value<ModbusAddress>().fullAddress(), "40001");
+    QCOMPARE(static_cast<QModbusPdu::ExceptionCode>(arguments[1].toInt()), QModbusPdu::IllegalDataAddress);
+}
+
+void TestNativeModbusConnection::readRequestPipelined()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(5, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(10, true);
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 100);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(5, 105);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(10, 110);
+
+    /* Open connection */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    /* Send all requests without waiting for a response */
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pConnection->sendReadRequest(ModbusAddress(40006), 1, _slaveId);
+    pConnection->sendReadRequest(ModbusAddress(40011), 1, _slaveId);
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResultSuccess.count(), 3, 500);
+    QCOMPARE(spyResultError.count(), 0);
+
+    /* Every response is matched with its request on transaction id */
+    QMap<QString, quint16> resultMap;
+    for (const QList<QVariant> &arguments : std::as_const(spyResultSuccess))
+    {
+        auto resultAddr = arguments[0].value<ModbusAddress>();
+        QList<quint16> resultList = arguments[1].value<QList<quint16> >();
+        QCOMPARE(resultList.count(), 1);
+
+        resultMap.insert(resultAddr.fullAddress(), resultList[0]);
+    }
+
+    QCOMPARE(resultMap.size(), 3);
+    QCOMPARE(resultMap["40001"], static_cast<quint16>(100));
+    QCOMPARE(resultMap["40006"], static_cast<quint16>(105));
+    QCOMPARE(resultMap["40011"], static_cast<quint16>(110));
+}
+
+void TestNativeModbusConnection::readRequestCoils()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    const QList<quint16> coils = {1, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1, 1};
+    for (quint32 idx = 0; idx < static_cast<quint32>(coils.size()); idx++)
+    {
+        _testSlaveData[QModbusDataUnit::Coils]->setRegisterState(idx, true);
+        _testSlaveData[QModbusDataUnit::Coils]->setRegisterValue(idx, coils[idx]);
+    }
+
+    /* Open connection */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+
+    pConnection->sendReadRequest(ModbusAddress(0, ModbusAddress::ObjectType::COIL), static_cast<quint16>(coils.size()), _slaveId);
+
+    QVERIFY(spyResultSuccess.wait(100));
+
+    /* Bits are passed packed, 16 per word */
+    QList<QVariant> arguments = spyResultSuccess.takeFirst();
+    QCOMPARE(arguments[1].value<QList<quint16> >(), CommunicationHelpers::packBits(coils));
+}
+
+void TestNativeModbusConnection::abortPendingRequests()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveModbus->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 100);
+
+    /* Open connection */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openTcpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pConnection->abortPendingRequests();
+
+    /* Late response is ignored */
+    QVERIFY(!spyResultSuccess.wait(100));
+    QCOMPARE(spyResultError.count(), 0);
+
+    /* Connection is still usable */
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    QVERIFY(spyResultSuccess.wait(100));
+    QCOMPARE(spyResultSuccess.count(), 1);
+}
+
+void TestNativeModbusConnection::udpReadRequestSuccess()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveUdp->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(1, true);
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 0);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(1, 1);
+
+    /* Open connection */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openUdpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+    QVERIFY(pConnection->isConnected());
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    pConnection->sendReadRequest(ModbusAddress(40001), 2, _slaveId);
+
+    QVERIFY(spyResultSuccess.wait(100));
+    QCOMPARE(spyResultSuccess.count(), 1);
+    QCOMPARE(spyResultError.count(), 0);
+
+    QList<QVariant> arguments = spyResultSuccess.takeFirst();
+    QCOMPARE(arguments[0].value<ModbusAddress>().fullAddress(), "40001");
+    QCOMPARE(arguments[1].value<QList<quint16> >(), QList<quint16>({0, 1}));
+    QCOMPARE(arguments[3].toInt(), static_cast<int>(_slaveId));
+
+    pConnection->closeConnection();
+    QVERIFY(!pConnection->isConnected());
+}
+
+void TestNativeModbusConnection::udpReadRequestPipelined()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveUdp->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(5, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(10, true);
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 100);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(5, 105);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(10, 110);
+
+    /* Open connection */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openUdpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 1000);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    /* Send all requests without waiting for a response */
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+    pConnection->sendReadRequest(ModbusAddress(40006), 1, _slaveId);
+    pConnection->sendReadRequest(ModbusAddress(40011), 1, _slaveId);
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyResultSuccess.count(), 3, 500);
+    QCOMPARE(spyResultError.count(), 0);
+
+    /* Every response is matched with its request on transaction id */
+    QMap<QString, quint16> resultMap;
+    for (const QList<QVariant> &arguments : std::as_const(spyResultSuccess))
+    {
+        resultMap.insert(arguments[0].value<ModbusAddress>().fullAddress(), arguments[1].value<QList<quint16> >().first());
+    }
+
+    QCOMPARE(resultMap["40001"], static_cast<quint16>(100));
+    QCOMPARE(resultMap["40006"], static_cast<quint16>(105));
+    QCOMPARE(resultMap["40011"], static_cast<quint16>(110));
+}
+
+void TestNativeModbusConnection::udpReadRequestLost()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveUdp->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterValue(0, 100);
+
+    /* First request is lost */
+    _pTestSlaveUdp->setDropCount(1);
+
+    /* Open connection */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    pConnection->setRequestPolicy(false, 1);
+
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openUdpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 100);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyRequestReceived(_pTestSlaveUdp, &TestSlaveUdp::requestReceived);
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+
+    /* Loss is detected by the request timeout, the retry is answered */
+    QVERIFY(spyResultSuccess.wait(500));
+    QCOMPARE(spyRequestReceived.count(), 2);
+    QCOMPARE(spyResultError.count(), 0);
+
+    QList<QVariant> arguments = spyResultSuccess.takeFirst();
+    QCOMPARE(arguments[1].value<QList<quint16> >(), QList<quint16>({100}));
+
+    /* Connection stays open */
+    QVERIFY(pConnection->isConnected());
+}
+
+void TestNativeModbusConnection::udpReadRequestTimeout()
+{
+    /* Start server */
+    QVERIFY(_pTestSlaveUdp->connect(_serverConnectionData, _slaveId));
+
+    _testSlaveData[QModbusDataUnit::HoldingRegisters]->setRegisterState(0, true);
+    _pTestSlaveUdp->setDropCount(1);
+
+    /* Open connection, without retries */
+    NativeModbusConnection * pConnection = new NativeModbusConnection(this);
+    pConnection->setRequestPolicy(false, 0);
+
+    QSignalSpy spySuccess(pConnection, &ModbusConnection::connectionSuccess);
+    pConnection->openUdpConnection(constructTcpSettings(_serverConnectionData.host(), _serverConnectionData.port()), 100);
+
+    QVERIFY(spySuccess.wait(100));
+
+    QSignalSpy spyResultSuccess(pConnection, &ModbusConnection::readRequestSuccess);
+    QSignalSpy spyResultError(pConnection, &ModbusConnection::readRequestError);
+
+    pConnection->sendReadRequest(ModbusAddress(40001), 1, _slaveId);
+
+    QVERIFY(spyResultError.wait(500));
+    QCOMPARE(spyResultSuccess.count(), 0);
+
+    QList<QVariant> arguments = spyResultError.takeFirst();
+    QCOMPARE(arguments[2].value<QModbusDevice::Error>(), QModbusDevice::TimeoutError);
+}
+
+ModbusConnection::TcpSettings TestNativeModbusConnection::constructTcpSettings(QString ip, qint32 port)
+{
+    struct ModbusConnection::TcpSettings tcpSettings =
+    {
+        .ip = ip,
+        .port = port,
+    };
+
+    return tcpSettings;
+}
+
+QTEST_GUILESS_MAIN(TestNativeModbusConnection)
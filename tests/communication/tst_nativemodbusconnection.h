@@ -0,0 +1,43 @@
+#include <QObject>
+#include <QPointer>
+#include <QUrl>
+
+#include "nativemodbusconnection.h"
+
+#include "testslavemodbus.h"
+#include "testslaveudp.h"
+
+class TestNativeModbusConnection: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void connectionSuccess();
+    void connectionFail();
+    void lingerConnectionReuse();
+
+    void readRequestSuccess();
+    void readRequestProtocolError();
+    void readRequestPipelined();
+    void readRequestCoils();
+    void abortPendingRequests();
+
+    void udpReadRequestSuccess();
+    void udpReadRequestPipelined();
+    void udpReadRequestLost();
+    void udpReadRequestTimeout();
+
+private:
+
+    ModbusConnection::TcpSettings constructTcpSettings(QString ip, qint32 port);
+
+    TestSlaveModbus::ModbusDataMap _testSlaveData;
+    QPointer<TestSlaveModbus> _pTestSlaveModbus;
+    QPointer<TestSlaveUdp> _pTestSlaveUdp;
+
+    quint8 _slaveId;
+
+    QUrl _serverConnectionData;
+};
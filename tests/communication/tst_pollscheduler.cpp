@@ -0,0 +1,125 @@
+
+#include <QtTest/QtTest>
+
+#include "tst_pollscheduler.h"
+
+#include "pollscheduler.h"
+
+/* Times in ns */
+static const qint64 cMs = 1000000;
+
+void TestPollScheduler::init()
+{
+
+}
+
+void TestPollScheduler::cleanup()
+{
+
+}
+
+void TestPollScheduler::allGroupsDueAtStart()
+{
+    PollScheduler scheduler;
+    scheduler.reset(QList<qint64>() << 10 * cMs << 100 * cMs, 0x03, 0);
+
+    QCOMPARE(scheduler.nextDeadline(), static_cast<qint64>(0));
+    QCOMPARE(scheduler.takeDueGroups(0), static_cast<quint64>(0x03));
+
+    QCOMPARE(scheduler.nextDeadline(), 10 * cMs);
+    QCOMPARE(scheduler.takeDueGroups(5 * cMs), static_cast<quint64>(0));
+    QCOMPARE(scheduler.takeDueGroups(10 * cMs), static_cast<quint64>(0x01));
+}
+
+void TestPollScheduler::noDrift()
+{
+    PollScheduler scheduler;
+    scheduler.reset(QList<qint64>() << 10 * cMs, 0x01, 0);
+
+    QCOMPARE(scheduler.takeDueGroups(0), static_cast<quint64>(0x01));
+
+    /* Late poll doesn't shift the following deadlines */
+    QCOMPARE(scheduler.takeDueGroups(13 * cMs), static_cast<quint64>(0x01));
+    QCOMPARE(scheduler.nextDeadline(), 20 * cMs);
+
+    QCOMPARE(scheduler.takeDueGroups(20 * cMs), static_cast<quint64>(0x01));
+    QCOMPARE(scheduler.nextDeadline(), 30 * cMs);
+
+    QCOMPARE(scheduler.missedDeadlines(), static_cast<quint32>(0));
+    QCOMPARE(scheduler.pollCount(), static_cast<quint32>(3));
+}
+
+void TestPollScheduler::onlyScheduledGroups()
+{
+    PollScheduler scheduler;
+    scheduler.reset(QList<qint64>() << 10 * cMs << 100 * cMs, 0x02, 0);
+
+    QCOMPARE(scheduler.takeDueGroups(0), static_cast<quint64>(0x02));
+    QCOMPARE(scheduler.nextDeadline(), 100 * cMs);
+    QCOMPARE(scheduler.takeDueGroups(50 * cMs), static_cast<quint64>(0));
+
+    PollScheduler emptyScheduler;
+    emptyScheduler.reset(QList<qint64>() << 10 * cMs, 0, 0);
+
+    QCOMPARE(emptyScheduler.nextDeadline(), PollScheduler::cNoDeadline);
+    QCOMPARE(emptyScheduler.takeDueGroups(0), static_cast<quint64>(0));
+}
+
+void TestPollScheduler::overrunSkip()
+{
+    PollScheduler scheduler;
+    scheduler.setOverrunPolicy(PollScheduler::OverrunPolicy::SKIP);
+    scheduler.reset(QList<qint64>() << 10 * cMs, 0x01, 0);
+
+    QCOMPARE(scheduler.takeDueGroups(0), static_cast<quint64>(0x01));
+
+    /* Deadlines at 10, 20 and 30 ms are passed: 2 are missed */
+    QCOMPARE(scheduler.takeDueGroups(35 * cMs), static_cast<quint64>(0x01));
+    QCOMPARE(scheduler.missedDeadlines(), static_cast<quint32>(2));
+
+    /* Next poll is in the future */
+    QCOMPARE(scheduler.nextDeadline(), 40 * cMs);
+    QCOMPARE(scheduler.takeDueGroups(36 * cMs), static_cast<quint64>(0));
+}
+
+void TestPollScheduler::overrunCatchUp()
+{
+    PollScheduler scheduler;
+    scheduler.setOverrunPolicy(PollScheduler::OverrunPolicy::CATCH_UP);
+    scheduler.reset(QList<qint64>() << 10 * cMs, 0x01, 0);
+
+    QCOMPARE(scheduler.takeDueGroups(0), static_cast<quint64>(0x01));
+
+    /* Poll of 10 ms is late */
+    QCOMPARE(scheduler.takeDueGroups(35 * cMs), static_cast<quint64>(0x01));
+    QCOMPARE(scheduler.missedDeadlines(), static_cast<quint32>(1));
+
+    /* Missed polls are done immediately, poll of 20 ms is late, poll of 30 ms is in time */
+    QCOMPARE(scheduler.nextDeadline(), 20 * cMs);
+    QCOMPARE(scheduler.takeDueGroups(36 * cMs), static_cast<quint64>(0x01));
+    QCOMPARE(scheduler.takeDueGroups(37 * cMs), static_cast<quint64>(0x01));
+    QCOMPARE(scheduler.nextDeadline(), 40 * cMs);
+    QCOMPARE(scheduler.missedDeadlines(), static_cast<quint32>(2));
+    QCOMPARE(scheduler.takeDueGroups(38 * cMs), static_cast<quint64>(0));
+}
+
+void TestPollScheduler::achievedPeriod()
+{
+    PollScheduler scheduler;
+    scheduler.reset(QList<qint64>() << 100 * cMs << 10 * cMs, 0x03, 0);
+
+    QCOMPARE(scheduler.achievedPeriod(), static_cast<qint64>(0));
+
+    /* Period is based on fastest group */
+    scheduler.takeDueGroups(0);
+    scheduler.takeDueGroups(12 * cMs);
+    scheduler.takeDueGroups(24 * cMs);
+
+    QCOMPARE(scheduler.achievedPeriod(), 12 * cMs);
+
+    scheduler.resetStatistics();
+    QCOMPARE(scheduler.achievedPeriod(), static_cast<qint64>(0));
+    QCOMPARE(scheduler.pollCount(), static_cast<quint32>(0));
+}
+
+QTEST_GUILESS_MAIN(TestPollScheduler)
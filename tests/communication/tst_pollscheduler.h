@@ -0,0 +1,20 @@
+
+#include <QObject>
+
+class TestPollScheduler: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void allGroupsDueAtStart();
+    void noDrift();
+    void onlyScheduledGroups();
+    void overrunSkip();
+    void overrunCatchUp();
+    void achievedPeriod();
+
+private:
+
+};
@@ -0,0 +1,60 @@
+
+#include <QtTest/QtTest>
+
+#include "tst_readcostmodel.h"
+
+#include "readcostmodel.h"
+
+void TestReadCostModel::init()
+{
+
+}
+
+void TestReadCostModel::cleanup()
+{
+
+}
+
+void TestReadCostModel::noBridging()
+{
+    ReadCostModel costModel;
+
+    QCOMPARE(costModel.maxBridgedGap(), 0);
+}
+
+void TestReadCostModel::tcp()
+{
+    auto costModel = ReadCostModel::tcp(20000);
+
+    /* Round trip time dominates */
+    QVERIFY(costModel.requestOverhead() >= 20000);
+
+    /* Bridging is always cheaper than an extra request within the Modbus limits */
+    QVERIFY(costModel.maxBridgedGap() > 125);
+}
+
+void TestReadCostModel::serialLowBaudrate()
+{
+    auto costModel = ReadCostModel::serial(QSerialPort::Baud9600, QSerialPort::NoParity, QSerialPort::Data8, QSerialPort::OneStop);
+
+    /* 13 frame characters and 2 x 3.5 character silent interval, 2 characters per register */
+    QCOMPARE(costModel.maxBridgedGap(), 10);
+}
+
+void TestReadCostModel::serialHighBaudrate()
+{
+    auto costModel = ReadCostModel::serial(QSerialPort::Baud115200, QSerialPort::NoParity, QSerialPort::Data8, QSerialPort::OneStop);
+
+    /* Fixed silent interval of 1750 µs makes extra requests relatively more expensive */
+    QCOMPARE(costModel.maxBridgedGap(), 26);
+}
+
+void TestReadCostModel::serialParityStopBits()
+{
+    auto costModelNoParity = ReadCostModel::serial(QSerialPort::Baud115200, QSerialPort::NoParity, QSerialPort::Data8, QSerialPort::OneStop);
+    auto costModelParity = ReadCostModel::serial(QSerialPort::Baud115200, QSerialPort::EvenParity, QSerialPort::Data8, QSerialPort::TwoStop);
+
+    QVERIFY(costModelParity.registerCost() > costModelNoParity.registerCost());
+}
+
+QTEST_GUILESS_MAIN(TestReadCostModel)
@@ -0,0 +1,19 @@
+
+#include <QObject>
+
+class TestReadCostModel: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void noBridging();
+    void tcp();
+    void serialLowBaudrate();
+    void serialHighBaudrate();
+    void serialParityStopBits();
+
+private:
+
+};
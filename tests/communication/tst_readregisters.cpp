@@ -4,6 +4,7 @@
 #include "tst_readregisters.h"
 
 #include "readregisters.h"
+#include "communicationhelpers.h"
 
 using ObjectType = ModbusAddress::ObjectType;
 
@@ -25,17 +26,18 @@ void TestReadRegisters::verifyAndAddErrorResult(ReadRegisters& readRegister, Mod
     QCOMPARE(object.address(), addr);
     QCOMPARE(object.count(), cnt);
 
-    readRegister.addError();
+    readRegister.takeNext();
+    readRegister.addError(addr);
 }
 
 void TestReadRegisters::resetRead_1()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 255);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 1);
 
     QVERIFY(!readRegister.hasNext());
 }
@@ -43,11 +45,11 @@ void TestReadRegisters::resetRead_1()
 void TestReadRegisters::resetRead_2()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(2) << ModbusAddress(3);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(3, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 255);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 4);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 4);
 
     QVERIFY(!readRegister.hasNext());
 }
@@ -55,14 +57,14 @@ void TestReadRegisters::resetRead_2()
 void TestReadRegisters::resetReadSplit_1()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(3) << ModbusAddress(5) << ModbusAddress(6) << ModbusAddress(8);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(3, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER) << ModbusAddress(6, ObjectType::HOLDING_REGISTER) << ModbusAddress(8, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 255);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 2);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(3), 1);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(5), 2);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(8), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(3, ObjectType::HOLDING_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(5, ObjectType::HOLDING_REGISTER), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(8, ObjectType::HOLDING_REGISTER), 1);
 
     QVERIFY(!readRegister.hasNext());
 }
@@ -70,12 +72,12 @@ void TestReadRegisters::resetReadSplit_1()
 void TestReadRegisters::resetReadSplit_2()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(3);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(3, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 255);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 1);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(3), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(3, ObjectType::HOLDING_REGISTER), 1);
 
     QVERIFY(!readRegister.hasNext());
 }
@@ -121,12 +123,12 @@ void TestReadRegisters::resetReadDifferentObjectTypes_2()
 void TestReadRegisters::consecutive_1()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(2) << ModbusAddress(3) << ModbusAddress(4) << ModbusAddress(5);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(3, ObjectType::HOLDING_REGISTER) << ModbusAddress(4, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 3);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 3);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(3), 3);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 3);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(3, ObjectType::HOLDING_REGISTER), 3);
 
     QVERIFY(!readRegister.hasNext());
 }
@@ -134,11 +136,11 @@ void TestReadRegisters::consecutive_1()
 void TestReadRegisters::consecutive_2()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 5);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 2);
 
     QVERIFY(!readRegister.hasNext());
 }
@@ -146,72 +148,77 @@ void TestReadRegisters::consecutive_2()
 void TestReadRegisters::consecutive_3()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(2);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 2);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 2);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(2), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(2, ObjectType::HOLDING_REGISTER), 1);
 
     QVERIFY(!readRegister.hasNext());
 }
 
-void TestReadRegisters::splitNextToSingleReads_1()
+void TestReadRegisters::splitInHalf_1()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 2);
 
-    QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(0));
-    QCOMPARE(readRegister.next().count(), 1);
+    QCOMPARE(readRegister.next().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 1);
 
-    readRegister.splitNextToSingleReads();
+    /* Single register is read again as is */
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.inFlightCount(), 0);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 1);
 
     QVERIFY(!readRegister.hasNext());
 }
 
-void TestReadRegisters::splitNextToSingleReads_2()
+void TestReadRegisters::splitInHalf_2()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(2);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 100);
 
-    QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(0));
-    QCOMPARE(readRegister.next().count(), 3);
+    QCOMPARE(readRegister.next().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 3);
 
-    readRegister.splitNextToSingleReads();
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 1);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(1), 1);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(2), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 1);
+
+    /* Failing half is split again */
+    QCOMPARE(readRegister.next().address(), ModbusAddress(1, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 2);
+    readRegister.splitInHalf(ModbusAddress(1, ObjectType::HOLDING_REGISTER));
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(1, ObjectType::HOLDING_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(2, ObjectType::HOLDING_REGISTER), 1);
 
     QVERIFY(!readRegister.hasNext());
 }
 
-void TestReadRegisters::splitNextToSingleReads_3()
+void TestReadRegisters::splitInHalf_3()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(2) << ModbusAddress(5) << ModbusAddress(6);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER) << ModbusAddress(6, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 100);
 
-    QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(0));
-    QCOMPARE(readRegister.next().count(), 3);
+    QCOMPARE(readRegister.next().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 3);
 
-    readRegister.splitNextToSingleReads();
+    /* Halves are added in front of the remaining items */
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(0), 1);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(1), 1);
-    verifyAndAddErrorResult(readRegister, ModbusAddress(2), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(1, ObjectType::HOLDING_REGISTER), 2);
 
-    verifyAndAddErrorResult(readRegister, ModbusAddress(5), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(5, ObjectType::HOLDING_REGISTER), 2);
 
     QVERIFY(!readRegister.hasNext());
 }
@@ -219,7 +226,7 @@ void TestReadRegisters::splitNextToSingleReads_3()
 void TestReadRegisters::addAllErrors()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(2) << ModbusAddress(5) << ModbusAddress(6) << ModbusAddress(7);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER) << ModbusAddress(6, ObjectType::HOLDING_REGISTER) << ModbusAddress(7, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 100);
 
@@ -241,27 +248,27 @@ void TestReadRegisters::addAllErrors()
 void TestReadRegisters::addSuccess()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(2) << ModbusAddress(5) << ModbusAddress(6) << ModbusAddress(8);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER) << ModbusAddress(6, ObjectType::HOLDING_REGISTER) << ModbusAddress(8, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 100);
 
     QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(0));
+    QCOMPARE(readRegister.next().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
     QCOMPARE(readRegister.next().count(), 3);
 
-    readRegister.addSuccess(ModbusAddress(0), QList<quint16>() << 1000 << 1001 << 1002);
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1000 << 1001 << 1002);
 
     QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(5));
+    QCOMPARE(readRegister.next().address(), ModbusAddress(5, ObjectType::HOLDING_REGISTER));
     QCOMPARE(readRegister.next().count(), 2);
 
-    readRegister.addSuccess(ModbusAddress(5), QList<quint16>() << 1005 << 1006);
+    readRegister.addSuccess(ModbusAddress(5, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1005 << 1006);
 
     QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(8));
+    QCOMPARE(readRegister.next().address(), ModbusAddress(8, ObjectType::HOLDING_REGISTER));
     QCOMPARE(readRegister.next().count(), 1);
 
-    readRegister.addSuccess(ModbusAddress(8), QList<quint16>() << 1008);
+    readRegister.addSuccess(ModbusAddress(8, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1008);
 
     QVERIFY(!readRegister.hasNext());
 
@@ -279,46 +286,669 @@ void TestReadRegisters::addSuccess()
 void TestReadRegisters::addSuccessAndErrors()
 {
     ReadRegisters readRegister;
-    auto registerList = QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(1) << ModbusAddress(5) << ModbusAddress(8);
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER) << ModbusAddress(8, ObjectType::HOLDING_REGISTER);
 
     readRegister.resetRead(registerList, 100);
 
     QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(0));
+    QCOMPARE(readRegister.next().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
     QCOMPARE(readRegister.next().count(), 2);
 
-    readRegister.addSuccess(ModbusAddress(0), QList<quint16>() << 1000 << 1001);
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1000 << 1001);
 
     QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(5));
-    QCOMPARE(readRegister.next().count(), 1);
+    QCOMPARE(readRegister.next().address(), ModbusAddress(5, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 1);
 
-    readRegister.addError();
+    readRegister.addError(ModbusAddress(5, ObjectType::HOLDING_REGISTER));
 
     QVERIFY(readRegister.hasNext());
-    QCOMPARE(readRegister.next().address(), ModbusAddress(8));
+    QCOMPARE(readRegister.next().address(), ModbusAddress(8, ObjectType::HOLDING_REGISTER));
     QCOMPARE(readRegister.next().count(), 1);
 
-    readRegister.addSuccess(ModbusAddress(8), QList<quint16>() << 1008);
+    readRegister.addSuccess(ModbusAddress(8, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1008);
+
+    QVERIFY(!readRegister.hasNext());
+
+    auto resultMap = readRegister.resultMap();
+
+    QCOMPARE(resultMap.size(), registerList.size());
+
+
+    QCOMPARE(resultMap.value(ModbusAddress(0, ObjectType::HOLDING_REGISTER)).value(), 1000);
+    QVERIFY(resultMap.value(ModbusAddress(0, ObjectType::HOLDING_REGISTER)).isValid());
+
+    QCOMPARE(resultMap.value(ModbusAddress(1, ObjectType::HOLDING_REGISTER)).value(), 1001);
+    QVERIFY(resultMap.value(ModbusAddress(1, ObjectType::HOLDING_REGISTER)).isValid());
+
+    QCOMPARE(resultMap.value(ModbusAddress(5, ObjectType::HOLDING_REGISTER)).value(), 0);
+    QVERIFY(!resultMap.value(ModbusAddress(5, ObjectType::HOLDING_REGISTER)).isValid());
+
+    QCOMPARE(resultMap.value(ModbusAddress(8, ObjectType::HOLDING_REGISTER)).value(), 1008);
+    QVERIFY(resultMap.value(ModbusAddress(8, ObjectType::HOLDING_REGISTER)).isValid());
+}
+
+void TestReadRegisters::inFlightOutOfOrder()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER) << ModbusAddress(8, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 100);
+
+    QCOMPARE(readRegister.takeNext().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().address(), ModbusAddress(5, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().address(), ModbusAddress(8, ObjectType::HOLDING_REGISTER));
+
+    QVERIFY(!readRegister.hasNext());
+    QCOMPARE(readRegister.inFlightCount(), 3);
+
+    readRegister.addSuccess(ModbusAddress(8, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1008);
+    readRegister.addError(ModbusAddress(5, ObjectType::HOLDING_REGISTER));
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1000 << 1001);
+
+    QCOMPARE(readRegister.inFlightCount(), 0);
+
+    auto resultMap = readRegister.resultMap();
+
+    QCOMPARE(resultMap.size(), registerList.size());
+
+    QCOMPARE(resultMap.value(ModbusAddress(0, ObjectType::HOLDING_REGISTER)).value(), 1000);
+    QVERIFY(resultMap.value(ModbusAddress(0, ObjectType::HOLDING_REGISTER)).isValid());
+
+    QCOMPARE(resultMap.value(ModbusAddress(1, ObjectType::HOLDING_REGISTER)).value(), 1001);
+    QVERIFY(resultMap.value(ModbusAddress(1, ObjectType::HOLDING_REGISTER)).isValid());
+
+    QVERIFY(!resultMap.value(ModbusAddress(5, ObjectType::HOLDING_REGISTER)).isValid());
+
+    QCOMPARE(resultMap.value(ModbusAddress(8, ObjectType::HOLDING_REGISTER)).value(), 1008);
+    QVERIFY(resultMap.value(ModbusAddress(8, ObjectType::HOLDING_REGISTER)).isValid());
+}
+
+void TestReadRegisters::inFlightShortData()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 100);
+
+    QCOMPARE(readRegister.takeNext().count(), 2);
+    QCOMPARE(readRegister.takeNext().count(), 1);
+    QCOMPARE(readRegister.inFlightCount(), 2);
+
+    /* Reply with less data than requested finishes the item with errors */
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1000);
+    QCOMPARE(readRegister.inFlightCount(), 1);
+
+    readRegister.addSuccess(ModbusAddress(5, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1005);
+    QCOMPARE(readRegister.inFlightCount(), 0);
+
+    auto resultMap = readRegister.resultMap();
+
+    QCOMPARE(resultMap.size(), registerList.size());
+
+    QVERIFY(!resultMap.value(ModbusAddress(0, ObjectType::HOLDING_REGISTER)).isValid());
+    QVERIFY(!resultMap.value(ModbusAddress(1, ObjectType::HOLDING_REGISTER)).isValid());
+
+    QCOMPARE(resultMap.value(ModbusAddress(5, ObjectType::HOLDING_REGISTER)).value(), 1005);
+    QVERIFY(resultMap.value(ModbusAddress(5, ObjectType::HOLDING_REGISTER)).isValid());
+}
+
+void TestReadRegisters::inFlightSplitInHalf()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(5, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 100);
+
+    QCOMPARE(readRegister.takeNext().count(), 3);
+    QCOMPARE(readRegister.takeNext().count(), 1);
+
+    QCOMPARE(readRegister.inFlightItem(ModbusAddress(0, ObjectType::HOLDING_REGISTER)).count(), 3);
+    QCOMPARE(readRegister.inFlightItem(ModbusAddress(1, ObjectType::HOLDING_REGISTER)).count(), 0);
+
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+
+    QCOMPARE(readRegister.inFlightCount(), 1);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(1, ObjectType::HOLDING_REGISTER), 2);
+
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::isolateUnreadable()
+{
+    ReadRegisters readRegister;
+    QList<ModbusAddress> registerList;
+    for (quint32 idx = 0; idx < 8; idx++)
+    {
+        registerList.append(ModbusAddress(idx, ObjectType::HOLDING_REGISTER));
+    }
+
+    readRegister.resetRead(registerList, 100);
+
+    /* Register 5 is unreadable */
+    QCOMPARE(readRegister.takeNext().count(), 8);
+    readRegister.markUnreadable(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+
+    QCOMPARE(readRegister.next().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 4);
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 0 << 1 << 2 << 3);
+
+    QCOMPARE(readRegister.next().address(), ModbusAddress(4, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 4);
+    readRegister.markUnreadable(ModbusAddress(4, ObjectType::HOLDING_REGISTER));
+    readRegister.splitInHalf(ModbusAddress(4, ObjectType::HOLDING_REGISTER));
+
+    QCOMPARE(readRegister.next().address(), ModbusAddress(4, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 2);
+    readRegister.markUnreadable(ModbusAddress(4, ObjectType::HOLDING_REGISTER));
+    readRegister.splitInHalf(ModbusAddress(4, ObjectType::HOLDING_REGISTER));
+
+    QCOMPARE(readRegister.next().address(), ModbusAddress(4, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 1);
+    readRegister.addSuccess(ModbusAddress(4, ObjectType::HOLDING_REGISTER), QList<quint16>() << 4);
+
+    QCOMPARE(readRegister.next().address(), ModbusAddress(5, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 1);
+    readRegister.markUnreadable(ModbusAddress(5, ObjectType::HOLDING_REGISTER));
+    readRegister.addError(ModbusAddress(5, ObjectType::HOLDING_REGISTER));
+
+    QCOMPARE(readRegister.next().address(), ModbusAddress(6, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().count(), 2);
+    readRegister.addSuccess(ModbusAddress(6, ObjectType::HOLDING_REGISTER), QList<quint16>() << 6 << 7);
+
+    QVERIFY(!readRegister.hasNext());
+    QCOMPARE(readRegister.inFlightCount(), 0);
+
+    auto resultMap = readRegister.resultMap();
+    QCOMPARE(resultMap.size(), registerList.size());
+    QVERIFY(!resultMap.value(ModbusAddress(5, ObjectType::HOLDING_REGISTER)).isValid());
+    QCOMPARE(resultMap.value(ModbusAddress(7, ObjectType::HOLDING_REGISTER)).value(), 7);
+
+    /* Only smallest range is remembered */
+    QCOMPARE(readRegister.deviceProfile().unreadableList().size(), 1);
+    QCOMPARE(readRegister.deviceProfile().unreadableList().first().address(), ModbusAddress(5, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.deviceProfile().unreadableList().first().count(), 1);
+
+    /* Next read is built around unreadable register */
+    readRegister.resetRead(registerList, 100);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 5);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(5, ObjectType::HOLDING_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(6, ObjectType::HOLDING_REGISTER), 2);
+
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::unreadableBecomesReadable()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 100);
+
+    QCOMPARE(readRegister.takeNext().count(), 3);
+    readRegister.markUnreadable(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+
+    QCOMPARE(readRegister.takeNext().count(), 1);
+    readRegister.markUnreadable(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    readRegister.addError(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+
+    QCOMPARE(readRegister.takeNext().count(), 2);
+    readRegister.addSuccess(ModbusAddress(1, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1 << 2);
+
+    readRegister.resetRead(registerList, 100);
+
+    QCOMPARE(readRegister.takeNext().count(), 1);
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 0);
+
+    QCOMPARE(readRegister.deviceProfile().unreadableList().size(), 0);
+
+    /* Full block is read again */
+    readRegister.resetRead(registerList, 100);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 3);
 
     QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::inFlightAddAllErrors()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(4, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 100);
+
+    readRegister.takeNext();
+    readRegister.addAllErrors();
+
+    QVERIFY(!readRegister.hasNext());
+    QCOMPARE(readRegister.inFlightCount(), 0);
+
+    auto resultMap = readRegister.resultMap();
+    QCOMPARE(resultMap.size(), registerList.size());
+
+    /* Late response is ignored */
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1000);
+    QVERIFY(!readRegister.resultMap().value(ModbusAddress(0, ObjectType::HOLDING_REGISTER)).isValid());
+}
+
+void TestReadRegisters::bridgeGap_1()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(100, ObjectType::HOLDING_REGISTER) << ModbusAddress(102, ObjectType::HOLDING_REGISTER) << ModbusAddress(105, ObjectType::HOLDING_REGISTER) << ModbusAddress(107, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 125, 2);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(100, ObjectType::HOLDING_REGISTER), 8);
+
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::bridgeGap_2()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(100, ObjectType::HOLDING_REGISTER) << ModbusAddress(102, ObjectType::HOLDING_REGISTER) << ModbusAddress(110, ObjectType::HOLDING_REGISTER) << ModbusAddress(111, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 125, 2);
+
+    /* Gap of 7 registers is too large */
+    verifyAndAddErrorResult(readRegister, ModbusAddress(100, ObjectType::HOLDING_REGISTER), 3);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(110, ObjectType::HOLDING_REGISTER), 2);
+
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::bridgeGapConsecutiveMax()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(4, ObjectType::HOLDING_REGISTER) << ModbusAddress(6, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 4, 10);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 3);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(4, ObjectType::HOLDING_REGISTER), 3);
+
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::bridgeGapDifferentObjectTypes()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::INPUT_REGISTER)
+                                               << ModbusAddress(0, ObjectType::HOLDING_REGISTER)
+                                               << ModbusAddress(2, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 125, 10);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::INPUT_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 3);
+
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::bridgeGapDropUnused()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(3, ObjectType::HOLDING_REGISTER) << ModbusAddress(10, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 125, 2);
+
+    QCOMPARE(readRegister.next().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.next().count(), 4);
+
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1000 << 1001 << 1002 << 1003);
+
+    QCOMPARE(readRegister.takeNext().address(), ModbusAddress(10, ObjectType::HOLDING_REGISTER));
+    readRegister.addError(ModbusAddress(10, ObjectType::HOLDING_REGISTER));
 
     auto resultMap = readRegister.resultMap();
 
     QCOMPARE(resultMap.size(), registerList.size());
+    QCOMPARE(resultMap.value(ModbusAddress(0, ObjectType::HOLDING_REGISTER)).value(), 1000);
+    QCOMPARE(resultMap.value(ModbusAddress(3, ObjectType::HOLDING_REGISTER)).value(), 1003);
+    QVERIFY(!resultMap.value(ModbusAddress(10, ObjectType::HOLDING_REGISTER)).isValid());
+}
+
+void TestReadRegisters::bridgeGapSplitInHalf()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(3, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 125, 2);
+
+    QCOMPARE(readRegister.takeNext().count(), 4);
+
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+
+    /* Only requested registers are read */
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(3, ObjectType::HOLDING_REGISTER), 1);
+
+    QVERIFY(!readRegister.hasNext());
+    QCOMPARE(readRegister.resultMap().size(), registerList.size());
+}
+
+void TestReadRegisters::learnMaxBlockSize()
+{
+    ReadRegisters readRegister;
+    QList<ModbusAddress> registerList;
+    for (quint32 idx = 0; idx < 8; idx++)
+    {
+        registerList.append(ModbusAddress(idx, ObjectType::HOLDING_REGISTER));
+    }
+
+    readRegister.resetRead(registerList, 100);
+
+    /* Device refuses block of 8 registers, but all registers are readable */
+    QCOMPARE(readRegister.takeNext().count(), 8);
+    readRegister.markUnreadable(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+
+    QCOMPARE(readRegister.takeNext().count(), 4);
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 0 << 1 << 2 << 3);
+
+    QCOMPARE(readRegister.takeNext().count(), 4);
+    readRegister.addSuccess(ModbusAddress(4, ObjectType::HOLDING_REGISTER), QList<quint16>() << 4 << 5 << 6 << 7);
+
+    readRegister.learnReadLimits();
+
+    QCOMPARE(readRegister.deviceProfile().maxBlockSize(), 4);
+    QCOMPARE(readRegister.deviceProfile().unreadableList().size(), 0);
+
+    /* Next read respects learned block size */
+    readRegister.resetRead(registerList, 100);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 4);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(4, ObjectType::HOLDING_REGISTER), 4);
+
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::unsupportedObjectType()
+{
+    using ObjectType = ModbusAddress::ObjectType;
+
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER)
+                                               << ModbusAddress(1, ObjectType::HOLDING_REGISTER)
+                                               << ModbusAddress(0, ObjectType::INPUT_REGISTER)
+                                               << ModbusAddress(1, ObjectType::INPUT_REGISTER)
+                                               << ModbusAddress(5, ObjectType::INPUT_REGISTER);
+
+    readRegister.resetRead(registerList, 2);
+
+    QCOMPARE(readRegister.takeNext().address(), ModbusAddress(0, ObjectType::HOLDING_REGISTER));
+    QCOMPARE(readRegister.takeNext().address(), ModbusAddress(0, ObjectType::INPUT_REGISTER));
+
+    /* Device doesn't support input registers */
+    readRegister.markUnsupported(ModbusAddress(0, ObjectType::INPUT_REGISTER));
+
+    QVERIFY(!readRegister.hasNext());
+    QCOMPARE(readRegister.inFlightCount(), 1);
+    QVERIFY(!readRegister.deviceProfile().isSupported(ObjectType::INPUT_REGISTER));
+
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 0 << 1);
+
+    auto resultMap = readRegister.resultMap();
+    QCOMPARE(resultMap.size(), registerList.size());
+    QVERIFY(!resultMap.value(ModbusAddress(5, ObjectType::INPUT_REGISTER)).isValid());
+
+    /* Next read only probes first input register */
+    readRegister.resetRead(registerList, 2);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::INPUT_REGISTER), 1);
+
+    QVERIFY(!readRegister.hasNext());
+    QCOMPARE(readRegister.resultMap().size(), registerList.size());
+
+    /* Support returns */
+    readRegister.resetRead(registerList, 2);
+    readRegister.takeNext();
+    readRegister.takeNext();
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::INPUT_REGISTER), QList<quint16>() << 0);
+
+    QVERIFY(readRegister.deviceProfile().isSupported(ObjectType::INPUT_REGISTER));
+}
+
+void TestReadRegisters::cachedPlan()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER) << ModbusAddress(2, ObjectType::HOLDING_REGISTER) << ModbusAddress(3, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 100);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 4);
+    QVERIFY(!readRegister.hasNext());
+
+    /* Reused plan restarts from first item */
+    readRegister.resetRead(registerList, 100);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 4);
+    QVERIFY(!readRegister.hasNext());
+
+    /* Plan is rebuilt when settings change */
+    readRegister.resetRead(registerList, 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(2, ObjectType::HOLDING_REGISTER), 2);
+    QVERIFY(!readRegister.hasNext());
+
+    /* Plan is rebuilt when register list changes */
+    readRegister.resetRead(QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 2);
+    QVERIFY(!readRegister.hasNext());
+
+    /* Plan is rebuilt when device profile changes */
+    DeviceProfile deviceProfile;
+    deviceProfile.limitBlockSize(1);
+    readRegister.setDeviceProfile(deviceProfile);
+
+    readRegister.resetRead(QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER), 2);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 1);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(1, ObjectType::HOLDING_REGISTER), 1);
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::reuseResultFrame()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::HOLDING_REGISTER) << ModbusAddress(1, ObjectType::HOLDING_REGISTER);
+
+    readRegister.resetRead(registerList, 100);
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 1000 << 1001);
+    QVERIFY(!readRegister.hasNext());
+
+    const ModbusResultFrame firstFrame = readRegister.resultFrame();
+    QVERIFY(firstFrame.isValid(0));
+    QVERIFY(firstFrame.isValid(1));
+
+    /* Results of the previous read don't leak into the next read */
+    readRegister.resetRead(registerList, 100);
+
+    ModbusResultFrame resultFrame = readRegister.resultFrame();
+    QCOMPARE(resultFrame.addressList(), registerList);
+    QVERIFY(!resultFrame.isValid(0));
+    QVERIFY(!resultFrame.isValid(1));
+
+    /* Copy of the previous read is unaffected */
+    QCOMPARE(firstFrame.value(0), static_cast<quint16>(1000));
+    QCOMPARE(firstFrame.value(1), static_cast<quint16>(1001));
+
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::HOLDING_REGISTER), QList<quint16>() << 2000 << 2001);
+
+    resultFrame = readRegister.resultFrame();
+    QVERIFY(resultFrame.isValid(0));
+    QCOMPARE(resultFrame.value(1), static_cast<quint16>(2001));
+
+    /* Frame follows a changed register list */
+    readRegister.resetRead(QList<ModbusAddress>() << ModbusAddress(1, ObjectType::HOLDING_REGISTER), 100);
+    QCOMPARE(readRegister.resultFrame().size(), 1);
+    QCOMPARE(readRegister.resultFrame().address(0), ModbusAddress(1, ObjectType::HOLDING_REGISTER));
+    QVERIFY(!readRegister.resultFrame().isValid(0));
+}
+
+void TestReadRegisters::registerMaxCount()
+{
+    ReadRegisters readRegister;
+    QList<ModbusAddress> registerList;
+    for (quint32 idx = 0; idx < 200; idx++)
+    {
+        registerList.append(ModbusAddress(idx, ObjectType::HOLDING_REGISTER));
+    }
+
+    /* Function code allows at most 125 registers, regardless of setting */
+    readRegister.resetRead(registerList, 255);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 125);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(125, ObjectType::HOLDING_REGISTER), 75);
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::bitBulkRead()
+{
+    ReadRegisters readRegister;
+    QList<ModbusAddress> registerList;
+    for (quint32 idx = 0; idx < 300; idx++)
+    {
+        registerList.append(ModbusAddress(idx, ObjectType::COIL));
+    }
+    for (quint32 idx = 0; idx < 10; idx++)
+    {
+        registerList.append(ModbusAddress(idx, ObjectType::HOLDING_REGISTER));
+    }
+
+    /* Register limit doesn't apply to bits */
+    readRegister.resetRead(registerList, 5);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::COIL), 300);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::HOLDING_REGISTER), 5);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(5, ObjectType::HOLDING_REGISTER), 5);
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::bitMaxCount()
+{
+    ReadRegisters readRegister;
+    QList<ModbusAddress> registerList;
+    for (quint32 idx = 0; idx < 2500; idx++)
+    {
+        registerList.append(ModbusAddress(idx, ObjectType::DISCRETE_INPUT));
+    }
+
+    readRegister.resetRead(registerList, 125);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::DISCRETE_INPUT), 2000);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(2000, ObjectType::DISCRETE_INPUT), 500);
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::bitBridgeGap()
+{
+    ReadRegisters readRegister;
+    auto registerList = QList<ModbusAddress>() << ModbusAddress(0, ObjectType::COIL)
+                                               << ModbusAddress(30, ObjectType::COIL)
+                                               << ModbusAddress(100, ObjectType::COIL);
+
+    /* Gap of 2 registers is a gap of 32 bits */
+    readRegister.resetRead(registerList, 125, 2);
+
+    verifyAndAddErrorResult(readRegister, ModbusAddress(0, ObjectType::COIL), 31);
+    verifyAndAddErrorResult(readRegister, ModbusAddress(100, ObjectType::COIL), 1);
+    QVERIFY(!readRegister.hasNext());
+}
+
+void TestReadRegisters::bitAddSuccessPacked()
+{
+    QList<quint16> bitList;
+    for (qint32 idx = 0; idx < 20; idx++)
+    {
+        bitList.append(idx % 3 == 0 ? 1 : 0);
+    }
+
+    const QList<quint16> packedList = CommunicationHelpers::packBits(bitList);
+    QCOMPARE(packedList.size(), 2);
+    QCOMPARE(packedList[0], static_cast<quint16>(0x9249));
+    QCOMPARE(packedList[1], static_cast<quint16>(0x0004));
+
+    ReadRegisters readRegister;
+    QList<ModbusAddress> registerList;
+    for (quint32 idx = 0; idx < 20; idx++)
+    {
+        registerList.append(ModbusAddress(idx, ObjectType::COIL));
+    }
+
+    readRegister.resetRead(registerList, 125);
+
+    QCOMPARE(readRegister.takeNext().count(), static_cast<quint16>(20));
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::COIL), packedList);
+
+    QCOMPARE(readRegister.inFlightCount(), 0);
+
+    const ModbusResultFrame resultFrame = readRegister.resultFrame();
+    for (qint32 idx = 0; idx < 20; idx++)
+    {
+        const qint32 slot = resultFrame.slot(ModbusAddress(static_cast<quint32>(idx), ObjectType::COIL));
+        QVERIFY(resultFrame.isValid(slot));
+        QCOMPARE(resultFrame.value(slot), bitList[idx]);
+    }
+}
+
+void TestReadRegisters::bitAddSuccessUnpacked()
+{
+    QList<quint16> bitList;
+    QList<ModbusAddress> registerList;
+    for (quint32 idx = 0; idx < 20; idx++)
+    {
+        bitList.append(idx % 3 == 0 ? 1 : 0);
+        registerList.append(ModbusAddress(idx, ObjectType::DISCRETE_INPUT));
+    }
+
+    ReadRegisters readRegister;
+    readRegister.resetRead(registerList, 125);
+
+    /* Value per bit, as passed by Qt's client */
+    QCOMPARE(readRegister.takeNext().count(), static_cast<quint16>(20));
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::DISCRETE_INPUT), bitList);
+
+    QCOMPARE(readRegister.inFlightCount(), 0);
+
+    const ModbusResultFrame resultFrame = readRegister.resultFrame();
+    for (qint32 idx = 0; idx < 20; idx++)
+    {
+        const qint32 slot = resultFrame.slot(ModbusAddress(static_cast<quint32>(idx), ObjectType::DISCRETE_INPUT));
+        QVERIFY(resultFrame.isValid(slot));
+        QCOMPARE(resultFrame.value(slot), bitList[idx]);
+    }
+}
+
+void TestReadRegisters::learnMaxBitBlockSize()
+{
+    ReadRegisters readRegister;
+    QList<ModbusAddress> registerList;
+    for (quint32 idx = 0; idx < 16; idx++)
+    {
+        registerList.append(ModbusAddress(idx, ObjectType::COIL));
+    }
 
+    readRegister.resetRead(registerList, 125);
 
-    QCOMPARE(resultMap.value(ModbusAddress(0)).value(), 1000);
-    QVERIFY(resultMap.value(ModbusAddress(0)).isValid());
+    /* Block is too large for the device */
+    QCOMPARE(readRegister.takeNext().count(), static_cast<quint16>(16));
+    readRegister.markUnreadable(ModbusAddress(0, ObjectType::COIL));
+    readRegister.splitInHalf(ModbusAddress(0, ObjectType::COIL));
 
-    QCOMPARE(resultMap.value(ModbusAddress(1)).value(), 1001);
-    QVERIFY(resultMap.value(ModbusAddress(1)).isValid());
+    readRegister.takeNext();
+    readRegister.addSuccess(ModbusAddress(0, ObjectType::COIL), QList<quint16>() << 0x00FF);
+    readRegister.takeNext();
+    readRegister.addSuccess(ModbusAddress(8, ObjectType::COIL), QList<quint16>() << 0x0000);
 
-    QCOMPARE(resultMap.value(ModbusAddress(5)).value(), 0);
-    QVERIFY(!resultMap.value(ModbusAddress(5)).isValid());
+    readRegister.learnReadLimits();
 
-    QCOMPARE(resultMap.value(ModbusAddress(8)).value(), 1008);
-    QVERIFY(resultMap.value(ModbusAddress(8)).isValid());
+    /* Only the limit of bits is learned */
+    QCOMPARE(readRegister.deviceProfile().maxBitBlockSize(), static_cast<quint16>(8));
+    QCOMPARE(readRegister.deviceProfile().maxBlockSize(), static_cast<quint16>(0));
 }
 
 QTEST_GUILESS_MAIN(TestReadRegisters)
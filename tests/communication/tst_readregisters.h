@@ -28,14 +28,43 @@ private slots:
     void consecutive_2();
     void consecutive_3();
 
-    void splitNextToSingleReads_1();
-    void splitNextToSingleReads_2();
-    void splitNextToSingleReads_3();
+    void splitInHalf_1();
+    void splitInHalf_2();
+    void splitInHalf_3();
 
     void addAllErrors();
     void addSuccess();
     void addSuccessAndErrors();
 
+    void inFlightOutOfOrder();
+    void inFlightShortData();
+    void inFlightSplitInHalf();
+    void inFlightAddAllErrors();
+
+    void bridgeGap_1();
+    void bridgeGap_2();
+    void bridgeGapConsecutiveMax();
+    void bridgeGapDifferentObjectTypes();
+    void bridgeGapDropUnused();
+    void bridgeGapSplitInHalf();
+
+    void isolateUnreadable();
+    void unreadableBecomesReadable();
+
+    void learnMaxBlockSize();
+    void unsupportedObjectType();
+
+    void cachedPlan();
+    void reuseResultFrame();
+
+    void registerMaxCount();
+    void bitBulkRead();
+    void bitMaxCount();
+    void bitBridgeGap();
+    void bitAddSuccessPacked();
+    void bitAddSuccessUnpacked();
+    void learnMaxBitBlockSize();
+
 private:
 
     void verifyAndAddErrorResult(ReadRegisters& readRegister, ModbusAddress addr, quint16 cnt);
@@ -0,0 +1,208 @@
+
+#include <QtTest/QtTest>
+
+#include "tst_registerdecoder.h"
+
+#include "registerdecoder.h"
+#include "modbusregister.h"
+
+using Type = ModbusDataType::Type;
+using State = ResultState::State;
+
+void TestRegisterDecoder::init()
+{
+
+}
+
+void TestRegisterDecoder::cleanup()
+{
+
+}
+
+void TestRegisterDecoder::decode_16()
+{
+    ModbusResultFrame resultFrame(QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002));
+    resultFrame.setValue(0, 65000);
+    resultFrame.setValue(1, static_cast<quint16>(-100));
+
+    RegisterDecoder decoder;
+    decoder.addRegister(0, Type::UNSIGNED_16, true, 0, ModbusResultFrame::cNoSlot);
+    decoder.addRegister(1, Type::SIGNED_16, true, 1, ModbusResultFrame::cNoSlot);
+    decoder.addRegister(2, Type::SIGNED_16, false, 0, ModbusResultFrame::cNoSlot);
+    QCOMPARE(decoder.registerCount(), 3);
+
+    ResultDoubleList resultList(3);
+    QList<double> valueBuffer;
+    decoder.decode(resultFrame, resultList, valueBuffer);
+
+    auto expResults = ResultDoubleList() << ResultDouble(65000, State::SUCCESS)
+                                         << ResultDouble(-100, State::SUCCESS)
+                                         << ResultDouble(-536, State::SUCCESS);
+    QCOMPARE(resultList, expResults);
+}
+
+void TestRegisterDecoder::decode_32()
+{
+    const quint32 value = 1000000;
+    const qint32 signedValue = -1000000;
+
+    ModbusResultFrame resultFrame(QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002)
+                                                         << ModbusAddress(40003) << ModbusAddress(40004));
+    resultFrame.setValue(0, static_cast<quint16>(value));
+    resultFrame.setValue(1, static_cast<quint16>(value >> 16));
+    resultFrame.setValue(2, static_cast<quint16>(signedValue));
+    resultFrame.setValue(3, static_cast<quint16>(static_cast<quint32>(signedValue) >> 16));
+
+    RegisterDecoder decoder;
+    decoder.addRegister(0, Type::UNSIGNED_32, true, 0, 1);
+    decoder.addRegister(1, Type::SIGNED_32, true, 2, 3);
+
+    ResultDoubleList resultList(2);
+    QList<double> valueBuffer;
+    decoder.decode(resultFrame, resultList, valueBuffer);
+
+    auto expResults = ResultDoubleList() << ResultDouble(value, State::SUCCESS)
+                                         << ResultDouble(signedValue, State::SUCCESS);
+    QCOMPARE(resultList, expResults);
+}
+
+void TestRegisterDecoder::decodeBigEndian_32()
+{
+    const quint32 value = 1000000;
+
+    ModbusResultFrame resultFrame(QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002));
+    resultFrame.setValue(0, static_cast<quint16>(value >> 16));
+    resultFrame.setValue(1, static_cast<quint16>(value));
+
+    /* Same registers in both word orders end up in separate groups */
+    RegisterDecoder decoder;
+    decoder.addRegister(0, Type::UNSIGNED_32, false, 0, 1);
+    decoder.addRegister(1, Type::UNSIGNED_32, true, 0, 1);
+
+    ResultDoubleList resultList(2);
+    QList<double> valueBuffer;
+    decoder.decode(resultFrame, resultList, valueBuffer);
+
+    auto expResults = ResultDoubleList() << ResultDouble(value, State::SUCCESS)
+                                         << ResultDouble(0x4240000F, State::SUCCESS);
+    QCOMPARE(resultList, expResults);
+}
+
+void TestRegisterDecoder::decodeFloat()
+{
+    /* 1.5 = 0x3FC00000 */
+    ModbusResultFrame resultFrame(QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002));
+    resultFrame.setValue(0, 0x0000);
+    resultFrame.setValue(1, 0x3FC0);
+
+    RegisterDecoder decoder;
+    decoder.addRegister(0, Type::FLOAT_32, true, 0, 1);
+    decoder.addRegister(1, Type::FLOAT_32, false, 1, 0);
+
+    ResultDoubleList resultList(2);
+    QList<double> valueBuffer;
+    decoder.decode(resultFrame, resultList, valueBuffer);
+
+    auto expResults = ResultDoubleList() << ResultDouble(1.5, State::SUCCESS)
+                                         << ResultDouble(1.5, State::SUCCESS);
+    QCOMPARE(resultList, expResults);
+}
+
+void TestRegisterDecoder::decodeFloatSpecial()
+{
+    /* Infinite (0x7F800000) and NaN (0x7FC00000) are decoded as zero */
+    ModbusResultFrame resultFrame(QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002)
+                                                         << ModbusAddress(40003) << ModbusAddress(40004));
+    resultFrame.setValue(0, 0x0000);
+    resultFrame.setValue(1, 0x7F80);
+    resultFrame.setValue(2, 0x0000);
+    resultFrame.setValue(3, 0x7FC0);
+
+    RegisterDecoder decoder;
+    decoder.addRegister(0, Type::FLOAT_32, true, 0, 1);
+    decoder.addRegister(1, Type::FLOAT_32, true, 2, 3);
+
+    ResultDoubleList resultList(2);
+    QList<double> valueBuffer;
+    decoder.decode(resultFrame, resultList, valueBuffer);
+
+    auto expResults = ResultDoubleList() << ResultDouble(0, State::SUCCESS)
+                                         << ResultDouble(0, State::SUCCESS);
+    QCOMPARE(resultList, expResults);
+}
+
+void TestRegisterDecoder::decodeInvalid()
+{
+    ModbusResultFrame resultFrame(QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002)
+                                                         << ModbusAddress(40003));
+    resultFrame.setValue(0, 1);
+    resultFrame.setError(1);
+    resultFrame.setValue(2, 3);
+
+    /* 32 bit register is invalid when one of its registers is invalid */
+    RegisterDecoder decoder;
+    decoder.addRegister(0, Type::UNSIGNED_16, true, 0, ModbusResultFrame::cNoSlot);
+    decoder.addRegister(1, Type::UNSIGNED_16, true, 1, ModbusResultFrame::cNoSlot);
+    decoder.addRegister(2, Type::UNSIGNED_32, true, 0, 1);
+    decoder.addRegister(3, Type::UNSIGNED_32, true, 1, 2);
+
+    ResultDoubleList resultList(4);
+    QList<double> valueBuffer;
+    decoder.decode(resultFrame, resultList, valueBuffer);
+
+    auto expResults = ResultDoubleList() << ResultDouble(1, State::SUCCESS)
+                                         << ResultDouble(0, State::INVALID)
+                                         << ResultDouble(0, State::INVALID)
+                                         << ResultDouble(0, State::INVALID);
+    QCOMPARE(resultList, expResults);
+}
+
+void TestRegisterDecoder::decodeSameAsRegister()
+{
+    const auto types = QList<Type>() << Type::UNSIGNED_16 << Type::SIGNED_16 << Type::UNSIGNED_32
+                                     << Type::SIGNED_32 << Type::FLOAT_32;
+    const auto rawValues = QList<quint16>() << 0x0000 << 0x0001 << 0x7FFF << 0x8000 << 0xFFFF
+                                            << 0x3FC0 << 0x4049 << 0x0FDB << 0x7F80 << 0xC2F6;
+
+    QList<ModbusAddress> addressList;
+    for (qint32 idx = 0; idx < rawValues.size(); idx++)
+    {
+        addressList.append(ModbusAddress(40001 + idx));
+    }
+
+    ModbusResultFrame resultFrame(addressList);
+    for (qint32 idx = 0; idx < rawValues.size(); idx++)
+    {
+        resultFrame.setValue(idx, rawValues[idx]);
+    }
+
+    for (const bool bLittleEndian : { true, false })
+    {
+        /* Every combination of lower and upper register for every type */
+        RegisterDecoder decoder;
+        QList<double> expValues;
+        for (const Type type : types)
+        {
+            const ModbusRegister mbReg(ModbusAddress(40001), 0, type);
+            for (qint32 lower = 0; lower < rawValues.size(); lower++)
+            {
+                for (qint32 upper = 0; upper < rawValues.size(); upper++)
+                {
+                    decoder.addRegister(static_cast<qint32>(expValues.size()), type, bLittleEndian, lower, upper);
+                    expValues.append(mbReg.processValue(rawValues[lower], rawValues[upper], bLittleEndian));
+                }
+            }
+        }
+
+        ResultDoubleList resultList(expValues.size());
+        QList<double> valueBuffer;
+        decoder.decode(resultFrame, resultList, valueBuffer);
+
+        for (qint32 idx = 0; idx < expValues.size(); idx++)
+        {
+            QCOMPARE(resultList[idx], ResultDouble(expValues[idx], State::SUCCESS));
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestRegisterDecoder)
@@ -0,0 +1,21 @@
+
+#include <QObject>
+
+class TestRegisterDecoder: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void decode_16();
+    void decode_32();
+    void decodeBigEndian_32();
+    void decodeFloat();
+    void decodeFloatSpecial();
+    void decodeInvalid();
+    void decodeSameAsRegister();
+
+private:
+
+};
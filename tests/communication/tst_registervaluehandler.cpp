@@ -182,6 +182,51 @@ void TestRegisterValueHandler::addressListSameRegisterDifferentType()
     QVERIFY(actualRegisterList == expRegisterList);
 }
 
+void TestRegisterValueHandler::addressListPollGroups()
+{
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40003), Connection::ID_1, Type::UNSIGNED_32)
+                                                   << ModbusRegister(ModbusAddress(40010), Connection::ID_1, Type::UNSIGNED_16);
+    auto pollGroups = QList<quint8>() << 0 << 1 << 0;
+
+    RegisterValueHandler regHandler(_pSettingsModel);
+    regHandler.setRegisters(modbusRegisters, pollGroups);
+
+    QList<ModbusAddress> actualRegisterList;
+
+    regHandler.registerAddresList(actualRegisterList, Connection::ID_1, 0x01);
+    QCOMPARE(actualRegisterList, QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40010));
+
+    regHandler.registerAddresList(actualRegisterList, Connection::ID_1, 0x02);
+    QCOMPARE(actualRegisterList, QList<ModbusAddress>() << ModbusAddress(40003) << ModbusAddress(40004));
+
+    regHandler.registerAddresList(actualRegisterList, Connection::ID_1);
+    QCOMPARE(actualRegisterList, QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40003)
+                                                        << ModbusAddress(40004) << ModbusAddress(40010));
+}
+
+void TestRegisterValueHandler::addressListDemand()
+{
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40003), Connection::ID_1, Type::UNSIGNED_32)
+                                                   << ModbusRegister(ModbusAddress(40010), Connection::ID_1, Type::UNSIGNED_16);
+
+    RegisterValueHandler regHandler(_pSettingsModel);
+    regHandler.setRegisters(modbusRegisters);
+
+    QList<ModbusAddress> actualRegisterList;
+
+    regHandler.setRegisterDemand(QList<bool>() << true << false << true);
+    regHandler.registerAddresList(actualRegisterList, Connection::ID_1);
+    QCOMPARE(actualRegisterList, QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40010));
+
+    /* All registers are read again without demand list */
+    regHandler.setRegisterDemand(QList<bool>());
+    regHandler.registerAddresList(actualRegisterList, Connection::ID_1);
+    QCOMPARE(actualRegisterList, QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40003)
+                                                        << ModbusAddress(40004) << ModbusAddress(40010));
+}
+
 void TestRegisterValueHandler::read_16()
 {
     auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
@@ -276,8 +321,8 @@ void TestRegisterValueHandler::readConnections()
     QSignalSpy spyDataReady(&regHandler, &RegisterValueHandler::registerDataReady);
 
     regHandler.startRead();
-    regHandler.processPartialResult(partialResultMap1, Connection::ID_1);
-    regHandler.processPartialResult(partialResultMap2, Connection::ID_2);
+    regHandler.processPartialResult(ModbusResultFrame::fromResultMap(partialResultMap1), Connection::ID_1);
+    regHandler.processPartialResult(ModbusResultFrame::fromResultMap(partialResultMap2), Connection::ID_2);
     regHandler.finishRead();
 
     QCOMPARE(spyDataReady.count(), 1);
@@ -286,8 +331,8 @@ void TestRegisterValueHandler::readConnections()
     QVERIFY(arguments.count() > 0);
 
     QVariant varResultList = arguments.first();
-    QVERIFY(varResultList.canConvert<ResultDoubleList >());
-    ResultDoubleList result = varResultList.value<ResultDoubleList >();
+    QVERIFY(varResultList.canConvert<SampleFrame>());
+    ResultDoubleList result = varResultList.value<SampleFrame>().toResultList();
 
     QCOMPARE(result, expResults);
 }
@@ -310,7 +355,75 @@ void TestRegisterValueHandler::readFail()
     QSignalSpy spyDataReady(&regHandler, &RegisterValueHandler::registerDataReady);
 
     regHandler.startRead();
-    regHandler.processPartialResult(partialResultMap2, Connection::ID_2);
+    regHandler.processPartialResult(ModbusResultFrame::fromResultMap(partialResultMap2), Connection::ID_2);
+    regHandler.finishRead();
+
+    QCOMPARE(spyDataReady.count(), 1);
+
+    QList<QVariant> arguments = spyDataReady.takeFirst();
+    QVERIFY(arguments.count() > 0);
+
+    QVariant varResultList = arguments.first();
+    QVERIFY(varResultList.canConvert<SampleFrame>());
+    ResultDoubleList result = varResultList.value<SampleFrame>().toResultList();
+
+    QCOMPARE(result, expResults);
+}
+
+void TestRegisterValueHandler::readPollGroups()
+{
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_32);
+    auto pollGroups = QList<quint8>() << 0 << 1;
+
+    ModbusResultMap partialResultMap;
+    addToResultMap(partialResultMap, 40001, false, 256, State::SUCCESS);
+
+    /* 32 bit register isn't due, so it isn't updated with partial result */
+    auto expResults = ResultDoubleList() << ResultDouble(256, State::SUCCESS)
+                                         << ResultDouble(0, State::NO_VALUE);
+
+    RegisterValueHandler regHandler(_pSettingsModel);
+    regHandler.setRegisters(modbusRegisters, pollGroups);
+
+    QSignalSpy spyDataReady(&regHandler, &RegisterValueHandler::registerDataReady);
+
+    regHandler.startRead(0x01);
+    regHandler.processPartialResult(ModbusResultFrame::fromResultMap(partialResultMap), Connection::ID_1);
+    regHandler.finishRead();
+
+    QCOMPARE(spyDataReady.count(), 1);
+
+    QList<QVariant> arguments = spyDataReady.takeFirst();
+    QVERIFY(arguments.count() > 0);
+
+    QVariant varResultList = arguments.first();
+    QVERIFY(varResultList.canConvert<SampleFrame>());
+    ResultDoubleList result = varResultList.value<SampleFrame>().toResultList();
+
+    QCOMPARE(result, expResults);
+}
+
+void TestRegisterValueHandler::readDemand()
+{
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40002), Connection::ID_1, Type::UNSIGNED_16);
+
+    ModbusResultMap partialResultMap;
+    addToResultMap(partialResultMap, 40001, false, 256, State::SUCCESS);
+
+    /* Register without demand isn't read, so it has no value */
+    auto expResults = ResultDoubleList() << ResultDouble(256, State::SUCCESS)
+                                         << ResultDouble(0, State::NO_VALUE);
+
+    RegisterValueHandler regHandler(_pSettingsModel);
+    regHandler.setRegisters(modbusRegisters);
+    regHandler.setRegisterDemand(QList<bool>() << true << false);
+
+    QSignalSpy spyDataReady(&regHandler, &RegisterValueHandler::registerDataReady);
+
+    regHandler.startRead();
+    regHandler.processPartialResult(ModbusResultFrame::fromResultMap(partialResultMap), Connection::ID_1);
     regHandler.finishRead();
 
     QCOMPARE(spyDataReady.count(), 1);
@@ -319,8 +432,84 @@ void TestRegisterValueHandler::readFail()
     QVERIFY(arguments.count() > 0);
 
     QVariant varResultList = arguments.first();
-    QVERIFY(varResultList.canConvert<ResultDoubleList >());
-    ResultDoubleList result = varResultList.value<ResultDoubleList >();
+    QVERIFY(varResultList.canConvert<SampleFrame>());
+    ResultDoubleList result = varResultList.value<SampleFrame>().toResultList();
+
+    QCOMPARE(result, expResults);
+}
+
+void TestRegisterValueHandler::readSingleConnection()
+{
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40001), Connection::ID_2, Type::SIGNED_16);
+
+    ModbusResultMap partialResultMap2;
+    addToResultMap(partialResultMap2, 40001, false, 100, State::SUCCESS);
+
+    /* Only results of connection 2 are published */
+    auto expResults = ResultDoubleList() << ResultDouble(0, State::NO_VALUE)
+                                         << ResultDouble(100, State::SUCCESS);
+
+    RegisterValueHandler regHandler(_pSettingsModel);
+    regHandler.setRegisters(modbusRegisters);
+
+    QCOMPARE(regHandler.pollGroups(Connection::ID_1), static_cast<quint64>(0x01));
+    QCOMPARE(regHandler.pollGroups(Connection::ID_2), static_cast<quint64>(0x01));
+    QCOMPARE(regHandler.pollGroups(Connection::ID_3), static_cast<quint64>(0));
+
+    QSignalSpy spyDataReady(&regHandler, &RegisterValueHandler::registerDataReady);
+
+    regHandler.startConnectionRead(Connection::ID_2);
+    regHandler.processPartialResult(ModbusResultFrame::fromResultMap(partialResultMap2), Connection::ID_2);
+    regHandler.finishConnectionRead(Connection::ID_2, 1234);
+
+    QCOMPARE(spyDataReady.count(), 1);
+
+    QList<QVariant> arguments = spyDataReady.takeFirst();
+    QCOMPARE(arguments.count(), 1);
+    QCOMPARE(arguments[0].value<SampleFrame>().timestamp(), static_cast<qint64>(1234));
+
+    QVariant varResultList = arguments.first();
+    QVERIFY(varResultList.canConvert<SampleFrame>());
+    ResultDoubleList result = varResultList.value<SampleFrame>().toResultList();
+
+    QCOMPARE(result, expResults);
+}
+
+void TestRegisterValueHandler::readCompiledFrame()
+{
+    auto modbusRegisters = QList<ModbusRegister>() << ModbusRegister(ModbusAddress(40003), Connection::ID_1, Type::UNSIGNED_32)
+                                                   << ModbusRegister(ModbusAddress(40001), Connection::ID_1, Type::UNSIGNED_16)
+                                                   << ModbusRegister(ModbusAddress(40010), Connection::ID_1, Type::UNSIGNED_16);
+
+    auto expResults = ResultDoubleList() << ResultDouble(0x20001, State::SUCCESS)
+                                         << ResultDouble(100, State::SUCCESS)
+                                         << ResultDouble(0, State::INVALID);
+
+    RegisterValueHandler regHandler(_pSettingsModel);
+    regHandler.setRegisters(modbusRegisters);
+
+    QSignalSpy spyDataReady(&regHandler, &RegisterValueHandler::registerDataReady);
+
+    /* Frame of a poll uses the compiled address list: 40001, 40003, 40004, 40010 */
+    QList<ModbusAddress> registerList;
+    regHandler.registerAddresList(registerList, Connection::ID_1);
+
+    ModbusResultFrame resultFrame(registerList);
+    QCOMPARE(resultFrame.size(), 4);
+    resultFrame.setValue(0, 100);
+    resultFrame.setValue(1, 1);
+    resultFrame.setValue(2, 2);
+    resultFrame.setError(3);
+
+    regHandler.startConnectionRead(Connection::ID_1);
+    regHandler.processPartialResult(resultFrame, Connection::ID_1);
+    regHandler.finishConnectionRead(Connection::ID_1, 0);
+
+    QCOMPARE(spyDataReady.count(), 1);
+
+    QList<QVariant> arguments = spyDataReady.takeFirst();
+    ResultDoubleList result = arguments.first().value<SampleFrame>().toResultList();
 
     QCOMPARE(result, expResults);
 }
@@ -335,7 +524,7 @@ void TestRegisterValueHandler::verifyRegisterResult(QList<ModbusRegister>& regLi
     QSignalSpy spyDataReady(&regHandler, &RegisterValueHandler::registerDataReady);
 
     regHandler.startRead();
-    regHandler.processPartialResult(regData, Connection::ID_1);
+    regHandler.processPartialResult(ModbusResultFrame::fromResultMap(regData), Connection::ID_1);
     regHandler.finishRead();
 
     QCOMPARE(spyDataReady.count(), 1);
@@ -344,8 +533,8 @@ void TestRegisterValueHandler::verifyRegisterResult(QList<ModbusRegister>& regLi
     QVERIFY(arguments.count() > 0);
 
     QVariant varResultList = arguments.first();
-    QVERIFY(varResultList.canConvert<ResultDoubleList >());
-    ResultDoubleList result = varResultList.value<ResultDoubleList >();
+    QVERIFY(varResultList.canConvert<SampleFrame>());
+    ResultDoubleList result = varResultList.value<SampleFrame>().toResultList();
 
     QCOMPARE(result, expResults);
 }
@@ -23,6 +23,8 @@ private slots:
     void addressListMultipleConnections();
     void addressListMixedObjects();
     void addressListSameRegisterDifferentType();
+    void addressListPollGroups();
+    void addressListDemand();
 
     void read_16();
     void read_32();
@@ -33,6 +35,10 @@ private slots:
     void readSameRegisterDifferentType();
     void readConnections();
     void readFail();
+    void readPollGroups();
+    void readDemand();
+    void readSingleConnection();
+    void readCompiledFrame();
 
 private:
 
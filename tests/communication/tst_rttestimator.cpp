@@ -0,0 +1,104 @@
+
+#include <QtTest/QtTest>
+
+#include "tst_rttestimator.h"
+
+#include "rttestimator.h"
+
+void TestRttEstimator::init()
+{
+
+}
+
+void TestRttEstimator::cleanup()
+{
+
+}
+
+void TestRttEstimator::noSamples()
+{
+    RttEstimator estimator;
+
+    /* Configured timeout is used until round-trip time is known */
+    QCOMPARE(estimator.sampleCount(), static_cast<quint32>(0));
+    QCOMPARE(estimator.requestTimeout(1000), static_cast<quint32>(1000));
+}
+
+void TestRttEstimator::firstSample()
+{
+    RttEstimator estimator;
+
+    estimator.addSample(10000);
+
+    QCOMPARE(estimator.sampleCount(), static_cast<quint32>(1));
+    QCOMPARE(estimator.smoothedRtt(), static_cast<qint64>(10000));
+    QCOMPARE(estimator.rttVariation(), static_cast<qint64>(5000));
+
+    /* 10 ms + 4 * 5 ms */
+    QCOMPARE(estimator.requestTimeout(1000), static_cast<quint32>(30));
+}
+
+void TestRttEstimator::smoothing()
+{
+    RttEstimator estimator;
+
+    estimator.addSample(10000);
+    estimator.addSample(10000);
+
+    /* Deviation decreases when round-trip time is stable */
+    QCOMPARE(estimator.smoothedRtt(), static_cast<qint64>(10000));
+    QCOMPARE(estimator.rttVariation(), static_cast<qint64>(3750));
+    QCOMPARE(estimator.requestTimeout(1000), static_cast<quint32>(25));
+
+    /* A single slow response only moves the estimate by 1/8 */
+    estimator.addSample(18000);
+    QCOMPARE(estimator.smoothedRtt(), static_cast<qint64>(11000));
+    QCOMPARE(estimator.rttVariation(), static_cast<qint64>(4812));
+}
+
+void TestRttEstimator::boundedTimeout()
+{
+    RttEstimator estimator;
+
+    estimator.addSample(1000);
+    QCOMPARE(estimator.requestTimeout(1000), RttEstimator::cMinTimeout);
+
+    /* Minimum doesn't exceed configured timeout */
+    QCOMPARE(estimator.requestTimeout(10), static_cast<quint32>(10));
+
+    estimator.reset();
+    estimator.addSample(1000000);
+    QCOMPARE(estimator.requestTimeout(1000), static_cast<quint32>(1000));
+}
+
+void TestRttEstimator::backOff()
+{
+    RttEstimator estimator;
+
+    estimator.addSample(10000);
+    QCOMPARE(estimator.requestTimeout(1000), static_cast<quint32>(30));
+
+    /* Timeout doubles for every timeout */
+    estimator.backOff();
+    QCOMPARE(estimator.requestTimeout(1000), static_cast<quint32>(60));
+
+    estimator.backOff();
+    QCOMPARE(estimator.requestTimeout(1000), static_cast<quint32>(120));
+
+    /* Next sample ends back-off */
+    estimator.addSample(10000);
+    QCOMPARE(estimator.requestTimeout(1000), static_cast<quint32>(25));
+}
+
+void TestRttEstimator::reset()
+{
+    RttEstimator estimator;
+
+    estimator.addSample(10000);
+    estimator.reset();
+
+    QCOMPARE(estimator.sampleCount(), static_cast<quint32>(0));
+    QCOMPARE(estimator.requestTimeout(500), static_cast<quint32>(500));
+}
+
+QTEST_GUILESS_MAIN(TestRttEstimator)
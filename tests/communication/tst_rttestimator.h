@@ -0,0 +1,20 @@
+
+#include <QObject>
+
+class TestRttEstimator: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void noSamples();
+    void firstSample();
+    void smoothing();
+    void boundedTimeout();
+    void backOff();
+    void reset();
+
+private:
+
+};
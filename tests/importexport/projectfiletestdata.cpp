@@ -100,8 +100,14 @@ QString ProjectFileTestData::cConnMixedMulti = QString(
     "   <slaveid>2</slaveid>                                           \n"\
     "   <timeout>1002</timeout>                                        \n"\
     "   <consecutivemax>12</consecutivemax>                            \n"\
+    "   <requestwindow>4</requestwindow>                               \n"\
     "   <int32littleendian>true</int32littleendian>                    \n"\
     "   <persistentconnection>true</persistentconnection>              \n"\
+    "   <lingertime>500</lingertime>                                   \n"\
+    "   <interframedelay>1750</interframedelay>                        \n"\
+    "   <turnarounddelay>5</turnarounddelay>                           \n"\
+    "   <adaptivetimeout>true</adaptivetimeout>                        \n"\
+    "   <retries>2</retries>                                           \n"\
     "  </connection>                                                   \n"\
     "  <connection>                                                    \n"\
     "   <enabled>false</enabled>                                       \n"\
@@ -151,6 +157,59 @@ QString ProjectFileTestData::cConnEmpty = QString(
     "</modbusscope>                                                    \n"
 );
 
+QString ProjectFileTestData::cConnMany = QString(
+    "<?xml version=\"1.0\"?>                                           \n"\
+    "<modbusscope datalevel=\"3\">                                     \n"\
+    " <modbus>                                                         \n"\
+    "  <connection>                                                    \n"\
+    "   <connectionid>0</connectionid>                                 \n"\
+    "   <ip>192.168.1.1</ip>                                           \n"\
+    "  </connection>                                                   \n"\
+    "  <connection>                                                    \n"\
+    "   <connectionid>41</connectionid>                                \n"\
+    "   <ip>192.168.1.42</ip>                                          \n"\
+    "  </connection>                                                   \n"\
+    "  <log>                                                           \n"\
+    "   <maxconcurrentconnections>8</maxconcurrentconnections>         \n"\
+    "   <nativeengine>true</nativeengine>                              \n"\
+    "   <ondemandpolling>true</ondemandpolling>                        \n"\
+    "  </log>                                                          \n"\
+    " </modbus>                                                        \n"\
+    " <scope>                                                          \n"\
+    "  <register active=\"true\">                                      \n"\
+    "   <text>Data point</text>                                        \n"\
+    "   <expression><![CDATA[${40001@42}]]></expression>               \n"\
+    "   <connectionid>41</connectionid>                                \n"\
+    "  </register>                                                     \n"\
+    " </scope>                                                         \n"\
+    "</modbusscope>                                                    \n"
+);
+
+QString ProjectFileTestData::cConnIdOutOfRange = QString(
+    "<?xml version=\"1.0\"?>                                           \n"\
+    "<modbusscope datalevel=\"3\">                                     \n"\
+    " <modbus>                                                         \n"\
+    "  <connection>                                                    \n"\
+    "   <connectionid>256</connectionid>                               \n"\
+    "   <ip>192.168.1.1</ip>                                           \n"\
+    "  </connection>                                                   \n"\
+    " </modbus>                                                        \n"\
+    "</modbusscope>                                                    \n"
+);
+
+QString ProjectFileTestData::cRegisterConnIdOutOfRange = QString(
+    "<?xml version=\"1.0\"?>                                           \n"\
+    "<modbusscope datalevel=\"3\">                                     \n"\
+    " <scope>                                                          \n"\
+    "  <register active=\"true\">                                      \n"\
+    "   <text>Data point</text>                                        \n"\
+    "   <expression><![CDATA[${40001}]]></expression>                  \n"\
+    "   <connectionid>255</connectionid>                               \n"\
+    "  </register>                                                     \n"\
+    " </scope>                                                         \n"\
+    "</modbusscope>                                                    \n"
+);
+
 QString ProjectFileTestData::cScaleDouble = QString(
     "<?xml version=\"1.0\"?>                                    \n"\
     "<modbusscope datalevel=\"3\">                              \n"\
@@ -207,3 +266,25 @@ QString ProjectFileTestData::cValueAxis = QString(
     "    </scope>                                                               \n"\
     "</modbusscope>                                                             \n"\
 );
+
+QString ProjectFileTestData::cPollInterval = QString(
+    "<?xml version=\"1.0\"?>                                                    \n"\
+    "<modbusscope datalevel=\"3\">                                              \n"\
+    "    <scope>                                                                \n"\
+    "        <register active=\"true\">                                         \n"\
+    "            <text>Data point</text>                                        \n"\
+    "            <expression><![CDATA[${40001}/2]]></expression>                \n"\
+    "            <pollinterval>10</pollinterval>                                \n"\
+    "        </register>                                                        \n"\
+    "        <register active=\"true\">                                         \n"\
+    "            <text>Data point 2</text>                                      \n"\
+    "            <expression><![CDATA[${40002:s16b}]]></expression>             \n"\
+    "            <pollinterval>1000</pollinterval>                              \n"\
+    "        </register>                                                        \n"\
+    "        <register active=\"true\">                                         \n"\
+    "            <text>Data point 3</text>                                      \n"\
+    "            <expression><![CDATA[${40003}]]></expression>                  \n"\
+    "        </register>                                                        \n"\
+    "    </scope>                                                               \n"\
+    "</modbusscope>                                                             \n"\
+);
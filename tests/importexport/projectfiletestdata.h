@@ -14,10 +14,14 @@ public:
     static QString cConnSerial;
     static QString cConnMixedMulti;
     static QString cConnEmpty;
+    static QString cConnMany;
+    static QString cConnIdOutOfRange;
+    static QString cRegisterConnIdOutOfRange;
 
     static QString cScaleDouble;
     static QString cValueAxis2Scaling;
     static QString cValueAxis;
+    static QString cPollInterval;
 
 private:
 
@@ -187,9 +187,25 @@ void TestProjectFileParser::connMixedMulti()
     QVERIFY(settings.general.connectionSettings[0].bConsecutiveMax);
     QCOMPARE(settings.general.connectionSettings[0].consecutiveMax, 12);
 
+    QVERIFY(settings.general.connectionSettings[0].bRequestWindow);
+    QCOMPARE(settings.general.connectionSettings[0].requestWindow, 4);
+
     QVERIFY(settings.general.connectionSettings[0].bInt32LittleEndian);
     QVERIFY(settings.general.connectionSettings[0].bPersistentConnection);
 
+    QVERIFY(settings.general.connectionSettings[0].bLingerTime);
+    QCOMPARE(settings.general.connectionSettings[0].lingerTime, static_cast<quint32>(500));
+
+    QVERIFY(settings.general.connectionSettings[0].bInterFrameDelay);
+    QCOMPARE(settings.general.connectionSettings[0].interFrameDelay, static_cast<quint32>(1750));
+
+    QVERIFY(settings.general.connectionSettings[0].bTurnaroundDelay);
+    QCOMPARE(settings.general.connectionSettings[0].turnaroundDelay, static_cast<quint32>(5));
+
+    QVERIFY(settings.general.connectionSettings[0].bAdaptiveTimeout);
+    QVERIFY(settings.general.connectionSettings[0].bRetries);
+    QCOMPARE(settings.general.connectionSettings[0].retries, static_cast<quint8>(2));
+
 
     /* Connection id 1 */
     QVERIFY(settings.general.connectionSettings[1].bConnectionId);
@@ -230,8 +246,15 @@ void TestProjectFileParser::connMixedMulti()
     QVERIFY(settings.general.connectionSettings[1].bConsecutiveMax);
     QCOMPARE(settings.general.connectionSettings[1].consecutiveMax, 125);
 
+    QVERIFY(settings.general.connectionSettings[1].bRequestWindow == false);
+
     QVERIFY(settings.general.connectionSettings[1].bInt32LittleEndian);
     QVERIFY(settings.general.connectionSettings[1].bPersistentConnection);
+    QVERIFY(settings.general.connectionSettings[1].bLingerTime == false);
+    QVERIFY(settings.general.connectionSettings[1].bInterFrameDelay == false);
+    QVERIFY(settings.general.connectionSettings[1].bTurnaroundDelay == false);
+    QVERIFY(settings.general.connectionSettings[1].bAdaptiveTimeout == false);
+    QVERIFY(settings.general.connectionSettings[1].bRetries == false);
 
 
     /* Connection id 2 */
@@ -307,6 +330,51 @@ void TestProjectFileParser::connEmpty()
     QVERIFY(settings.general.connectionSettings[0].bPersistentConnection);
 }
 
+void TestProjectFileParser::connMany()
+{
+    ProjectFileParser projectParser;
+    ProjectFileData::ProjectSettings settings;
+
+    GeneralError parseError = projectParser.parseFile(ProjectFileTestData::cConnMany, &settings);
+    QVERIFY(parseError.result());
+
+    QCOMPARE(settings.general.connectionSettings.size(), 2);
+
+    QVERIFY(settings.general.connectionSettings[0].bConnectionId);
+    QCOMPARE(settings.general.connectionSettings[0].connectionId, 0);
+    QCOMPARE(settings.general.connectionSettings[0].ip, "192.168.1.1");
+
+    QVERIFY(settings.general.connectionSettings[1].bConnectionId);
+    QCOMPARE(settings.general.connectionSettings[1].connectionId, 41);
+    QCOMPARE(settings.general.connectionSettings[1].ip, "192.168.1.42");
+
+    QCOMPARE(settings.general.logSettings.maxConcurrentConnections, 8);
+    QVERIFY(settings.general.logSettings.bNativeEngine);
+    QVERIFY(settings.general.logSettings.bOnDemandPolling);
+
+    /* Register can use a connection beyond the first three */
+    QCOMPARE(settings.scope.registerList.size(), 1);
+    QCOMPARE(settings.scope.registerList[0].connectionId, 41);
+}
+
+void TestProjectFileParser::connIdOutOfRange()
+{
+    ProjectFileParser projectParser;
+    ProjectFileData::ProjectSettings settings;
+
+    GeneralError parseError = projectParser.parseFile(ProjectFileTestData::cConnIdOutOfRange, &settings);
+    QVERIFY(!parseError.result());
+}
+
+void TestProjectFileParser::registerConnIdOutOfRange()
+{
+    ProjectFileParser projectParser;
+    ProjectFileData::ProjectSettings settings;
+
+    GeneralError parseError = projectParser.parseFile(ProjectFileTestData::cRegisterConnIdOutOfRange, &settings);
+    QVERIFY(!parseError.result());
+}
+
 void TestProjectFileParser::scaleDouble()
 {
     ProjectFileParser projectParser;
@@ -362,5 +430,18 @@ void TestProjectFileParser::valueAxis()
     QCOMPARE(settings.scope.registerList[2].valueAxis, 0);
 }
 
+void TestProjectFileParser::pollInterval()
+{
+    ProjectFileParser projectParser;
+    ProjectFileData::ProjectSettings settings;
+
+    GeneralError parseError = projectParser.parseFile(ProjectFileTestData::cPollInterval, &settings);
+    QVERIFY(parseError.result());
+
+    QCOMPARE(settings.scope.registerList[0].pollInterval, 10);
+    QCOMPARE(settings.scope.registerList[1].pollInterval, 1000);
+    QCOMPARE(settings.scope.registerList[2].pollInterval, 0);
+}
+
 
 QTEST_GUILESS_MAIN(TestProjectFileParser)
@@ -18,10 +18,14 @@ private slots:
     void connSerial();
     void connMixedMulti();
     void connEmpty();
+    void connMany();
+    void connIdOutOfRange();
+    void registerConnIdOutOfRange();
 
     void scaleDouble();
     void valueAxis2Scaling();
     void valueAxis();
+    void pollInterval();
 
 private:
 
@@ -32,6 +32,14 @@ void TestSlaveModbus::setException(QModbusPdu::ExceptionCode exception, bool bPe
     _bExceptionPersistent = bPersistent;
 }
 
+/*!
+ * Process request that is received over another transport (for example \ref TestSlaveUdp)
+ */
+QModbusResponse TestSlaveModbus::processTransportRequest(const QModbusPdu &request)
+{
+    return processRequest(request);
+}
+
 bool TestSlaveModbus::readData(QModbusDataUnit *newData) const
 {
     if (!verifyValidObject(newData))
@@ -21,6 +21,8 @@ public:
 
     void setException(QModbusPdu::ExceptionCode exception, bool bPersistent);
 
+    QModbusResponse processTransportRequest(const QModbusPdu &request);
+
 signals:
     void requestProcessed();
 
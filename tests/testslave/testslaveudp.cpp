@@ -0,0 +1,84 @@
+#include <QNetworkDatagram>
+
+#include "testslaveudp.h"
+
+TestSlaveUdp::TestSlaveUdp(TestSlaveModbus* pTestSlaveModbus, QObject *parent)
+    : QObject(parent), _pTestSlaveModbus(pTestSlaveModbus), _socket(this)
+{
+    _slaveId = 1;
+    _dropCount = 0;
+
+    QObject::connect(&_socket, &QUdpSocket::readyRead, this, &TestSlaveUdp::handleReadyRead);
+}
+
+TestSlaveUdp::~TestSlaveUdp()
+{
+
+}
+
+bool TestSlaveUdp::connect(QUrl host, int slaveId)
+{
+    _slaveId = slaveId;
+
+    return _socket.bind(QHostAddress(host.host()), static_cast<quint16>(host.port()));
+}
+
+void TestSlaveUdp::disconnect()
+{
+    _socket.close();
+}
+
+void TestSlaveUdp::setDropCount(quint32 dropCount)
+{
+    _dropCount = dropCount;
+}
+
+void TestSlaveUdp::handleReadyRead()
+{
+    while (_socket.hasPendingDatagrams())
+    {
+        const QNetworkDatagram datagram = _socket.receiveDatagram();
+        const QByteArray request = datagram.data();
+
+        /* MBAP header and function code */
+        if (request.size() < 8)
+        {
+            continue;
+        }
+
+        if (static_cast<quint8>(request.at(6)) != static_cast<quint8>(_slaveId))
+        {
+            continue;
+        }
+
+        emit requestReceived();
+
+        if (_dropCount > 0)
+        {
+            _dropCount--;
+            continue;
+        }
+
+        const auto functionCode = static_cast<QModbusPdu::FunctionCode>(static_cast<quint8>(request.at(7)));
+        const QModbusResponse response = _pTestSlaveModbus->processTransportRequest(QModbusRequest(functionCode, request.mid(8)));
+
+        quint8 responseCode = static_cast<quint8>(response.functionCode());
+        if (response.isException())
+        {
+            responseCode |= QModbusPdu::ExceptionByte;
+        }
+
+        /* Length of unit id, function code and data */
+        const quint16 length = static_cast<quint16>(2 + response.data().size());
+
+        QByteArray reply;
+        reply.append(request.left(4));
+        reply.append(static_cast<char>(length >> 8));
+        reply.append(static_cast<char>(length & 0xFF));
+        reply.append(request.at(6));
+        reply.append(static_cast<char>(responseCode));
+        reply.append(response.data());
+
+        _socket.writeDatagram(datagram.makeReply(reply));
+    }
+}
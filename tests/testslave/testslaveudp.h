@@ -0,0 +1,44 @@
+#ifndef TESTSLAVEUDP_H
+#define TESTSLAVEUDP_H
+
+#include <QObject>
+#include <QUdpSocket>
+#include <QUrl>
+
+#include "testslavemodbus.h"
+
+/*!
+ * Modbus UDP stand-in of a test slave
+ * Receives Modbus requests as datagrams with an MBAP header and answers them with the data of a \ref TestSlaveModbus
+ */
+class TestSlaveUdp : public QObject
+{
+    Q_OBJECT
+public:
+
+    explicit TestSlaveUdp(TestSlaveModbus* pTestSlaveModbus, QObject *parent = nullptr);
+    ~TestSlaveUdp();
+
+    bool connect(QUrl host, int slaveId);
+    void disconnect();
+
+    void setDropCount(quint32 dropCount);
+
+signals:
+    void requestReceived();
+
+private slots:
+    void handleReadyRead();
+
+private:
+
+    TestSlaveModbus* _pTestSlaveModbus;
+    QUdpSocket _socket;
+
+    int _slaveId;
+
+    /* Number of requests that are dropped without response, to simulate lost datagrams */
+    quint32 _dropCount;
+};
+
+#endif // TESTSLAVEUDP_H
@@ -244,6 +244,22 @@ void TestExpressionParser::manyRegisters()
     verifyParsing(input, expModbusRegisters, expExpressions);
 }
 
+void TestExpressionParser::registerIndexes()
+{
+    auto input = QStringList() << "${45332} + ${45333} + ${45332}" << "${45334}" << "2" << "${45333}";
+
+    ExpressionParser parser(input);
+
+    QList<QList<qint32> > indexLists;
+    parser.expressionRegisterIndexes(indexLists);
+
+    QCOMPARE(indexLists.size(), 4);
+    QCOMPARE(indexLists[0], QList<qint32>() << 0 << 1);
+    QCOMPARE(indexLists[1], QList<qint32>() << 2);
+    QVERIFY(indexLists[2].isEmpty());
+    QCOMPARE(indexLists[3], QList<qint32>() << 1);
+}
+
 void TestExpressionParser::verifyParsing(QStringList exprList, QList<ModbusRegister> &expectedRegisters, QStringList &expectedExpression)
 {
     QList<ModbusRegister> actualModbusRegisters;
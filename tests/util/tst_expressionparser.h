@@ -31,6 +31,8 @@ private slots:
     void constant();
     void manyRegisters();
 
+    void registerIndexes();
+
     void verifyParsing(QStringList exprList, QList<ModbusRegister> &expectedRegisters, QStringList &expectedExpression);
 
 private:
@@ -0,0 +1,116 @@
+
+#include <QtTest/QtTest>
+
+#include "modbusresultframe.h"
+
+#include "tst_modbusresultframe.h"
+
+using State = ResultState::State;
+
+void TestModbusResultFrame::init()
+{
+
+}
+
+void TestModbusResultFrame::cleanup()
+{
+
+}
+
+void TestModbusResultFrame::constructor()
+{
+    auto addressList = QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002) << ModbusAddress(40005);
+    ModbusResultFrame frame(addressList);
+
+    QCOMPARE(frame.size(), 3);
+
+    for (qint32 slot = 0; slot < frame.size(); slot++)
+    {
+        QCOMPARE(frame.address(slot), addressList[slot]);
+        QVERIFY(!frame.isValid(slot));
+        QCOMPARE(frame.value(slot), static_cast<quint16>(0));
+    }
+
+    QCOMPARE(ModbusResultFrame().size(), 0);
+}
+
+void TestModbusResultFrame::unsortedList()
+{
+    auto addressList = QList<ModbusAddress>() << ModbusAddress(40005) << ModbusAddress(40001) << ModbusAddress(2);
+    ModbusResultFrame frame(addressList);
+
+    auto expAddressList = QList<ModbusAddress>() << ModbusAddress(2) << ModbusAddress(40001) << ModbusAddress(40005);
+    QCOMPARE(frame.addressList(), expAddressList);
+}
+
+void TestModbusResultFrame::setValue()
+{
+    ModbusResultFrame frame(QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002));
+
+    frame.setValue(1, 1234);
+
+    QVERIFY(!frame.isValid(0));
+    QVERIFY(frame.isValid(1));
+    QCOMPARE(frame.value(1), static_cast<quint16>(1234));
+    QCOMPARE(frame.result(1), Result<quint16>(1234, State::SUCCESS));
+    QCOMPARE(frame.result(0), Result<quint16>(0, State::INVALID));
+}
+
+void TestModbusResultFrame::setError()
+{
+    ModbusResultFrame frame(QList<ModbusAddress>() << ModbusAddress(40001));
+
+    frame.setValue(0, 1234);
+    frame.setError(0);
+
+    QVERIFY(!frame.isValid(0));
+    QCOMPARE(frame.result(0), Result<quint16>(0, State::INVALID));
+}
+
+void TestModbusResultFrame::reset()
+{
+    auto addressList = QList<ModbusAddress>() << ModbusAddress(40001) << ModbusAddress(40002);
+    ModbusResultFrame frame(addressList);
+
+    frame.setValue(0, 1234);
+    frame.setValue(1, 5678);
+    frame.reset();
+
+    QCOMPARE(frame.addressList(), addressList);
+    QVERIFY(!frame.isValid(0));
+    QVERIFY(!frame.isValid(1));
+    QCOMPARE(frame.result(0), Result<quint16>(0, State::INVALID));
+    QCOMPARE(frame.result(1), Result<quint16>(0, State::INVALID));
+}
+
+void TestModbusResultFrame::slot()
+{
+    ModbusResultFrame frame(QList<ModbusAddress>() << ModbusAddress(0) << ModbusAddress(40001) << ModbusAddress(40003));
+
+    QCOMPARE(frame.slot(ModbusAddress(0)), 0);
+    QCOMPARE(frame.slot(ModbusAddress(40001)), 1);
+    QCOMPARE(frame.slot(ModbusAddress(40003)), 2);
+
+    QCOMPARE(frame.slot(ModbusAddress(40002)), ModbusResultFrame::cNoSlot);
+    QCOMPARE(frame.slot(ModbusAddress(1)), ModbusResultFrame::cNoSlot);
+    QCOMPARE(frame.slot(ModbusAddress(40004)), ModbusResultFrame::cNoSlot);
+}
+
+void TestModbusResultFrame::resultMap()
+{
+    ModbusResultMap resultMap;
+    resultMap.insert(ModbusAddress(40001), Result<quint16>(10, State::SUCCESS));
+    resultMap.insert(ModbusAddress(40003), Result<quint16>(0, State::INVALID));
+    resultMap.insert(ModbusAddress(30001), Result<quint16>(30, State::SUCCESS));
+
+    ModbusResultFrame frame = ModbusResultFrame::fromResultMap(resultMap);
+
+    QCOMPARE(frame.size(), 3);
+    QCOMPARE(frame.result(frame.slot(ModbusAddress(40001))), Result<quint16>(10, State::SUCCESS));
+    QCOMPARE(frame.result(frame.slot(ModbusAddress(40003))), Result<quint16>(0, State::INVALID));
+    QCOMPARE(frame.result(frame.slot(ModbusAddress(30001))), Result<quint16>(30, State::SUCCESS));
+
+    QCOMPARE(frame.toResultMap(), resultMap);
+}
+
+QTEST_GUILESS_MAIN(TestModbusResultFrame)
@@ -0,0 +1,23 @@
+
+#include <QObject>
+
+class TestModbusResultFrame: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void constructor();
+    void unsortedList();
+    void setValue();
+    void setError();
+    void reset();
+    void slot();
+    void resultMap();
+
+private:
+
+
+};
@@ -128,7 +128,7 @@ void TestQMuParser::evaluateSingleRegister()
 
     QMuParser parser(expression);
 
-    parser.setRegistersData(ResultDoubleList() << ResultDouble(registerValue, State::SUCCESS));
+    parser.setRegistersData(SampleFrame(ResultDoubleList() << ResultDouble(registerValue, State::SUCCESS), 0));
 
     bool bSuccess = parser.evaluate();
 
@@ -143,7 +143,7 @@ void TestQMuParser::evaluateMultipleRegisters()
     auto input = ResultDoubleList() << ResultDouble(1, State::SUCCESS) << ResultDouble(2, State::SUCCESS) << ResultDouble(3, State::SUCCESS);
 
     QMuParser parser("r(0)");
-    parser.setRegistersData(input);
+    parser.setRegistersData(SampleFrame(input, 0));
 
     bool bSuccess = parser.evaluate();
 
@@ -183,7 +183,7 @@ void TestQMuParser::evaluateSubsequentRegister()
     for (int idx = 0; idx < count; idx++)
     {
         auto input = ResultDoubleList() << ResultDouble(data[idx], State::SUCCESS);
-        parser.setRegistersData(input);
+        parser.setRegistersData(SampleFrame(input, 0));
 
         bool bSuccess = parser.evaluate();
         QCOMPARE(parser.value(), data[idx]);
@@ -226,7 +226,7 @@ void TestQMuParser::evaluateFail()
 
     QMuParser parser(expression);
 
-    parser.setRegistersData(resultList);
+    parser.setRegistersData(SampleFrame(resultList, 0));
 
     bool bSuccess = parser.evaluate();
 
@@ -343,7 +343,7 @@ void TestQMuParser::expressionUpdate()
     QMuParser parser("r(0) + 1");
 
     auto input_1 = ResultDoubleList() << ResultDouble(5, State::SUCCESS);
-    parser.setRegistersData(input_1);
+    parser.setRegistersData(SampleFrame(input_1, 0));
 
     bool bSuccess = parser.evaluate();
 
@@ -355,7 +355,7 @@ void TestQMuParser::expressionUpdate()
     parser.setExpression("r(0) + r(1) + 2");
 
     auto input_2 = ResultDoubleList() << ResultDouble(1, State::SUCCESS) << ResultDouble(2, State::SUCCESS);
-    parser.setRegistersData(input_2);
+    parser.setRegistersData(SampleFrame(input_2, 0));
     bSuccess = parser.evaluate();
 
     QCOMPARE(parser.value(), 5);
@@ -0,0 +1,108 @@
+
+#include <QtTest/QtTest>
+
+#include "sampleframe.h"
+
+#include "tst_sampleframe.h"
+
+using State = ResultState::State;
+
+void TestSampleFrame::init()
+{
+
+}
+
+void TestSampleFrame::cleanup()
+{
+
+}
+
+void TestSampleFrame::create()
+{
+    SampleFrame frame = SampleFrame::create(3, 1234);
+
+    QCOMPARE(frame.size(), 3);
+    QCOMPARE(frame.timestamp(), static_cast<qint64>(1234));
+    QVERIFY(!frame.isShared());
+
+    for (const ResultDouble& result : frame)
+    {
+        QCOMPARE(result.state(), State::NO_VALUE);
+    }
+
+    QVERIFY(SampleFrame().isEmpty());
+    QCOMPARE(SampleFrame().timestamp(), static_cast<qint64>(0));
+}
+
+void TestSampleFrame::fromResultList()
+{
+    auto resultList = ResultDoubleList() << ResultDouble(1, State::SUCCESS)
+                                         << ResultDouble(0, State::INVALID)
+                                         << ResultDouble(0, State::NO_VALUE);
+
+    SampleFrame frame(resultList, 5678);
+
+    QCOMPARE(frame.timestamp(), static_cast<qint64>(5678));
+    QCOMPARE(frame.toResultList(), resultList);
+    QCOMPARE(frame[0], ResultDouble(1, State::SUCCESS));
+}
+
+void TestSampleFrame::shared()
+{
+    SampleFrame frame = SampleFrame::create(2, 0);
+    frame.setResult(0, ResultDouble(5, State::SUCCESS));
+
+    SampleFrame copy = frame;
+
+    QVERIFY(frame.isShared());
+    QVERIFY(copy.isShared());
+
+    /* Copy shares the results */
+    QCOMPARE(&copy.at(0), &frame.at(0));
+
+    copy = SampleFrame();
+    QVERIFY(!frame.isShared());
+}
+
+void TestSampleFrame::copyOnWrite()
+{
+    SampleFrame frame = SampleFrame::create(2, 10);
+    frame.setResult(0, ResultDouble(5, State::SUCCESS));
+
+    SampleFrame copy = frame;
+    copy.setResult(1, ResultDouble(6, State::SUCCESS));
+
+    QVERIFY(!frame.isShared());
+    QVERIFY(!copy.isShared());
+
+    QCOMPARE(frame.toResultList(), ResultDoubleList() << ResultDouble(5, State::SUCCESS)
+                                                      << ResultDouble(0, State::NO_VALUE));
+
+    QCOMPARE(copy.toResultList(), ResultDoubleList() << ResultDouble(5, State::SUCCESS)
+                                                     << ResultDouble(6, State::SUCCESS));
+    QCOMPARE(copy.timestamp(), static_cast<qint64>(10));
+}
+
+void TestSampleFrame::recycle()
+{
+    /* Warm up pool */
+    SampleFrame::create(10, 0);
+
+    const quint32 allocatedCount = SampleFrame::allocatedCount();
+
+    SampleFrame heldFrame = SampleFrame::create(10, 0);
+    for (qint32 idx = 0; idx < 100; idx++)
+    {
+        SampleFrame frame = SampleFrame::create(10, idx);
+        frame.setResult(0, ResultDouble(idx, State::SUCCESS));
+
+        SampleFrame copy = frame;
+        heldFrame = copy;
+    }
+
+    /* One frame in use, released frames are reused */
+    QVERIFY(SampleFrame::allocatedCount() <= allocatedCount + 1);
+    QCOMPARE(heldFrame.at(0), ResultDouble(99, State::SUCCESS));
+}
+
+QTEST_GUILESS_MAIN(TestSampleFrame)
@@ -0,0 +1,21 @@
+
+#include <QObject>
+
+class TestSampleFrame: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void create();
+    void fromResultList();
+    void shared();
+    void copyOnWrite();
+    void recycle();
+
+private:
+
+
+};